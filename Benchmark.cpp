@@ -0,0 +1,443 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sys/stat.h>
+#include <thread>
+
+// everything the benchmarks compute goes in here so the compiler can't throw the work away
+static volatile unsigned long long benchmarkSink = 0;
+
+BenchmarkConfig::BenchmarkConfig():
+    sizes{10, 1000, STOCK_MAX_ID}, warmup(BENCH_DEFAULT_WARMUP), reps(BENCH_DEFAULT_REPS), filter(""), dataDir("bench_data") {}
+
+Benchmark::Benchmark(const BenchmarkConfig& config): config(config), nullOut(nullptr) {}
+
+const std::vector<BenchmarkResult>& Benchmark::getResults() const
+{
+    return results;
+}
+
+//====SYNTHETIC FILES=====
+// a random word of lowercase letters
+static std::string randomWord(std::mt19937& rng, unsigned int minLen, unsigned int maxLen)
+{
+    std::uniform_int_distribution<unsigned int> pickLen(minLen, maxLen);
+    std::uniform_int_distribution<int> pickLetter('a', 'z');
+    unsigned int len = pickLen(rng);
+    std::string word = "";
+    for (unsigned int i = 0; i < len; ++i)
+    {
+        word += static_cast<char>(pickLetter(rng));
+    }
+    return word;
+}
+
+void Benchmark::writeStockFile(const std::string& fileName, unsigned int items, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned int> pickPrice(20, 199);
+    std::uniform_int_distribution<unsigned int> pickOnHand(0, 50);
+    std::uniform_int_distribution<unsigned int> pickWords(4, 25);
+
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+
+    for (unsigned int i = STOCK_MIN_ID; i <= items && i <= STOCK_MAX_ID; ++i)
+    {
+        std::string id = Stock::numberToId(i);
+
+        //names and descriptions in random order so the sorted inserts have real work to do
+        std::string name = randomWord(rng, 1, 1);
+        name[0] = std::toupper(name[0]);
+        name += randomWord(rng, 3, 12) + " " + randomWord(rng, 3, 12);
+
+        std::string desc = randomWord(rng, 2, 10);
+        unsigned int words = pickWords(rng);
+        for (unsigned int j = 0; j < words && desc.length() < DESCLEN - 12; ++j)
+        {
+            desc += " " + randomWord(rng, 2, 10);
+        }
+
+        Price price = Helper::valueToPrice(pickPrice(rng) * FIVE_CENTS_VAL);
+        file << id << STOCK_DELIM << name << STOCK_DELIM << desc << STOCK_DELIM << price.getString(false) << STOCK_DELIM << pickOnHand(rng) << std::endl;
+    }
+
+    file.close();
+}
+
+void Benchmark::writeCoinFile(const std::string& fileName, unsigned int count)
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+    for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+    {
+        file << Helper::denomToValue(static_cast<Denomination>(i)) << DELIM << count << std::endl;
+    }
+    file.close();
+}
+
+//====MEASURING=====
+bool Benchmark::selected(const std::string& name) const
+{
+    return config.filter.empty() || name.find(config.filter) != std::string::npos;
+}
+
+void Benchmark::measure(const std::string& name, unsigned int size, const std::function<void()>& body,
+    const std::function<void()>& setup)
+{
+    if (selected(name))
+    {
+        typedef std::chrono::steady_clock Clock;
+        bool batched = !setup;
+        unsigned int batch = 1;
+
+        for (unsigned int i = 0; i < config.warmup; ++i)
+        {
+            if (!batched) {
+                setup();
+            }
+            body();
+        }
+
+        //double the batch until a sample is long enough to time properly
+        bool calibrated = !batched;
+        while (!calibrated)
+        {
+            auto start = Clock::now();
+            for (unsigned int i = 0; i < batch; ++i) {
+                body();
+            }
+            double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            calibrated = elapsed >= BENCH_MIN_SAMPLE_NS || batch >= BENCH_MAX_BATCH;
+            if (!calibrated) {
+                batch *= 2;
+            }
+        }
+
+        std::vector<double> samples;
+        for (unsigned int r = 0; r < config.reps; ++r)
+        {
+            if (!batched) {
+                setup();
+            }
+            auto start = Clock::now();
+            for (unsigned int i = 0; i < batch; ++i) {
+                body();
+            }
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / batch);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.name = name;
+        result.size = size;
+        result.reps = samples.size();
+        result.batch = batch;
+        result.min = samples.front();
+        result.max = samples.back();
+        result.median = samples[(samples.size() - 1) / 2];
+        result.p90 = samples[static_cast<unsigned int>(std::ceil(0.9 * samples.size())) - 1];
+
+        double sum = 0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        result.mean = sum / samples.size();
+
+        double squares = 0;
+        for (double sample : samples) {
+            squares += (sample - result.mean) * (sample - result.mean);
+        }
+        result.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0;
+
+        results.push_back(result);
+    }
+}
+
+//====THE BENCHMARKS=====
+void Benchmark::runAll()
+{
+    if (config.reps == 0)
+    {
+        throw std::runtime_error("Need at least 1 repetition");
+    }
+
+    //it's fine if the directory already exists
+    mkdir(config.dataDir.c_str(), 0755);
+    writeCoinFile(config.dataDir + "/coins.dat", DEFAULT_COIN_COUNT);
+
+    runChange();
+    for (unsigned int size : config.sizes)
+    {
+        runSize(size);
+    }
+}
+
+void Benchmark::runChange()
+{
+    std::string coinFile = config.dataDir + "/coins.dat";
+    CoinInventory coinList = Helper::tryLoadCoinsFile(coinFile);
+
+    measure("tryLoadCoinsFile", 0, [&coinFile](){
+        benchmarkSink += Helper::tryLoadCoinsFile(coinFile).size();
+    });
+
+    unsigned int changes[] = {95, 995, 1995};
+    for (unsigned int change : changes)
+    {
+        measure("getBestCoinCombination " + std::to_string(change) + "c", 0, [&coinList, change](){
+            unsigned int coinsOut[NUM_DENOMS];
+            Helper::getBestCoinCombination(change, coinList, coinsOut);
+            benchmarkSink += coinsOut[FIVE_CENTS];
+        });
+    }
+}
+
+void Benchmark::runSize(unsigned int size)
+{
+    std::string stockFile = config.dataDir + "/stock_" + std::to_string(size) + ".dat";
+    std::string coinFile = config.dataDir + "/coins.dat";
+    std::string saveFile = config.dataDir + "/saved_" + std::to_string(size) + ".dat";
+    writeStockFile(stockFile, size, size);
+
+    VendingMachine machine;
+    machine.setOutput(nullOut);
+    machine.load(stockFile, coinFile);
+    unsigned int count = machine.stockList.size();
+
+    //====files and the menu=====
+    measure("tryLoadStockFile", count, [&stockFile](){
+        benchmarkSink += Helper::tryLoadStockFile(stockFile).size();
+    });
+
+    measure("VendingMachine::load", count, [&](){
+        machine.load(stockFile, coinFile);
+    });
+
+    measure("saveStockList", count, [&](){
+        Helper::saveStockList(saveFile, machine.stockList);
+    });
+
+    measure("displayStock", count, [&machine](){
+        machine.displayStock();
+    });
+
+    runCatalogReads(stockFile, coinFile, count);
+
+    //a full catalog has no ids left, make room for one
+    if (machine.stockList.size() >= STOCK_MAX_ID - STOCK_MIN_ID + 1)
+    {
+        machine.stockList.removeBack();
+    }
+    count = machine.stockList.size();
+
+    measure("generateNextId", count, [&machine](){
+        benchmarkSink += machine.generateNextId().length();
+    });
+
+    //add a random item each time (what addUserItem does after the prompts), taking the last one out first
+    std::mt19937 rng(size);
+    std::string addedId = "";
+    ScriptInput script;
+    std::string price = Helper::valueToPrice(250).getString(false);
+    measure("addUserItem", count, [&](){
+        AddItemSession session(machine, nullOut);
+        session.run(script);
+        addedId = session.getItemId();
+    }, [&](){
+        if (!addedId.empty()) {
+            machine.stockList.removeAt(machine.findItemIndex(addedId));
+        }
+        script = ScriptInput(std::vector<std::string>{"Bench " + randomWord(rng, 3, 12), "A benchmark item", price});
+    });
+
+    //====the linked list on its own=====
+    LinkedList list;
+    machine.stockList.forEach([&list](const Stock& stock){
+        list.append(stock);
+    });
+    Stock extra("I0000", "Extra", "An extra item", Price(1, 0), DEFAULT_STOCK_LEVEL);
+    unsigned int middle = list.size() / 2;
+    unsigned int lastNumber = list.empty() ? 0 : list.at(list.size() - 1).getNumber();
+    bool inserted = false;
+
+    measure("LinkedList::at middle", count, [&list, middle](){
+        benchmarkSink += list.at(middle).getOnHand();
+    });
+
+    measure("LinkedList::findFirst last", count, [&list, lastNumber](){
+        benchmarkSink += list.findFirst([lastNumber](const Stock& s){
+            return s.getNumber() == lastNumber;
+        });
+    });
+
+    measure("LinkedList::forEach", count, [&list](){
+        unsigned long long total = 0;
+        list.forEach([&total](const Stock& s){
+            total += s.getOnHand();
+        });
+        benchmarkSink += total;
+    });
+
+    measure("LinkedList::append", count, [&](){
+        list.append(extra);
+        inserted = true;
+    }, [&](){
+        if (inserted) {
+            list.removeBack();
+        }
+    });
+    inserted = false;
+
+    measure("LinkedList::prepend", count, [&](){
+        list.prepend(extra);
+        inserted = true;
+    }, [&](){
+        if (inserted) {
+            list.removeFront();
+        }
+    });
+    inserted = false;
+
+    measure("LinkedList::insertBefore middle", count, [&](){
+        list.insertBefore(middle, extra);
+        inserted = true;
+    }, [&](){
+        if (inserted) {
+            list.removeAt(middle);
+        }
+    });
+    inserted = false;
+
+    if (!list.empty())
+    {
+        measure("LinkedList::removeAt middle", count, [&](){
+            benchmarkSink += list.removeAt(middle).getOnHand();
+            inserted = false;
+        }, [&](){
+            if (!inserted) {
+                list.insertBefore(middle, extra);
+                inserted = true;
+            }
+        });
+    }
+}
+
+void Benchmark::runCatalogReads(const std::string& stockFile, const std::string& coinFile, unsigned int size)
+{
+    //a machine of its own so the other benchmarks don't pay for publishing, it goes before the catalog does
+    CatalogRcu catalog;
+    VendingMachine machine;
+    machine.setOutput(nullOut);
+    machine.load(stockFile, coinFile);
+    machine.setCatalogRcu(catalog);
+
+    std::vector<std::string> ids;
+    machine.stockList.forEach([&ids](const Stock& stock){
+        ids.push_back(stock.getId());
+    });
+
+    if (!ids.empty())
+    {
+        //the machine publishes a new version (a stock reset) every millisecond while the readers look items up
+        std::atomic<bool> writing(true);
+        std::thread writer([&machine, &writing](){
+            while (writing.load())
+            {
+                machine.resetStock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+        //with the same time for more threads, the reads scale with the threads
+        unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            std::string name = "CatalogRcu " + std::to_string(BENCH_RCU_LOOKUPS) + " lookups x" + std::to_string(threads);
+            measure(name, size, [&catalog, &ids, threads](){
+                std::vector<unsigned long long> totals(threads, 0);
+                std::vector<std::thread> readers;
+                for (unsigned int t = 0; t < threads; ++t)
+                {
+                    readers.push_back(std::thread([&catalog, &ids, &totals, t](){
+                        unsigned int reader = catalog.registerReader();
+                        for (unsigned int i = 0; i < BENCH_RCU_LOOKUPS; ++i)
+                        {
+                            const Stock* stock = catalog.read().find(ids[(i * 7 + t) % ids.size()]);
+                            totals[t] += stock != nullptr ? catalog.getOnHand(stock->getNumber()) : 0;
+                            catalog.quiescent(reader);
+                        }
+                        catalog.unregisterReader(reader);
+                    }));
+                }
+                for (unsigned int t = 0; t < threads; ++t)
+                {
+                    readers[t].join();
+                    benchmarkSink += totals[t];
+                }
+            });
+        }
+
+        writing.store(false);
+        writer.join();
+    }
+}
+
+//====OUTPUT=====
+void Benchmark::report(std::ostream& os) const
+{
+    int nameWidth = 34;
+    int sizeWidth = 6;
+    int batchWidth = 8;
+    int numWidth = 12;
+    char horizontalSep = '-';
+    char verticalSep = '|';
+    double micro = 1000;
+    std::string title = "Benchmark Summary";
+
+    os << title << std::endl;
+    os << std::string(title.length(), horizontalSep) << std::endl;
+    os << std::left << std::setw(nameWidth) << "Benchmark" << verticalSep << std::right << std::setw(sizeWidth) << "Size"
+       << verticalSep << std::setw(batchWidth) << "Batch" << verticalSep << std::setw(numWidth) << "Min us"
+       << verticalSep << std::setw(numWidth) << "Median us" << verticalSep << std::setw(numWidth) << "Mean us"
+       << verticalSep << std::setw(numWidth) << "Stddev us" << verticalSep << std::setw(numWidth) << "p90 us" << std::endl;
+    os << std::string(nameWidth + sizeWidth + batchWidth + 5 * numWidth + 7, horizontalSep) << std::endl;
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    for (const BenchmarkResult& result : results)
+    {
+        os << std::left << std::setw(nameWidth) << result.name << verticalSep << std::right << std::setw(sizeWidth) << result.size
+           << verticalSep << std::setw(batchWidth) << result.batch << verticalSep << std::setw(numWidth) << result.min / micro
+           << verticalSep << std::setw(numWidth) << result.median / micro << verticalSep << std::setw(numWidth) << result.mean / micro
+           << verticalSep << std::setw(numWidth) << result.stddev / micro << verticalSep << std::setw(numWidth) << result.p90 / micro << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os << std::endl;
+}
+
+void Benchmark::writeCsv(const std::string& fileName) const
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not write the results file " + fileName);
+    }
+
+    file << "benchmark,size,reps,batch,min_ns,median_ns,mean_ns,stddev_ns,p90_ns,max_ns" << std::endl;
+    file << std::fixed << std::setprecision(1);
+    for (const BenchmarkResult& result : results)
+    {
+        file << result.name << DELIM << result.size << DELIM << result.reps << DELIM << result.batch << DELIM
+             << result.min << DELIM << result.median << DELIM << result.mean << DELIM << result.stddev << DELIM
+             << result.p90 << DELIM << result.max << std::endl;
+    }
+    file.close();
+}
@@ -0,0 +1,153 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "VendingMachine.h"
+
+// the default number of untimed runs before measuring and the number of timed samples
+#define BENCH_DEFAULT_WARMUP 3
+#define BENCH_DEFAULT_REPS 20
+
+// fast operations are repeated until one sample takes at least this long, so the clock's resolution doesn't matter
+#define BENCH_MIN_SAMPLE_NS 100000
+#define BENCH_MAX_BATCH 1000000
+
+// the lookups each reader thread does in one sample of the published catalog benchmark
+#define BENCH_RCU_LOOKUPS 100000
+
+/**
+ * settings for a benchmark run
+ **/
+struct BenchmarkConfig
+{
+    // the catalog sizes every operation is measured at
+    std::vector<unsigned int> sizes;
+
+    unsigned int warmup;
+    unsigned int reps;
+
+    // only run the benchmarks whose name contains this
+    std::string filter;
+
+    // the directory the synthetic stock files and coin file are written to
+    std::string dataDir;
+
+    BenchmarkConfig();
+};
+
+/**
+ * the summary of one benchmark, all times are nanoseconds per operation
+ **/
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned int size;
+    unsigned int reps;
+
+    // how many operations each sample timed
+    unsigned int batch;
+
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double p90;
+    double max;
+};
+
+/**
+ * times every VendingMachine, Helper and LinkedList operation at different catalog sizes
+ * against synthetic data files, and writes the results as a table or a CSV file
+ * that can be compared between commits
+ **/
+class Benchmark
+{
+public:
+    Benchmark(const BenchmarkConfig& config);
+
+    /**
+     * @brief Write the synthetic files and run every benchmark
+    */
+    void runAll();
+
+    /**
+     * @brief Get the results so far
+     * @return The results in the order they ran
+    */
+    const std::vector<BenchmarkResult>& getResults() const;
+
+    /**
+     * @brief Print the results in a table
+     * @param os Where to print them
+    */
+    void report(std::ostream& os) const;
+
+    /**
+     * @brief Write the results as CSV, one line per benchmark
+     * @param fileName The file to write
+    */
+    void writeCsv(const std::string& fileName) const;
+
+    /**
+     * @brief Write a stock file with synthetic items
+     * @param fileName The file to write
+     * @param items How many items, at most STOCK_MAX_ID
+     * @param seed The seed for the names, descriptions and prices
+    */
+    static void writeStockFile(const std::string& fileName, unsigned int items, unsigned int seed);
+
+    /**
+     * @brief Write a coin file with every denomination
+     * @param fileName The file to write
+     * @param count The count of every denomination
+    */
+    static void writeCoinFile(const std::string& fileName, unsigned int count);
+
+private:
+    BenchmarkConfig config;
+    std::vector<BenchmarkResult> results;
+    std::ostream nullOut;
+
+    /**
+     * @brief Measure an operation and store its result
+     * @param name The benchmark name
+     * @param size The catalog size
+     * @param body The operation
+     * @param setup Run untimed before every call when the operation changes what it works on,
+     * otherwise (nullptr) the operation gets repeated in batches
+    */
+    void measure(const std::string& name, unsigned int size, const std::function<void()>& body,
+        const std::function<void()>& setup = nullptr);
+
+    /**
+     * @brief Get whether a benchmark is picked by the filter
+     * @param name The benchmark name
+     * @return Whether it runs
+    */
+    bool selected(const std::string& name) const;
+
+    /**
+     * @brief Run the benchmarks of one catalog size
+     * @param size The catalog size
+    */
+    void runSize(unsigned int size);
+
+    /**
+     * @brief Run the benchmarks that don't depend on the catalog size
+    */
+    void runChange();
+
+    /**
+     * @brief Time threads looking items up in a published catalog while a machine keeps publishing
+     * new versions, with 1, 2, 4... reader threads up to the number of cpus
+     * @param stockFile The stock file of this catalog size
+     * @param coinFile The coin file
+     * @param size The catalog size
+    */
+    void runCatalogReads(const std::string& stockFile, const std::string& coinFile, unsigned int size);
+};
+
+#endif // BENCHMARK_H
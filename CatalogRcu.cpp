@@ -0,0 +1,199 @@
+#include "CatalogRcu.h"
+#include <stdexcept>
+#include <thread>
+
+//====CATALOG VIEW=====
+CatalogView::CatalogView(): rowOf(STOCK_MAX_ID + 1, -1), version(0) {}
+
+const Stock* CatalogView::find(const std::string& itemId) const
+{
+    const Stock* result = nullptr;
+    int row = rowOf[Stock::idToNumber(itemId)];
+    if (row >= 0)
+    {
+        result = &items[row];
+    }
+    return result;
+}
+
+//====CATALOG RCU=====
+CatalogRcu::CatalogRcu(): current(new CatalogView()), epoch(1)
+{
+    for (ReaderSlot& slot : readers)
+    {
+        slot.seen.store(RCU_OFFLINE);
+        slot.used.store(false);
+    }
+    for (std::atomic<unsigned int>& count : onHand)
+    {
+        count.store(0);
+    }
+}
+
+CatalogRcu::~CatalogRcu()
+{
+    for (const std::pair<const CatalogView*, unsigned long>& old : retired)
+    {
+        delete old.first;
+    }
+    delete current.load();
+}
+
+unsigned int CatalogRcu::registerReader()
+{
+    unsigned int reader = RCU_MAX_READERS;
+    for (unsigned int i = 0; i < RCU_MAX_READERS && reader == RCU_MAX_READERS; ++i)
+    {
+        bool expected = false;
+        if (readers[i].used.compare_exchange_strong(expected, true))
+        {
+            reader = i;
+        }
+    }
+
+    if (reader == RCU_MAX_READERS)
+    {
+        throw std::runtime_error("There are already " + std::to_string(RCU_MAX_READERS) + " catalog readers");
+    }
+
+    //the writer has to see the slot is in use before the reader's first read, or it could free what that read gets
+    quiescent(reader);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return reader;
+}
+
+void CatalogRcu::unregisterReader(unsigned int reader)
+{
+    readers[reader].seen.store(RCU_OFFLINE, std::memory_order_release);
+    readers[reader].used.store(false, std::memory_order_release);
+}
+
+const CatalogView& CatalogRcu::read() const
+{
+    //an acquire load is a plain load on x86, the version is never written after it's published
+    return *current.load(std::memory_order_acquire);
+}
+
+void CatalogRcu::quiescent(unsigned int reader)
+{
+    //once the reader has seen an epoch it can't be holding a version swapped out before it
+    readers[reader].seen.store(epoch.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+CatalogView* CatalogRcu::copyCurrent() const
+{
+    CatalogView* view = new CatalogView(read());
+    view->version++;
+    return view;
+}
+
+void CatalogRcu::indexRows(CatalogView& view)
+{
+    std::fill(view.rowOf.begin(), view.rowOf.end(), -1);
+    for (unsigned int row = 0; row < view.items.size(); ++row)
+    {
+        view.rowOf[view.items[row].getNumber()] = row;
+    }
+}
+
+void CatalogRcu::rebuild(const LinkedList& stockList)
+{
+    CatalogView* view = new CatalogView();
+    view->version = read().version + 1;
+    view->items.reserve(stockList.size());
+    stockList.forEach([this, view](const Stock& stock){
+        view->items.push_back(stock);
+        setOnHand(stock.getNumber(), stock.getOnHand());
+    });
+    indexRows(*view);
+    publish(view);
+}
+
+void CatalogRcu::insert(unsigned int position, const Stock& stock)
+{
+    CatalogView* view = copyCurrent();
+    view->items.insert(view->items.begin() + position, stock);
+    indexRows(*view);
+    //the count goes first, a reader that finds the item in the new version never sees an old one
+    setOnHand(stock.getNumber(), stock.getOnHand());
+    publish(view);
+}
+
+void CatalogRcu::setOnHand(unsigned int number, unsigned int onHand)
+{
+    //every count stands on its own, nothing else is read through it so relaxed is enough
+    this->onHand[number].store(onHand, std::memory_order_relaxed);
+}
+
+unsigned int CatalogRcu::getOnHand(unsigned int number) const
+{
+    return onHand[number].load(std::memory_order_relaxed);
+}
+
+void CatalogRcu::remove(const std::string& itemId)
+{
+    int row = read().rowOf[Stock::idToNumber(itemId)];
+    if (row >= 0)
+    {
+        CatalogView* view = copyCurrent();
+        view->items.erase(view->items.begin() + row);
+        indexRows(*view);
+        publish(view);
+    }
+}
+
+void CatalogRcu::clear()
+{
+    CatalogView* view = new CatalogView();
+    view->version = read().version + 1;
+    publish(view);
+}
+
+void CatalogRcu::publish(CatalogView* view)
+{
+    //readers see the new version from their next read, the old one waits until they've all moved past this epoch
+    const CatalogView* old = current.load(std::memory_order_relaxed);
+    current.store(view, std::memory_order_release);
+    unsigned long retiredAt = epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    retired.push_back(std::make_pair(old, retiredAt));
+    reclaim();
+}
+
+void CatalogRcu::reclaim()
+{
+    //the oldest epoch a registered reader has seen, the fence pairs with the one in registerReader
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    unsigned long oldestSeen = epoch.load(std::memory_order_acquire);
+    for (const ReaderSlot& slot : readers)
+    {
+        unsigned long seen = slot.seen.load(std::memory_order_acquire);
+        if (seen != RCU_OFFLINE && seen < oldestSeen)
+        {
+            oldestSeen = seen;
+        }
+    }
+
+    //the versions are retired in epoch order, so the ones that can go are at the front
+    unsigned int freed = 0;
+    while (freed < retired.size() && retired[freed].second <= oldestSeen)
+    {
+        delete retired[freed].first;
+        freed++;
+    }
+    retired.erase(retired.begin(), retired.begin() + freed);
+}
+
+void CatalogRcu::synchronize()
+{
+    reclaim();
+    while (!retired.empty())
+    {
+        std::this_thread::yield();
+        reclaim();
+    }
+}
+
+unsigned int CatalogRcu::getRetired() const
+{
+    return retired.size();
+}
@@ -0,0 +1,189 @@
+#ifndef CATALOG_RCU_H
+#define CATALOG_RCU_H
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Node.h"
+#include "LinkedList.h"
+
+// the most threads that can read the catalog at once
+#define RCU_MAX_READERS 64
+
+// the size of a cache line, each reader's slot gets its own so readers don't slow each other down
+#define RCU_CACHE_LINE 64
+
+// what a reader's slot holds while nobody is using it
+#define RCU_OFFLINE 0
+
+/**
+ * one version of the catalog, it never changes once it's published. The stock on hand of its
+ * items is only what it was when the version was made, CatalogRcu::getOnHand has the current one
+ **/
+struct CatalogView
+{
+    // the items in the same order as the stock list
+    std::vector<Stock> items;
+
+    // the index in items of each item number, -1 if it's not there
+    std::vector<int> rowOf;
+
+    // counts up by one with every version
+    unsigned long version;
+
+    CatalogView();
+
+    /**
+     * @brief Find an item by its id. Other threads shouldn't call getShortDescription on it,
+     * that fills the short description in the first time
+     * @param itemId The id, e.g. I0001
+     * @return The item, nullptr if it's not in this version
+    */
+    const Stock* find(const std::string& itemId) const;
+};
+
+/**
+ * the catalog published for threads that only read it (read-copy-update).
+ * a reader loads the current version with one plain load and can go through it for as long as it
+ * likes without locks, the writer never changes a version: it copies the current one, changes the
+ * copy and swaps it in. the old version is freed once every reader has said it's finished with
+ * the versions it had (quiescent), so readers only pay for that between their operations, not while reading.
+ * the stock on hand changes with every sale, so it isn't copied into a new version: each item
+ * number has its own atomic count next to the versions instead.
+ * only one thread may write
+ **/
+class CatalogRcu
+{
+public:
+    CatalogRcu();
+
+    // frees every version, no reader can still be registered
+    ~CatalogRcu();
+
+    CatalogRcu(const CatalogRcu&) = delete;
+    CatalogRcu& operator=(const CatalogRcu&) = delete;
+
+    /**
+     * @brief Get a slot for a reading thread, it has to call quiescent every so often
+     * @return The reader's slot
+     * @throws std::runtime_error if there are already RCU_MAX_READERS readers
+    */
+    unsigned int registerReader();
+
+    /**
+     * @brief Give a reader's slot back, the reader can't keep any version it had
+     * @param reader The reader's slot
+    */
+    void unregisterReader(unsigned int reader);
+
+    /**
+     * @brief Get the current version, it stays valid until the reader's next quiescent call.
+     * The writer can read without registering, the versions it sees are never freed under it
+     * @return The version
+    */
+    const CatalogView& read() const;
+
+    /**
+     * @brief Say that a reader doesn't have any version anymore, e.g. between two lookups
+     * @param reader The reader's slot
+    */
+    void quiescent(unsigned int reader);
+
+    /**
+     * @brief Publish a version with every item in the stock list
+     * @param stockList The stock list
+    */
+    void rebuild(const LinkedList& stockList);
+
+    /**
+     * @brief Publish a version with an item added
+     * @param position Where it is in the stock list
+     * @param stock The item
+    */
+    void insert(unsigned int position, const Stock& stock);
+
+    /**
+     * @brief Set an item's stock on hand, readers see it straight away without a new version
+     * @param number The number part of the item's id
+     * @param onHand The stock on hand
+    */
+    void setOnHand(unsigned int number, unsigned int onHand);
+
+    /**
+     * @brief Get an item's current stock on hand, any thread can call it without registering
+     * @param number The number part of the item's id
+     * @return The stock on hand, 0 if the item was never published
+    */
+    unsigned int getOnHand(unsigned int number) const;
+
+    /**
+     * @brief Publish a version with an item removed
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Publish an empty version
+    */
+    void clear();
+
+    /**
+     * @brief Free the old versions no reader can still have, it never waits for a reader
+    */
+    void reclaim();
+
+    /**
+     * @brief Wait until every old version is freed, for when what they point at is about to go too
+     * (e.g. the names in the string arena). Readers have to be calling quiescent or unregister for this to finish
+    */
+    void synchronize();
+
+    /**
+     * @brief Get the number of old versions not freed yet
+     * @return Number of versions
+    */
+    unsigned int getRetired() const;
+
+private:
+    // a reader's slot on its own cache line
+    struct ReaderSlot
+    {
+        // the epoch the reader saw at its last quiescent, RCU_OFFLINE when the slot is free
+        std::atomic<unsigned long> seen;
+        std::atomic<bool> used;
+        char padding[RCU_CACHE_LINE - sizeof(std::atomic<unsigned long>) - sizeof(std::atomic<bool>)];
+    };
+
+    ReaderSlot readers[RCU_MAX_READERS];
+    std::atomic<const CatalogView*> current;
+
+    // goes up every time a version is swapped out
+    std::atomic<unsigned long> epoch;
+
+    // the versions swapped out and the epoch every reader has to get to before they can be freed
+    std::vector<std::pair<const CatalogView*, unsigned long>> retired;
+
+    // the current stock on hand of every item number, outside the versions
+    std::atomic<unsigned int> onHand[STOCK_MAX_ID + 1];
+
+    /**
+     * @brief Start a version from the current one
+     * @return The copy
+    */
+    CatalogView* copyCurrent() const;
+
+    /**
+     * @brief Swap in a version and free the old ones that can be
+     * @param view The new version
+    */
+    void publish(CatalogView* view);
+
+    /**
+     * @brief Work out the rows of every item in a version
+     * @param view The version
+    */
+    static void indexRows(CatalogView& view);
+};
+
+#endif // CATALOG_RCU_H
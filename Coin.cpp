@@ -1,12 +1,8 @@
 #include "Coin.h"
  
-// all the denomination enum values
-const std::unordered_set<Denomination> Coin::allDenom = {
-    FIVE_CENTS, TEN_CENTS, TWENTY_CENTS, FIFTY_CENTS, ONE_DOLLAR,
-    TWO_DOLLARS, FIVE_DOLLARS, TEN_DOLLARS
-};
-
 // implement functions for managing coins; this may depend on your design.
+Coin::Coin(): denom(FIVE_CENTS), count(0) {};
+
 Coin::Coin(Denomination denom, unsigned int count): denom(denom), count(count) {};
 
 void Coin::addCoinCount(unsigned int amount)
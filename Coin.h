@@ -1,13 +1,15 @@
 #ifndef COIN_H
 #define COIN_H
 
+#include <array>
 #include <stdexcept>
-#include <unordered_set>
 
 // Coin.h defines the coin structure for managing currency in the system. 
 #define DELIM ","  // delimiter 
 
 // enumeration representing the various types of currency available in the system. 
+// they are named after the AUD ones, in other denomination sets (see DenominationSet) they are
+// just the position from the lowest value to the highest
 enum Denomination
 {
     FIVE_CENTS, TEN_CENTS, TWENTY_CENTS, FIFTY_CENTS, ONE_DOLLAR, 
@@ -17,7 +19,7 @@ enum Denomination
 // the number of attributes when loading the coin file
 #define COIN_ATTRIB 2
 
-//each of the denomination values
+//each of the AUD denomination values, the dollar and ten cents ones are also used for splitting prices
 #define FIVE_CENTS_VAL 5
 #define TEN_CENTS_VAL 10
 #define TWENTY_CENTS_VAL 20
@@ -27,21 +29,27 @@ enum Denomination
 #define FIVE_DOLLARS_VAL 500
 #define TEN_DOLLARS_VAL 1000
 
+//The number of denominations of currency available in the system 
+#define NUM_DENOMS 8
+
+//a bit for each denomination (1 << denom), this is all of them
+#define ALL_DENOMS_MASK ((1u << NUM_DENOMS) - 1)
+
+static_assert(NUM_DENOMS <= 32, "ALL_DENOMS_MASK needs a bit for each denomination");
+
 // represents a coin type stored in the cash register perhaps. Each demonination
 // will have exactly one of these in the cash register.
 class Coin
 {
 public:
-    // static variable to hold all the Denomation enum values
-    const static std::unordered_set<Denomination> allDenom;
-
     // the denomination type
     enum Denomination denom;
     
     // the count of how many of these are in the cash register
     unsigned count;
 
-    // constructor
+    // constructors, the default one is an empty slot in a CoinInventory until it's loaded
+    Coin();
     Coin(Denomination denom, unsigned int count);
 
     // getters and setters
@@ -54,4 +62,7 @@ public:
 
 };
 
+// the cash register, one Coin for each denomination indexed by Denomination (so lowest value first)
+typedef std::array<Coin, NUM_DENOMS> CoinInventory;
+
 #endif // COIN_H
@@ -0,0 +1,290 @@
+#include "CoinOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// how many purchase sequences one task of the thread pool runs
+#define OPTIMIZER_TRIALS_PER_TASK 50
+
+//====CONFIG AND RESULT=====
+OptimizerConfig::OptimizerConfig():
+    trials(OPTIMIZER_DEFAULT_TRIALS), customers(OPTIMIZER_DEFAULT_CUSTOMERS), target(OPTIMIZER_DEFAULT_TARGET),
+    zipfExponent(1.0), coinWeights{5, 10, 10, 10, 20, 20, 15, 10}, threads(0), seed(1) {}
+
+FloatResult::FloatResult(): counts{0}, purchases(0), changeFailures(0) {}
+
+double FloatResult::getFailureRate() const
+{
+    return purchases > 0 ? static_cast<double>(changeFailures) / purchases : 0;
+}
+
+unsigned int FloatResult::getValue() const
+{
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+    {
+        value += counts[i] * Helper::denomToValue(static_cast<Denomination>(i));
+    }
+    return value;
+}
+
+//====COIN OPTIMIZER=====
+CoinOptimizer::CoinOptimizer(const OptimizerConfig& config):
+    config(config), pool(config.threads), evaluations(0)
+{
+    pickDenom = std::discrete_distribution<unsigned int>(config.coinWeights, config.coinWeights + NUM_DENOMS);
+}
+
+void CoinOptimizer::load(const std::string& stockFile)
+{
+    //the first item in the file is the most popular, then the second...
+    std::vector<Stock> stockVector = Helper::tryLoadStockFile(stockFile);
+    std::vector<double> weights;
+    prices.clear();
+    for (unsigned int i = 0; i < stockVector.size(); ++i)
+    {
+        prices.push_back(stockVector[i].getPrice().getValue());
+        weights.push_back(1.0 / std::pow(i + 1, config.zipfExponent));
+    }
+
+    if (prices.empty())
+    {
+        throw std::runtime_error("Stock file has no items for the customers to buy");
+    }
+
+    pickPrice = std::discrete_distribution<unsigned int>(weights.begin(), weights.end());
+}
+
+// branch and bound for makeChange, denominations are tried from index down to 0
+static void searchChange(unsigned int remaining, const unsigned int counts[NUM_DENOMS], int index, unsigned int used,
+    unsigned int state[NUM_DENOMS], unsigned int best[NUM_DENOMS], unsigned int& bestUsed)
+{
+    if (remaining == 0)
+    {
+        if (used < bestUsed)
+        {
+            std::copy(state, state + NUM_DENOMS, best);
+            bestUsed = used;
+        }
+    }
+    else if (index >= 0)
+    {
+        unsigned int denomValue = Helper::denomToValue(static_cast<Denomination>(index));
+
+        //even paying the rest in this denomination wouldn't beat the best, so nothing below it will
+        unsigned int atLeast = (remaining + denomValue - 1) / denomValue;
+        if (used + atLeast < bestUsed)
+        {
+            //the most of the biggest coins first, that's usually the answer so the bound kicks in early
+            unsigned int maxFit = std::min(remaining / denomValue, counts[index]);
+            for (int i = maxFit; i >= 0; --i)
+            {
+                state[index] = i;
+                searchChange(remaining - i * denomValue, counts, index - 1, used + i, state, best, bestUsed);
+            }
+            state[index] = 0;
+        }
+    }
+}
+
+bool CoinOptimizer::makeChange(unsigned int change, const unsigned int counts[NUM_DENOMS], unsigned int coinsOut[NUM_DENOMS])
+{
+    unsigned int state[NUM_DENOMS] = {0};
+    unsigned int bestUsed = static_cast<unsigned int>(-1);
+
+    std::fill(coinsOut, coinsOut + NUM_DENOMS, 0);
+    searchChange(change, counts, NUM_DENOMS - 1, 0, state, coinsOut, bestUsed);
+
+    return bestUsed != static_cast<unsigned int>(-1);
+}
+
+void CoinOptimizer::runTrial(unsigned int counts[NUM_DENOMS], unsigned int trial, FloatResult& result) const
+{
+    //the same trial always gets the same customers whatever float it runs against
+    std::mt19937 rng(config.seed + trial);
+    std::discrete_distribution<unsigned int> price(pickPrice);
+    std::discrete_distribution<unsigned int> denom(pickDenom);
+    unsigned int coinsOut[NUM_DENOMS];
+
+    for (unsigned int customer = 0; customer < config.customers; ++customer)
+    {
+        //keep handing over random notes/coins until it's paid for
+        unsigned int itemPrice = prices[price(rng)];
+        unsigned int coinsPutIn[NUM_DENOMS] = {0};
+        unsigned int paid = 0;
+        while (paid < itemPrice)
+        {
+            unsigned int index = denom(rng);
+            ++coinsPutIn[index];
+            paid += Helper::denomToValue(static_cast<Denomination>(index));
+        }
+
+        //like VendingMachine::takePayment the coins go in first so they can be given back as change
+        for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+        {
+            counts[i] += coinsPutIn[i];
+        }
+
+        ++result.purchases;
+        if (makeChange(paid - itemPrice, counts, coinsOut))
+        {
+            for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+            {
+                counts[i] -= coinsOut[i];
+            }
+        }
+        else
+        {
+            //the customer gets their own coins back and nothing is bought
+            for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+            {
+                counts[i] -= coinsPutIn[i];
+            }
+            ++result.changeFailures;
+        }
+    }
+}
+
+void CoinOptimizer::evaluateAll(std::vector<FloatResult>& floats)
+{
+    //every float gets split into tasks of a few trials, each task adds up into its own result
+    unsigned int tasksPerFloat = (config.trials + OPTIMIZER_TRIALS_PER_TASK - 1) / OPTIMIZER_TRIALS_PER_TASK;
+    std::vector<FloatResult> partial(floats.size() * tasksPerFloat);
+
+    for (unsigned int f = 0; f < floats.size(); ++f)
+    {
+        for (unsigned int task = 0; task < tasksPerFloat; ++task)
+        {
+            const FloatResult* start = &floats[f];
+            FloatResult* out = &partial[f * tasksPerFloat + task];
+            pool.submit([this, start, out, task](){
+                unsigned int last = std::min(config.trials, (task + 1) * OPTIMIZER_TRIALS_PER_TASK);
+                for (unsigned int trial = task * OPTIMIZER_TRIALS_PER_TASK; trial < last; ++trial)
+                {
+                    unsigned int counts[NUM_DENOMS];
+                    std::copy(start->counts, start->counts + NUM_DENOMS, counts);
+                    runTrial(counts, trial, *out);
+                }
+            });
+        }
+    }
+    pool.wait();
+
+    for (unsigned int f = 0; f < floats.size(); ++f)
+    {
+        floats[f].purchases = 0;
+        floats[f].changeFailures = 0;
+        for (unsigned int task = 0; task < tasksPerFloat; ++task)
+        {
+            floats[f].purchases += partial[f * tasksPerFloat + task].purchases;
+            floats[f].changeFailures += partial[f * tasksPerFloat + task].changeFailures;
+        }
+    }
+    evaluations += floats.size();
+}
+
+FloatResult CoinOptimizer::evaluate(const unsigned int counts[NUM_DENOMS])
+{
+    std::vector<FloatResult> floats(1);
+    std::copy(counts, counts + NUM_DENOMS, floats[0].counts);
+    evaluateAll(floats);
+    return floats[0];
+}
+
+FloatResult CoinOptimizer::optimize()
+{
+    //start from what resetCoin gives, and grow it until it's good enough
+    std::vector<FloatResult> floats(1);
+    std::fill(floats[0].counts, floats[0].counts + NUM_DENOMS, DEFAULT_COIN_COUNT);
+    evaluateAll(floats);
+    unsigned int doublings = 0;
+    while (floats[0].getFailureRate() > config.target && doublings < OPTIMIZER_MAX_DOUBLINGS)
+    {
+        for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+        {
+            floats[0].counts[i] *= 2;
+        }
+        evaluateAll(floats);
+        ++doublings;
+    }
+    if (floats[0].getFailureRate() > config.target)
+    {
+        throw std::runtime_error("Could not find a float with a change failure rate under the target");
+    }
+
+    //take coins out of one denomination at a time, the step halves when nothing can be taken out
+    FloatResult best = floats[0];
+    unsigned int step = *std::max_element(best.counts, best.counts + NUM_DENOMS) / 2;
+    while (step > 0)
+    {
+        std::vector<FloatResult> candidates;
+        for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+        {
+            if (best.counts[i] > 0)
+            {
+                FloatResult candidate = best;
+                candidate.counts[i] -= std::min(step, best.counts[i]);
+                candidates.push_back(candidate);
+            }
+        }
+        evaluateAll(candidates);
+
+        //the one that saves the most money while meeting the target, the lower failure rate on a tie
+        bool found = false;
+        for (const FloatResult& candidate : candidates)
+        {
+            if (candidate.getFailureRate() <= config.target && (!found || candidate.getValue() < best.getValue() ||
+                (candidate.getValue() == best.getValue() && candidate.getFailureRate() < best.getFailureRate())))
+            {
+                best = candidate;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            step /= 2;
+        }
+    }
+
+    return best;
+}
+
+unsigned long CoinOptimizer::getEvaluations() const
+{
+    return evaluations;
+}
+
+CoinInventory CoinOptimizer::toCoinList(const unsigned int counts[NUM_DENOMS])
+{
+    CoinInventory coinList;
+    for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+    {
+        coinList[i] = Coin(static_cast<Denomination>(i), counts[i]);
+    }
+    return coinList;
+}
+
+void CoinOptimizer::print(std::ostream& os, const std::string& title, const FloatResult& result)
+{
+    int denomWidth = 16;
+    int countWidth = 6;
+    char verticalSep = '|';
+
+    os << title << std::endl;
+    os << std::string(title.length(), '-') << std::endl;
+    for (int i = NUM_DENOMS - 1; i >= 0; --i)
+    {
+        os << std::left << std::setw(denomWidth) << Helper::denomToString(static_cast<Denomination>(i)) << verticalSep
+           << std::right << std::setw(countWidth) << result.counts[i] << std::endl;
+    }
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << "Total value: " << Helper::valueToPrice(result.getValue()).getString() << std::endl;
+    os << "Change failure rate: " << std::fixed << std::setprecision(3) << result.getFailureRate() * 100 << "% of "
+       << result.purchases << " purchases" << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+    os << std::endl;
+}
@@ -0,0 +1,158 @@
+#ifndef COIN_OPTIMIZER_H
+#define COIN_OPTIMIZER_H
+
+#include <random>
+#include <string>
+#include <vector>
+#include "Helper.h"
+#include "ThreadPool.h"
+
+// the default number of simulated purchase sequences per float we try
+#define OPTIMIZER_DEFAULT_TRIALS 500
+
+// the default number of customers in a sequence, i.e. between two service visits
+#define OPTIMIZER_DEFAULT_CUSTOMERS 500
+
+// the default fraction of purchases we allow to fail because there is no change
+#define OPTIMIZER_DEFAULT_TARGET 0.01
+
+// the search gives up growing the starting float after this many doublings
+#define OPTIMIZER_MAX_DOUBLINGS 10
+
+/**
+ * settings for the coin float optimizer
+ **/
+struct OptimizerConfig
+{
+    unsigned int trials;
+    unsigned int customers;
+
+    // the highest change failure rate the recommended float may have
+    double target;
+
+    // exponent of the Zipf distribution for item popularity, 0 means every item is as popular
+    double zipfExponent;
+
+    // relative chance of a customer handing over each denomination (indexed by Denomination)
+    double coinWeights[NUM_DENOMS];
+
+    unsigned int threads;
+    unsigned int seed;
+
+    OptimizerConfig();
+};
+
+/**
+ * how a float did over all the simulated purchase sequences
+ **/
+struct FloatResult
+{
+    unsigned int counts[NUM_DENOMS];
+    unsigned long purchases;
+    unsigned long changeFailures;
+
+    FloatResult();
+
+    /**
+     * @brief Get the fraction of purchases that could not be given change
+     * @return Change failure rate between 0 and 1
+    */
+    double getFailureRate() const;
+
+    /**
+     * @brief Get the value of the whole float in cents
+     * @return The value in cents
+    */
+    unsigned int getValue() const;
+};
+
+/**
+ * searches for the smallest coin float (by value) that keeps the change failure
+ * rate under a target, by simulating purchase sequences against the stock file's
+ * prices on a thread pool. every float is tried on the same random sequences
+ * so two floats are always compared fairly
+ **/
+class CoinOptimizer
+{
+public:
+    CoinOptimizer(const OptimizerConfig& config);
+
+    /**
+     * @brief Load the prices customers pay from a stock file
+     * @param stockFile The stock file
+     * @throws std::runtime_error
+    */
+    void load(const std::string& stockFile);
+
+    /**
+     * @brief Simulate every purchase sequence starting from a float
+     * @param counts The number of each denomination the machine starts with
+     * @return How the float did
+    */
+    FloatResult evaluate(const unsigned int counts[NUM_DENOMS]);
+
+    /**
+     * @brief Find the smallest float that meets the target
+     * Starts from DEFAULT_COIN_COUNT of everything (doubled until it meets the target),
+     * then keeps taking coins out of whichever denomination saves the most while still meeting it
+     * @return The recommended float
+     * @throws std::runtime_error if not even a very big float meets the target
+    */
+    FloatResult optimize();
+
+    /**
+     * @brief Get how many floats the search has simulated
+     * @return Number of floats
+    */
+    unsigned long getEvaluations() const;
+
+    /**
+     * @brief Work out change with the fewest coins without allocating anything
+     * Searches from the biggest denomination down and stops a branch as soon as
+     * it can't beat the best answer found so far
+     * @param change The change in cents
+     * @param counts The number of each denomination available
+     * @param coinsOut Where the number of each denomination to give back gets stored
+     * @return Whether the change can be given
+    */
+    static bool makeChange(unsigned int change, const unsigned int counts[NUM_DENOMS], unsigned int coinsOut[NUM_DENOMS]);
+
+    /**
+     * @brief Turn a float into a coin inventory that can be saved as a coin file
+     * @param counts The number of each denomination
+     * @return The coins indexed by Denomination
+    */
+    static CoinInventory toCoinList(const unsigned int counts[NUM_DENOMS]);
+
+    /**
+     * @brief Print a float and its failure rate
+     * @param os Where to print it
+     * @param title The heading
+     * @param result The float
+    */
+    static void print(std::ostream& os, const std::string& title, const FloatResult& result);
+
+private:
+    OptimizerConfig config;
+    ThreadPool pool;
+    std::vector<unsigned int> prices;
+    std::discrete_distribution<unsigned int> pickPrice;
+    std::discrete_distribution<unsigned int> pickDenom;
+    unsigned long evaluations;
+
+    /**
+     * @brief Simulate several floats at once, each on every purchase sequence
+     * @param floats The floats to simulate, their results get filled in
+    */
+    void evaluateAll(std::vector<FloatResult>& floats);
+
+    /**
+     * @brief Run one purchase sequence against a float
+     * @param counts The float, it gets changed by the sequence
+     * @param trial Which sequence, picks the random seed
+     * @param result Where the purchases and failures get added
+    */
+    void runTrial(unsigned int counts[NUM_DENOMS], unsigned int trial, FloatResult& result) const;
+};
+
+#endif // COIN_OPTIMIZER_H
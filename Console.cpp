@@ -0,0 +1,180 @@
+#include "Console.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+
+std::string LineView::toString() const
+{
+    return std::string(data, length);
+}
+
+//====CONSOLE BUFFER=====
+ConsoleBuffer::ConsoleBuffer(): previous(nullptr)
+{
+    //leave the last byte out of the put area so overflow always has room for its character
+    setp(buffer, buffer + CONSOLE_BUFFER_SIZE - 1);
+}
+
+ConsoleBuffer::~ConsoleBuffer()
+{
+    writeOut();
+    if (previous != nullptr && std::cout.rdbuf() == this)
+    {
+        std::cout.rdbuf(previous);
+    }
+}
+
+void ConsoleBuffer::install()
+{
+    if (previous == nullptr)
+    {
+        std::cout.flush();
+        previous = std::cout.rdbuf(this);
+    }
+}
+
+void ConsoleBuffer::writeOut()
+{
+    const char* next = pbase();
+    const char* end = pptr();
+
+    while (next < end)
+    {
+        ssize_t written = write(STDOUT_FILENO, next, end - next);
+        if (written > 0) {
+            next += written;
+        }
+        else if (errno != EINTR) {
+            //stdout is gone, nobody can see the rest anyway
+            next = end;
+        }
+    }
+
+    setp(buffer, buffer + CONSOLE_BUFFER_SIZE - 1);
+}
+
+ConsoleBuffer::int_type ConsoleBuffer::overflow(int_type ch)
+{
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    writeOut();
+    return traits_type::not_eof(ch);
+}
+
+int ConsoleBuffer::sync()
+{
+    //the real flush happens in Console::flush, when the input blocks or the program ends
+    return 0;
+}
+
+//====CONSOLE=====
+char Console::inBuffer[CONSOLE_BUFFER_SIZE];
+std::size_t Console::inPos = 0;
+std::size_t Console::inEnd = 0;
+bool Console::atEnd = false;
+std::string Console::spill;
+ConsoleBuffer Console::outBuffer;
+
+Console::Console() {}
+
+void Console::install()
+{
+    outBuffer.install();
+}
+
+void Console::flush()
+{
+    outBuffer.writeOut();
+}
+
+bool Console::refill()
+{
+    //if nothing is waiting on stdin the read is about to block, so the user
+    //needs to see the prompt first. piped input is always ready so it never flushes here
+    pollfd waiting = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&waiting, 1, 0) == 0)
+    {
+        std::cout.flush();
+        flush();
+    }
+
+    ssize_t got = -1;
+    while (got < 0)
+    {
+        got = read(STDIN_FILENO, inBuffer, CONSOLE_BUFFER_SIZE);
+        if (got < 0 && errno != EINTR)
+        {
+            //treat a broken stdin like the end of it
+            got = 0;
+        }
+    }
+
+    inPos = 0;
+    inEnd = got;
+    atEnd = got == 0;
+    return got > 0;
+}
+
+bool Console::readLineView(LineView& line)
+{
+    bool found = false;
+    bool spilled = false;
+    spill.clear();
+
+    while (!found && (inPos < inEnd || refill()))
+    {
+        const char* start = inBuffer + inPos;
+        std::size_t available = inEnd - inPos;
+        const char* newLine = static_cast<const char*>(std::memchr(start, '\n', available));
+
+        if (newLine != nullptr)
+        {
+            std::size_t length = newLine - start;
+            if (spilled)
+            {
+                spill.append(start, length);
+                line.data = spill.data();
+                line.length = spill.length();
+            }
+            else
+            {
+                //the whole line is in the buffer, hand it out as it is
+                line.data = start;
+                line.length = length;
+            }
+            inPos += length + 1;
+            found = true;
+        }
+        else
+        {
+            //the line carries on in the next block
+            spill.append(start, available);
+            spilled = true;
+            inPos = inEnd;
+        }
+    }
+
+    if (!found)
+    {
+        line.data = spill.data();
+        line.length = spill.length();
+    }
+
+    return found;
+}
+
+std::string Console::readLine()
+{
+    LineView line;
+    readLineView(line);
+    return line.toString();
+}
+
+bool Console::eof()
+{
+    return atEnd;
+}
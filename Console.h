@@ -0,0 +1,121 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+// how many bytes are read from stdin or written to stdout at once
+#define CONSOLE_BUFFER_SIZE 65536
+
+/**
+ * a line handed out by the console without copying it.
+ * it points into the console's buffer so it is only valid until the next read
+ **/
+struct LineView
+{
+    const char* data;
+    std::size_t length;
+
+    std::string toString() const;
+};
+
+/**
+ * the stream buffer std::cout writes into once Console::install() is called.
+ * it only writes to stdout when it is full or when Console::flush() is called,
+ * flushing the stream (e.g. std::endl) does not write anything by itself
+ **/
+class ConsoleBuffer : public std::streambuf
+{
+public:
+    ConsoleBuffer();
+
+    // writes what is left and gives std::cout its old buffer back
+    ~ConsoleBuffer();
+
+    ConsoleBuffer(const ConsoleBuffer&) = delete;
+    ConsoleBuffer& operator=(const ConsoleBuffer&) = delete;
+
+    /**
+     * @brief Point std::cout at this buffer
+    */
+    void install();
+
+    /**
+     * @brief Write everything buffered so far to stdout
+    */
+    void writeOut();
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    char buffer[CONSOLE_BUFFER_SIZE];
+
+    // what std::cout used before install(), nullptr if not installed
+    std::streambuf* previous;
+};
+
+/**
+ * the console input and output of ppd.
+ * stdin is read in big blocks and handed out a line at a time, and the output waits in a
+ * big buffer until the input would actually block (the user has to type something), so
+ * piped sessions run at memory speed and interactive ones see every prompt like before
+ **/
+class Console
+{
+private:
+    Console();
+
+    static char inBuffer[CONSOLE_BUFFER_SIZE];
+    static std::size_t inPos;
+    static std::size_t inEnd;
+
+    // whether a read hit the end of stdin
+    static bool atEnd;
+
+    // a line that didn't fit in what was left of inBuffer gets copied here
+    static std::string spill;
+
+    static ConsoleBuffer outBuffer;
+
+    /**
+     * @brief Read the next block of stdin, writing the output first if the read would block
+     * @return Whether anything was read
+    */
+    static bool refill();
+
+public:
+    /**
+     * @brief Make std::cout use the deferred output buffer
+    */
+    static void install();
+
+    /**
+     * @brief Write the buffered output now
+    */
+    static void flush();
+
+    /**
+     * @brief Read the next line of stdin without the new line
+     * @param line The line, only valid until the next read
+     * @return Whether a whole line was read, false if stdin ended first (line has whatever was read)
+    */
+    static bool readLineView(LineView& line);
+
+    /**
+     * @brief Read the next line of stdin without the new line
+     * @return The line
+    */
+    static std::string readLine();
+
+    /**
+     * @brief Get whether a read has hit the end of stdin (like std::cin.eof())
+     * @return Whether stdin ended
+    */
+    static bool eof();
+};
+
+#endif // CONSOLE_H
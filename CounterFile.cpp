@@ -0,0 +1,204 @@
+#include "CounterFile.h"
+#include "DenominationSet.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CounterFile::CounterFile(): layout(nullptr), stockFile(""), coinFile(""), syncInterval(COUNTERS_SYNC_ON_COMMIT), dirty(false), syncs(0) {}
+
+CounterFile::~CounterFile()
+{
+    if (layout != nullptr)
+    {
+        sync();
+        munmap(layout, sizeof(Layout));
+    }
+}
+
+std::string CounterFile::fileFor(const std::string& stockFile)
+{
+    return stockFile + COUNTERS_FILE_SUFFIX;
+}
+
+void CounterFile::open(const std::string& fileName, const std::string& stockFile, const std::string& coinFile, unsigned int syncInterval)
+{
+    if (layout != nullptr)
+    {
+        sync();
+        munmap(layout, sizeof(Layout));
+        layout = nullptr;
+    }
+
+    int fd = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("Could not open " + fileName + " to map it");
+    }
+
+    //an empty file was just created, it gets the layout's size (filled with zeros)
+    bool created = info.st_size == 0;
+    if ((!created && static_cast<std::size_t>(info.st_size) != sizeof(Layout)) || (created && ftruncate(fd, sizeof(Layout)) != 0))
+    {
+        close(fd);
+        throw std::runtime_error(fileName + " is not a counter file");
+    }
+
+    //shared so the changes go to the file, the mapping keeps it around after the descriptor is closed
+    void* mapped = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not map " + fileName);
+    }
+    layout = static_cast<Layout*>(mapped);
+
+    if (created)
+    {
+        std::memcpy(layout->magic, COUNTERS_MAGIC, COUNTERS_MAGIC_LEN);
+        layout->itemSlots = COUNTERS_ITEM_SLOTS;
+        layout->denoms = NUM_DENOMS;
+        clearItems();
+    }
+    else if (std::memcmp(layout->magic, COUNTERS_MAGIC, COUNTERS_MAGIC_LEN) != 0 || layout->itemSlots != COUNTERS_ITEM_SLOTS || layout->denoms != NUM_DENOMS)
+    {
+        munmap(layout, sizeof(Layout));
+        layout = nullptr;
+        throw std::runtime_error(fileName + " is not a counter file");
+    }
+
+    this->stockFile = stockFile;
+    this->coinFile = coinFile;
+    this->syncInterval = syncInterval;
+    lastSync = std::chrono::steady_clock::now();
+    dirty = created;
+}
+
+bool CounterFile::matchesTextFiles() const
+{
+    std::lock_guard<std::mutex> guard(stampLock);
+    bool matches = sameStamp(layout->stockStamp, stampOf(stockFile)) && sameStamp(layout->coinStamp, stampOf(coinFile));
+    for (unsigned int denom = 0; denom < NUM_DENOMS; ++denom)
+    {
+        matches = matches && layout->denomValues[denom] == DenominationSet::active().getValue(static_cast<Denomination>(denom));
+    }
+    return matches;
+}
+
+bool CounterFile::hasItem(unsigned int number) const
+{
+    return layout->onHand[number] != COUNTERS_ABSENT;
+}
+
+unsigned int CounterFile::getOnHand(unsigned int number) const
+{
+    return layout->onHand[number];
+}
+
+unsigned int CounterFile::getCoinCount(Denomination denom) const
+{
+    return layout->coinCounts[denom];
+}
+
+void CounterFile::setItem(unsigned int number, unsigned int onHand)
+{
+    layout->onHand[number] = onHand;
+}
+
+void CounterFile::removeItem(unsigned int number)
+{
+    layout->onHand[number] = COUNTERS_ABSENT;
+}
+
+void CounterFile::clearItems()
+{
+    std::fill(layout->onHand, layout->onHand + COUNTERS_ITEM_SLOTS, COUNTERS_ABSENT);
+}
+
+void CounterFile::setCoinCount(Denomination denom, unsigned int count)
+{
+    layout->coinCounts[denom] = count;
+}
+
+void CounterFile::commit()
+{
+    //the change is already in the file's pages, a sync only makes sure the disk has it too
+    layout->commits++;
+    dirty = true;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (syncInterval == COUNTERS_SYNC_ON_COMMIT || now - lastSync >= std::chrono::milliseconds(syncInterval))
+    {
+        sync();
+    }
+}
+
+void CounterFile::markTextFilesSaved()
+{
+    stampTextFiles();
+    commit();
+}
+
+void CounterFile::markSavedInBackground()
+{
+    //only the stamps change here, the sync doesn't touch what the customer thread keeps about syncs
+    stampTextFiles();
+    msync(layout, sizeof(Layout), MS_SYNC);
+}
+
+void CounterFile::stampTextFiles()
+{
+    std::lock_guard<std::mutex> guard(stampLock);
+    layout->stockStamp = stampOf(stockFile);
+    layout->coinStamp = stampOf(coinFile);
+    for (unsigned int denom = 0; denom < NUM_DENOMS; ++denom)
+    {
+        layout->denomValues[denom] = DenominationSet::active().getValue(static_cast<Denomination>(denom));
+    }
+}
+
+void CounterFile::sync()
+{
+    if (dirty)
+    {
+        msync(layout, sizeof(Layout), MS_SYNC);
+        lastSync = std::chrono::steady_clock::now();
+        dirty = false;
+        syncs++;
+    }
+}
+
+unsigned long long CounterFile::getCommits() const
+{
+    return layout->commits;
+}
+
+unsigned long CounterFile::getSyncs() const
+{
+    return syncs;
+}
+
+CounterFile::FileStamp CounterFile::stampOf(const std::string& fileName)
+{
+    FileStamp stamp = {0, 0, 0};
+    struct stat info;
+    if (stat(fileName.c_str(), &info) == 0)
+    {
+        stamp.size = info.st_size;
+        stamp.seconds = info.st_mtim.tv_sec;
+        stamp.nanoseconds = info.st_mtim.tv_nsec;
+    }
+    return stamp;
+}
+
+bool CounterFile::sameStamp(const FileStamp& a, const FileStamp& b)
+{
+    return a.size == b.size && a.seconds == b.seconds && a.nanoseconds == b.nanoseconds;
+}
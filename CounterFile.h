@@ -0,0 +1,203 @@
+#ifndef COUNTER_FILE_H
+#define COUNTER_FILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "Node.h"
+#include "Coin.h"
+
+// the file the counters are kept in is the stock file with this on the end
+#define COUNTERS_FILE_SUFFIX ".counters"
+
+// the first bytes of a counter file, the number goes up if the layout ever changes
+#define COUNTERS_MAGIC "PPDCNT01"
+#define COUNTERS_MAGIC_LEN 8
+
+// one slot for every possible item id
+#define COUNTERS_ITEM_SLOTS (STOCK_MAX_ID + 1)
+
+// what an item's slot holds when the item isn't in the machine
+#define COUNTERS_ABSENT 0xFFFFFFFFu
+
+// the sync interval that syncs the file at the end of every change
+#define COUNTERS_SYNC_ON_COMMIT 0
+
+/**
+ * the stock on hand of every item and the count of every denomination kept in a small memory
+ * mapped file with a fixed layout, so every change is in the file as soon as it's made instead of
+ * only when the stock file and coin file are written. the file also remembers the size and time of
+ * the stock file and coin file when they were last in step with it: if either was changed by
+ * something else since, the text files win
+ **/
+class CounterFile
+{
+public:
+    CounterFile();
+
+    // syncs and unmaps the file
+    ~CounterFile();
+
+    CounterFile(const CounterFile&) = delete;
+    CounterFile& operator=(const CounterFile&) = delete;
+
+    /**
+     * @brief Get the counter file kept next to a stock file
+     * @param stockFile The stock file
+     * @return The counter file's name
+    */
+    static std::string fileFor(const std::string& stockFile);
+
+    /**
+     * @brief Map the counter file, creating it if it isn't there
+     * @param fileName The counter file
+     * @param stockFile The stock file it keeps the counters of
+     * @param coinFile The coin file it keeps the counters of
+     * @param syncInterval The least milliseconds between two syncs, COUNTERS_SYNC_ON_COMMIT syncs every change
+     * @throws std::runtime_error if the file can't be mapped or isn't a counter file
+    */
+    void open(const std::string& fileName, const std::string& stockFile, const std::string& coinFile, unsigned int syncInterval);
+
+    /**
+     * @brief Check if the counters are newer than the stock file and coin file, which is when neither was
+     * changed since they were last in step and the counters are for the same denominations
+     * @return Whether to take the counters over the text files
+    */
+    bool matchesTextFiles() const;
+
+    /**
+     * @brief Check if an item has a slot
+     * @param number The number part of the item's id
+     * @return Whether the item is in the file
+    */
+    bool hasItem(unsigned int number) const;
+
+    /**
+     * @brief Get an item's stock on hand
+     * @param number The number part of the item's id, it has to be in the file
+     * @return The stock on hand
+    */
+    unsigned int getOnHand(unsigned int number) const;
+
+    /**
+     * @brief Get a denomination's count
+     * @param denom The denomination
+     * @return The count
+    */
+    unsigned int getCoinCount(Denomination denom) const;
+
+    /**
+     * @brief Set an item's stock on hand
+     * @param number The number part of the item's id
+     * @param onHand The stock on hand
+    */
+    void setItem(unsigned int number, unsigned int onHand);
+
+    /**
+     * @brief Take an item out of the file
+     * @param number The number part of the item's id
+    */
+    void removeItem(unsigned int number);
+
+    /**
+     * @brief Take every item out of the file
+    */
+    void clearItems();
+
+    /**
+     * @brief Set a denomination's count
+     * @param denom The denomination
+     * @param count The count
+    */
+    void setCoinCount(Denomination denom, unsigned int count);
+
+    /**
+     * @brief End a change, syncing the file if it's due
+    */
+    void commit();
+
+    /**
+     * @brief Remember the stock file and coin file as they are now, after they were written from the same counters
+    */
+    void markTextFilesSaved();
+
+    /**
+     * @brief Remember the stock file and coin file as they are now, after they were written from a snapshot
+     * on another thread, and sync the file. The counts are left alone, they can only be ahead of the snapshot
+    */
+    void markSavedInBackground();
+
+    /**
+     * @brief Write the file's pages to the disk and wait for them
+    */
+    void sync();
+
+    /**
+     * @brief Get the number of changes since the file was created
+     * @return Number of changes
+    */
+    unsigned long long getCommits() const;
+
+    /**
+     * @brief Get the number of syncs since the file was opened
+     * @return Number of syncs
+    */
+    unsigned long getSyncs() const;
+
+private:
+    // the size and change time of a text file, all 0 when it isn't there
+    struct FileStamp
+    {
+        int64_t size;
+        int64_t seconds;
+        int64_t nanoseconds;
+    };
+
+    // the layout of the whole file, only fixed size fields so it's the same every run
+    struct Layout
+    {
+        char magic[COUNTERS_MAGIC_LEN];
+        uint32_t itemSlots;
+        uint32_t denoms;
+        uint32_t denomValues[NUM_DENOMS];
+        FileStamp stockStamp;
+        FileStamp coinStamp;
+        uint64_t commits;
+        uint32_t onHand[COUNTERS_ITEM_SLOTS];
+        uint32_t coinCounts[NUM_DENOMS];
+    };
+
+    Layout* layout;
+    std::string stockFile;
+    std::string coinFile;
+    unsigned int syncInterval;
+    std::chrono::steady_clock::time_point lastSync;
+    bool dirty;
+    unsigned long syncs;
+
+    // the stamps and denominations are also written by a background save, the counts never are
+    mutable std::mutex stampLock;
+
+    /**
+     * @brief Set the stamps of the stock file and coin file and the denominations to how they are now
+    */
+    void stampTextFiles();
+
+    /**
+     * @brief Get the stamp of a text file
+     * @param fileName The file
+     * @return The stamp
+    */
+    static FileStamp stampOf(const std::string& fileName);
+
+    /**
+     * @brief Check if two stamps are the same
+     * @param a A stamp
+     * @param b Another stamp
+     * @return Whether they are
+    */
+    static bool sameStamp(const FileStamp& a, const FileStamp& b);
+};
+
+#endif // COUNTER_FILE_H
@@ -0,0 +1,231 @@
+#include "CreditTable.h"
+#include "Helper.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+CreditTable::CreditTable(): fileName("") {}
+
+void CreditTable::load(const std::string& fileName)
+{
+    balances.clear();
+    this->fileName = fileName;
+    file.close();
+
+    std::ifstream input(fileName, std::ios::binary);
+
+    //no file yet means nobody has any credit yet, it's made straight away so the changes have somewhere to go
+    bool rewrite = !input;
+    if (input)
+    {
+        char magic[4] = {0};
+        std::uint32_t count = 0;
+        input.read(magic, sizeof(magic));
+        input.read(reinterpret_cast<char*>(&count), sizeof(count));
+        bool legacy = std::memcmp(magic, CREDIT_LEGACY_FILE_MAGIC, sizeof(magic)) == 0;
+        if (!input || (!legacy && std::memcmp(magic, CREDIT_FILE_MAGIC, sizeof(magic)) != 0))
+        {
+            throw std::runtime_error("Credit file is not a valid credit file");
+        }
+
+        balances.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            //an old file has a 32 bit token and a balance per account
+            std::uint64_t token = 0;
+            std::uint32_t record[2] = {0, 0};
+            if (legacy)
+            {
+                input.read(reinterpret_cast<char*>(record), sizeof(record));
+                token = record[0];
+                record[0] = record[1];
+            }
+            else
+            {
+                input.read(reinterpret_cast<char*>(&token), sizeof(token));
+                input.read(reinterpret_cast<char*>(record), sizeof(record));
+            }
+            if (!input || token == 0 || token > CREDIT_MAX_TOKEN || hasAccount(token))
+            {
+                throw std::runtime_error("Credit file account No. " + std::to_string(i + 1) + " is not valid");
+            }
+            balances[token] = Account{record[0], i};
+        }
+
+        //an old file's records are a different size, it's written again so every record is where writeAccount expects it
+        rewrite = legacy;
+    }
+    input.close();
+
+    if (rewrite)
+    {
+        save(fileName);
+    }
+    else
+    {
+        openFile();
+    }
+}
+
+void CreditTable::save(const std::string& fileName)
+{
+    //every account goes in its own record, so the records stay where the open file has them
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> records(balances.size());
+    for (const auto& account : balances)
+    {
+        records[account.second.record] = std::make_pair(account.first, account.second.cents);
+    }
+
+    std::string tempFileName = fileName + ".tmp";
+    std::ofstream output(tempFileName, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        throw std::runtime_error("Could not save the credit file " + fileName);
+    }
+
+    std::uint32_t count = records.size();
+    output.write(CREDIT_FILE_MAGIC, std::strlen(CREDIT_FILE_MAGIC));
+    output.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const std::pair<std::uint64_t, std::uint32_t>& record : records)
+    {
+        std::uint32_t fields[2] = {record.second, 0};
+        output.write(reinterpret_cast<const char*>(&record.first), sizeof(record.first));
+        output.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+    output.close();
+
+    if (!output || std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tempFileName.c_str());
+        throw std::runtime_error("Could not save the credit file " + fileName);
+    }
+
+    //the open file was the one just replaced, the changes have to go into the new one
+    if (fileName == this->fileName)
+    {
+        openFile();
+    }
+}
+
+void CreditTable::openFile()
+{
+    file.close();
+    file.clear();
+    file.open(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open the credit file " + fileName);
+    }
+}
+
+void CreditTable::writeAccount(unsigned long long token, const Account& account, bool opened)
+{
+    std::streamoff recordStart = CREDIT_HEADER_SIZE + static_cast<std::streamoff>(account.record) * CREDIT_RECORD_SIZE;
+    if (opened)
+    {
+        //the record goes in before the count covers it, so a file cut short in between still reads
+        std::uint64_t fileToken = token;
+        std::uint32_t fields[2] = {account.cents, 0};
+        std::uint32_t count = account.record + 1;
+        file.seekp(recordStart);
+        file.write(reinterpret_cast<const char*>(&fileToken), sizeof(fileToken));
+        file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        file.flush();
+        file.seekp(std::strlen(CREDIT_FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    else
+    {
+        std::uint32_t cents = account.cents;
+        file.seekp(recordStart + CREDIT_BALANCE_OFFSET);
+        file.write(reinterpret_cast<const char*>(&cents), sizeof(cents));
+    }
+    file.flush();
+
+    if (!file)
+    {
+        file.clear();
+        throw std::runtime_error("Could not save the credit file " + fileName);
+    }
+}
+
+bool CreditTable::hasAccount(unsigned long long token) const
+{
+    return balances.find(token) != balances.end();
+}
+
+unsigned int CreditTable::getBalance(unsigned long long token) const
+{
+    auto found = balances.find(token);
+    return found == balances.end() ? 0 : found->second.cents;
+}
+
+void CreditTable::setBalance(unsigned long long token, unsigned int cents)
+{
+    //a new account gets the next record
+    auto found = balances.find(token);
+    bool opened = found == balances.end();
+    Account account = opened ? Account{cents, static_cast<unsigned int>(balances.size())} : Account{cents, found->second.record};
+
+    //the customer has paid in by now, so the file has it before anything else happens
+    if (!fileName.empty())
+    {
+        writeAccount(token, account, opened);
+    }
+    balances[token] = account;
+}
+
+unsigned long long CreditTable::openAccount(unsigned int cents)
+{
+    if (balances.size() >= CREDIT_MAX_TOKEN - CREDIT_MIN_TOKEN)
+    {
+        throw std::runtime_error("Ran out of credit tokens");
+    }
+
+    //random from the operating system, so one customer's token says nothing about another's
+    std::random_device random;
+    std::uniform_int_distribution<unsigned long long> tokens(CREDIT_MIN_TOKEN, CREDIT_MAX_TOKEN);
+    unsigned long long token = tokens(random);
+    while (hasAccount(token))
+    {
+        token = tokens(random);
+    }
+
+    setBalance(token, cents);
+    return token;
+}
+
+unsigned int CreditTable::size() const
+{
+    return balances.size();
+}
+
+unsigned long long CreditTable::tryParseToken(const std::string& s)
+{
+    std::string format = "Credit token has to be " + std::string(1, CREDIT_TOKEN_PREFIX) + " followed by " + std::to_string(CREDIT_TOKEN_DIGITS) + " digits";
+
+    //check the length and the prefix
+    if ((s.length() != CREDIT_TOKEN_DIGITS + 1 && s.length() != CREDIT_LEGACY_TOKEN_DIGITS + 1) || s.at(0) != CREDIT_TOKEN_PREFIX)
+    {
+        throw std::runtime_error(format);
+    }
+
+    //check the number part
+    std::string numberPart = s.substr(1);
+    if (numberPart.find_first_not_of("0123456789") != std::string::npos || std::stoull(numberPart) == 0)
+    {
+        throw std::runtime_error(format);
+    }
+
+    return std::stoull(numberPart);
+}
+
+std::string CreditTable::tokenToString(unsigned long long token)
+{
+    std::string number = std::to_string(token);
+    unsigned int digits = token <= CREDIT_LEGACY_MAX_TOKEN ? CREDIT_LEGACY_TOKEN_DIGITS : CREDIT_TOKEN_DIGITS;
+    return CREDIT_TOKEN_PREFIX + std::string(digits - number.length(), '0') + number;
+}
@@ -0,0 +1,147 @@
+#ifndef CREDIT_TABLE_H
+#define CREDIT_TABLE_H
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+// a customer token is the prefix followed by CREDIT_TOKEN_DIGITS random digits, e.g. C482913075561.
+// the token is all a customer needs to spend their credit, so it can't be guessed from another one
+#define CREDIT_TOKEN_PREFIX 'C'
+#define CREDIT_TOKEN_DIGITS 12
+#define CREDIT_MIN_TOKEN 100000000000ULL
+#define CREDIT_MAX_TOKEN 999999999999ULL
+
+// tokens given out before they were random had 6 digits and counted up, they still work
+#define CREDIT_LEGACY_TOKEN_DIGITS 6
+#define CREDIT_LEGACY_MAX_TOKEN 999999ULL
+
+// what a customer types to get a new token
+#define CREDIT_NEW_TOKEN "new"
+
+// the first 4 bytes of a credit file, and of one from before the tokens were random
+#define CREDIT_FILE_MAGIC "PPC2"
+#define CREDIT_LEGACY_FILE_MAGIC "PPDC"
+
+// the magic and the number of accounts come first, then one record per account
+#define CREDIT_HEADER_SIZE 8
+#define CREDIT_RECORD_SIZE 16
+
+// where the balance is in a record, after the token
+#define CREDIT_BALANCE_OFFSET 8
+
+/**
+ * the stored value balances of the customers, in cents, looked up by token.
+ * the file is binary: the magic, the number of accounts, then a token (64 bit), a balance and
+ * a spare field (both 32 bit) per account, so each account takes 16 bytes. once it's been loaded
+ * the file stays open and every change is written straight into it: a new balance over the old one
+ * in the account's record, a new account on the end and then the count. so no credit is lost if the
+ * program stops, and a change never costs more than a couple of small writes
+ **/
+class CreditTable
+{
+public:
+    CreditTable();
+
+    /**
+     * @brief Load the balances from a credit file, a file that doesn't exist yet is an empty table.
+     * A file from before (or no file) is written again in the current layout, every change after this
+     * is written into the same file
+     * @param fileName The credit file
+     * @throws std::runtime_error
+    */
+    void load(const std::string& fileName);
+
+    /**
+     * @brief Save every balance into a credit file, written next to it then renamed over so it's never half written.
+     * Each account keeps its record, if it's the loaded file the changes after go into the new one
+     * @param fileName The credit file
+     * @throws std::runtime_error
+    */
+    void save(const std::string& fileName);
+
+    /**
+     * @brief Get whether a token has an account
+     * @param token The token number
+     * @return Whether it has an account
+    */
+    bool hasAccount(unsigned long long token) const;
+
+    /**
+     * @brief Get the balance of an account
+     * @param token The token number
+     * @return The balance in cents, 0 if there's no account
+    */
+    unsigned int getBalance(unsigned long long token) const;
+
+    /**
+     * @brief Set the balance of an account, opening it if there isn't one, and write it into the file.
+     * Nothing changes if it can't be written
+     * @param token The token number
+     * @param cents The balance in cents
+     * @throws std::runtime_error
+    */
+    void setBalance(unsigned long long token, unsigned int cents);
+
+    /**
+     * @brief Open an account with a random token and write it into the file
+     * @param cents The balance to start with in cents
+     * @return The token number of the new account
+     * @throws std::runtime_error
+    */
+    unsigned long long openAccount(unsigned int cents);
+
+    /**
+     * @brief Get the number of accounts
+     * @return Number of accounts
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Validate the user's token, e.g. C482913075561 (or C000001 from before the tokens were random)
+     * @param s The user's input
+     * @return The token number
+     * @throws std::runtime_error
+    */
+    static unsigned long long tryParseToken(const std::string& s);
+
+    /**
+     * @brief Get the token string of a token number, e.g. 482913075561 is C482913075561 and 1 is C000001
+     * @param token The token number
+     * @return The token string
+    */
+    static std::string tokenToString(unsigned long long token);
+
+private:
+    // an account's balance and which record in the file is its
+    struct Account
+    {
+        unsigned int cents;
+        unsigned int record;
+    };
+
+    std::unordered_map<unsigned long long, Account> balances;
+
+    // the file every change is written to, empty until the table is loaded
+    std::string fileName;
+
+    // the file kept open to write the changes into
+    std::fstream file;
+
+    /**
+     * @brief Open the loaded file to write the changes into
+     * @throws std::runtime_error
+    */
+    void openFile();
+
+    /**
+     * @brief Write an account into its record in the file, a new account goes on the end and then the count goes up
+     * @param token The token number
+     * @param account The account
+     * @param opened Whether the account is new
+     * @throws std::runtime_error
+    */
+    void writeAccount(unsigned long long token, const Account& account, bool opened);
+};
+
+#endif // CREDIT_TABLE_H
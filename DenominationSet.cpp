@@ -0,0 +1,347 @@
+#include "DenominationSet.h"
+#include "Helper.h"
+#include "Metrics.h"
+#include <algorithm>
+
+//the built in sets, everything about them is known at compile time so their change search can be too
+struct AudSet
+{
+    static constexpr unsigned int values[NUM_DENOMS] = {
+        FIVE_CENTS_VAL, TEN_CENTS_VAL, TWENTY_CENTS_VAL, FIFTY_CENTS_VAL, ONE_DOLLAR_VAL,
+        TWO_DOLLARS_VAL, FIVE_DOLLARS_VAL, TEN_DOLLARS_VAL
+    };
+    static constexpr const char* labels[NUM_DENOMS] = {
+        "5 Cents", "10 Cents", "20 Cents", "50 Cents", "1 Dollar", "2 Dollar", "5 Dollar", "10 Dollar"
+    };
+    static constexpr const char* shortLabels[NUM_DENOMS] = {
+        "5c", "10c", "20c", "50c", "$1", "$2", "$5", "$10"
+    };
+};
+
+struct UsdSet
+{
+    static constexpr unsigned int values[NUM_DENOMS] = {1, 5, 10, 25, 100, 500, 1000, 2000};
+    static constexpr const char* labels[NUM_DENOMS] = {
+        "1 Cent", "5 Cents", "10 Cents", "25 Cents", "1 Dollar", "5 Dollar", "10 Dollar", "20 Dollar"
+    };
+    static constexpr const char* shortLabels[NUM_DENOMS] = {
+        "1c", "5c", "10c", "25c", "$1", "$5", "$10", "$20"
+    };
+};
+
+struct EurSet
+{
+    static constexpr unsigned int values[NUM_DENOMS] = {5, 10, 20, 50, 100, 200, 500, 1000};
+    static constexpr const char* labels[NUM_DENOMS] = {
+        "5 Cents", "10 Cents", "20 Cents", "50 Cents", "1 Euro", "2 Euro", "5 Euro", "10 Euro"
+    };
+    static constexpr const char* shortLabels[NUM_DENOMS] = {
+        "5c", "10c", "20c", "50c", "€1", "€2", "€5", "€10"
+    };
+};
+
+struct GbpSet
+{
+    static constexpr unsigned int values[NUM_DENOMS] = {5, 10, 20, 50, 100, 200, 500, 1000};
+    static constexpr const char* labels[NUM_DENOMS] = {
+        "5 Pence", "10 Pence", "20 Pence", "50 Pence", "1 Pound", "2 Pound", "5 Pound", "10 Pound"
+    };
+    static constexpr const char* shortLabels[NUM_DENOMS] = {
+        "5p", "10p", "20p", "50p", "£1", "£2", "£5", "£10"
+    };
+};
+
+constexpr unsigned int AudSet::values[NUM_DENOMS];
+constexpr const char* AudSet::labels[NUM_DENOMS];
+constexpr const char* AudSet::shortLabels[NUM_DENOMS];
+constexpr unsigned int UsdSet::values[NUM_DENOMS];
+constexpr const char* UsdSet::labels[NUM_DENOMS];
+constexpr const char* UsdSet::shortLabels[NUM_DENOMS];
+constexpr unsigned int EurSet::values[NUM_DENOMS];
+constexpr const char* EurSet::labels[NUM_DENOMS];
+constexpr const char* EurSet::shortLabels[NUM_DENOMS];
+constexpr unsigned int GbpSet::values[NUM_DENOMS];
+constexpr const char* GbpSet::labels[NUM_DENOMS];
+constexpr const char* GbpSet::shortLabels[NUM_DENOMS];
+
+/**
+ * @brief Check a set goes from the lowest value to the highest, the change search relies on it
+ * @return Whether it does
+*/
+template <typename Set>
+constexpr bool ascending()
+{
+    bool result = Set::values[0] > 0;
+    for (unsigned int i = 1; i < NUM_DENOMS; ++i)
+    {
+        result = result && Set::values[i - 1] < Set::values[i];
+    }
+    return result;
+}
+
+static_assert(ascending<AudSet>() && ascending<UsdSet>() && ascending<EurSet>() && ascending<GbpSet>(),
+    "The denominations of a set have to be in ascending order of value");
+static_assert(AudSet::values[FIVE_CENTS] == FIVE_CENTS_VAL && AudSet::values[TEN_DOLLARS] == TEN_DOLLARS_VAL,
+    "The AUD set has to match Denomination");
+
+/**
+ * the change search for one denomination of a set known at compile time. each one calls the one for the
+ * next denomination down, so the whole search is unrolled and every value is a constant
+ **/
+template <typename Set, int Index>
+struct FixedChangeSolver
+{
+    static void search(unsigned int remaining, const unsigned int counts[NUM_DENOMS], unsigned int state[NUM_DENOMS],
+        unsigned int used, unsigned int best[NUM_DENOMS], unsigned int& bestUsed)
+    {
+        Metrics::add(COUNTER_COMBINATION_NODES);
+        Metrics::raise(COUNTER_COMBINATION_MAX_DEPTH, NUM_DENOMS - Index);
+
+        constexpr unsigned int value = Set::values[Index];
+        unsigned int maxFit = std::min(remaining / value, counts[Index]);
+        for (unsigned int i = 0; i <= maxFit; ++i)
+        {
+            state[Index] = i;
+            FixedChangeSolver<Set, Index - 1>::search(remaining - value * i, counts, state, used + i, best, bestUsed);
+        }
+    }
+};
+
+//past the lowest denomination, keep the combination if it's exact and has fewer coins than the best one
+template <typename Set>
+struct FixedChangeSolver<Set, -1>
+{
+    static void search(unsigned int remaining, const unsigned int counts[NUM_DENOMS], unsigned int state[NUM_DENOMS],
+        unsigned int used, unsigned int best[NUM_DENOMS], unsigned int& bestUsed)
+    {
+        if (remaining == 0 && used < bestUsed)
+        {
+            std::copy(state, state + NUM_DENOMS, best);
+            bestUsed = used;
+        }
+    }
+};
+
+/**
+ * @brief The same search as FixedChangeSolver for a set only known at runtime
+ * @param values The values of the set
+ * @param index The denomination we are at, we go from the highest down to 0
+*/
+static void searchAnySet(const unsigned int values[NUM_DENOMS], unsigned int remaining, const unsigned int counts[NUM_DENOMS],
+    unsigned int state[NUM_DENOMS], int index, unsigned int used, unsigned int best[NUM_DENOMS], unsigned int& bestUsed)
+{
+    if (index < 0)
+    {
+        if (remaining == 0 && used < bestUsed)
+        {
+            std::copy(state, state + NUM_DENOMS, best);
+            bestUsed = used;
+        }
+    }
+    else
+    {
+        Metrics::add(COUNTER_COMBINATION_NODES);
+        Metrics::raise(COUNTER_COMBINATION_MAX_DEPTH, NUM_DENOMS - index);
+
+        unsigned int value = values[index];
+        unsigned int maxFit = std::min(remaining / value, counts[index]);
+        for (unsigned int i = 0; i <= maxFit; ++i)
+        {
+            state[index] = i;
+            searchAnySet(values, remaining - value * i, counts, state, index - 1, used + i, best, bestUsed);
+        }
+    }
+}
+
+// a built in set and its compiled change search
+struct BuiltInSet
+{
+    const char* name;
+    const unsigned int* values;
+    const char* const* labels;
+    const char* const* shortLabels;
+    DenominationSet::ChangeSolver solver;
+};
+
+static const BuiltInSet BUILT_IN_SETS[] = {
+    {"AUD", AudSet::values, AudSet::labels, AudSet::shortLabels, &FixedChangeSolver<AudSet, NUM_DENOMS - 1>::search},
+    {"USD", UsdSet::values, UsdSet::labels, UsdSet::shortLabels, &FixedChangeSolver<UsdSet, NUM_DENOMS - 1>::search},
+    {"EUR", EurSet::values, EurSet::labels, EurSet::shortLabels, &FixedChangeSolver<EurSet, NUM_DENOMS - 1>::search},
+    {"GBP", GbpSet::values, GbpSet::labels, GbpSet::shortLabels, &FixedChangeSolver<GbpSet, NUM_DENOMS - 1>::search}
+};
+
+//the set the machines take
+static DenominationSet& activeSet()
+{
+    static DenominationSet set = DenominationSet::builtIn(DEFAULT_DENOM_SET);
+    return set;
+}
+
+DenominationSet::DenominationSet(): name(""), values(), solver(nullptr) {}
+
+DenominationSet DenominationSet::builtIn(const std::string& name)
+{
+    DenominationSet set;
+    for (const BuiltInSet& builtIn : BUILT_IN_SETS)
+    {
+        if (name == builtIn.name)
+        {
+            set.name = builtIn.name;
+            for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+            {
+                set.values[i] = builtIn.values[i];
+                set.labels[i] = builtIn.labels[i];
+                set.shortLabels[i] = builtIn.shortLabels[i];
+            }
+            set.solver = builtIn.solver;
+        }
+    }
+
+    if (set.name.empty())
+    {
+        throw std::runtime_error("There is no built in denomination set called " + name);
+    }
+    return set;
+}
+
+DenominationSet DenominationSet::tryLoadFile(const std::string& fileName)
+{
+    DenominationSet set;
+
+    std::ifstream fileStream;
+    fileStream.open(fileName);
+
+    //check if the file exists
+    if (!fileStream) {
+        throw std::runtime_error("Denomination set file not found");
+    }
+
+    //the first line is the name of the set
+    std::string line;
+    std::getline(fileStream, line);
+    std::string setName = Helper::stringTrim(line);
+    if (setName.length() < MINLEN || setName.length() > DENOM_LABEL_LEN)
+    {
+        fileStream.close();
+        throw std::runtime_error("Denomination set name needs to be between " + std::to_string(MINLEN) + " and " + std::to_string(DENOM_LABEL_LEN) + " characters");
+    }
+    set.name = setName;
+
+    //then one line for each denomination
+    unsigned int count = 0;
+    std::getline(fileStream, line);
+    while (!fileStream.eof() && !line.empty())
+    {
+        std::string errorMessagePrefix = "Denomination No. " + std::to_string(count + 1) + " failed, ";
+        std::vector<std::string> denomInfo = Helper::splitStringAndTrim(line, DELIM);
+
+        try
+        {
+            if (count == NUM_DENOMS)
+            {
+                throw std::runtime_error("A set needs to have " + std::to_string(NUM_DENOMS) + " denominations");
+            }
+            if (denomInfo.size() != DENOM_SET_ATTRIB)
+            {
+                throw std::runtime_error("Needs to have " + std::to_string(DENOM_SET_ATTRIB) + " attributes");
+            }
+
+            int value = 0;
+            try {
+                value = Helper::tryParseInt(denomInfo[0]);
+            }
+            catch(const std::runtime_error& e) {
+                throw std::runtime_error("Value needs to be a valid integer");
+            }
+
+            //the search relies on the values going up
+            if (value <= 0 || (count > 0 && static_cast<unsigned int>(value) <= set.values[count - 1]))
+            {
+                throw std::runtime_error("Value needs to be more than the one before it");
+            }
+
+            set.values[count] = value;
+            set.shortLabels[count] = Helper::tryParseStringSize(denomInfo[1], "Short label", MINLEN, DENOM_LABEL_LEN);
+            set.labels[count] = Helper::tryParseStringSize(denomInfo[2], "Label", MINLEN, DENOM_LABEL_LEN);
+        }
+        catch(const std::runtime_error& e)
+        {
+            fileStream.close();
+            throw std::runtime_error(errorMessagePrefix + std::string(e.what()));
+        }
+
+        count += 1;
+        std::getline(fileStream, line);
+    }
+
+    //make sure we close the file
+    fileStream.close();
+
+    if (count != NUM_DENOMS)
+    {
+        throw std::runtime_error("Denomination set file must have " + std::to_string(NUM_DENOMS) + " denominations");
+    }
+
+    return set;
+}
+
+DenominationSet DenominationSet::find(const std::string& nameOrFile)
+{
+    bool isBuiltIn = false;
+    for (const BuiltInSet& builtIn : BUILT_IN_SETS)
+    {
+        isBuiltIn = isBuiltIn || nameOrFile == builtIn.name;
+    }
+    return isBuiltIn ? builtIn(nameOrFile) : tryLoadFile(nameOrFile);
+}
+
+const DenominationSet& DenominationSet::active()
+{
+    return activeSet();
+}
+
+void DenominationSet::setActive(const DenominationSet& set)
+{
+    activeSet() = set;
+}
+
+const std::string& DenominationSet::getName() const { return name; }
+
+unsigned int DenominationSet::getValue(Denomination denom) const { return values[denom]; }
+
+const std::string& DenominationSet::getLabel(Denomination denom) const { return labels[denom]; }
+
+const std::string& DenominationSet::getShortLabel(Denomination denom) const { return shortLabels[denom]; }
+
+unsigned int DenominationSet::getSmallest() const { return values[0]; }
+
+bool DenominationSet::isSpecialised() const { return solver != nullptr; }
+
+unsigned int DenominationSet::indexOf(unsigned int value) const
+{
+    unsigned int index = 0;
+    while (index < NUM_DENOMS && values[index] != value)
+    {
+        ++index;
+    }
+    return index;
+}
+
+bool DenominationSet::makeChange(unsigned int change, const unsigned int counts[NUM_DENOMS], unsigned int coinsOut[NUM_DENOMS]) const
+{
+    unsigned int bestUsed = static_cast<unsigned int>(-1);
+    unsigned int state[NUM_DENOMS] = {0};
+
+    std::fill(coinsOut, coinsOut + NUM_DENOMS, 0);
+    if (solver != nullptr)
+    {
+        solver(change, counts, state, 0, coinsOut, bestUsed);
+    }
+    else
+    {
+        searchAnySet(values, change, counts, state, NUM_DENOMS - 1, 0, coinsOut, bestUsed);
+    }
+
+    //nothing was found if the best is still the starting value
+    return bestUsed != static_cast<unsigned int>(-1);
+}
@@ -0,0 +1,115 @@
+#ifndef DENOMINATION_SET_H
+#define DENOMINATION_SET_H
+
+#include <string>
+#include "Coin.h"
+
+//the set the machine takes when no other one is picked
+#define DEFAULT_DENOM_SET "AUD"
+
+//the longest label a denomination in a set file can have
+#define DENOM_LABEL_LEN 16
+
+//the number of attributes for each denomination in a set file
+#define DENOM_SET_ATTRIB 3
+
+/**
+ * the denominations a machine takes, e.g. the Australian ones. every set has NUM_DENOMS of them,
+ * from the lowest value to the highest, and a Denomination is just a position in the set
+ * (the enum is named after the AUD ones).
+ * the built in sets (AUD, USD, EUR, GBP) each have a change search compiled for their values,
+ * a set loaded from a file uses one that looks the values up as it goes
+ **/
+class DenominationSet
+{
+public:
+    // a change search compiled for one set, see makeChange
+    typedef void (*ChangeSolver)(unsigned int remaining, const unsigned int counts[NUM_DENOMS], unsigned int state[NUM_DENOMS],
+        unsigned int used, unsigned int best[NUM_DENOMS], unsigned int& bestUsed);
+
+    DenominationSet();
+
+    /**
+     * @brief Get one of the built in sets
+     * @param name AUD, USD, EUR or GBP
+     * @return The set
+     * @throws std::runtime_error if there's no set with that name
+    */
+    static DenominationSet builtIn(const std::string& name);
+
+    /**
+     * @brief Try load a set from a file, the first line is the name of the set then each line is
+     * value,short label,label (e.g. 5,5c,5 Cents) from the lowest value to the highest
+     * @param fileName The file
+     * @return The set
+     * @throws std::runtime_error
+    */
+    static DenominationSet tryLoadFile(const std::string& fileName);
+
+    /**
+     * @brief Get a built in set by its name, or load it from a file if it isn't one
+     * @param nameOrFile The name or the file
+     * @return The set
+     * @throws std::runtime_error
+    */
+    static DenominationSet find(const std::string& nameOrFile);
+
+    /**
+     * @brief Get the set the machines take, AUD unless setActive was called
+     * @return The set
+    */
+    static const DenominationSet& active();
+
+    /**
+     * @brief Change the set the machines take, this has to happen before anything is loaded
+     * and before any other threads start
+     * @param set The set
+    */
+    static void setActive(const DenominationSet& set);
+
+    //getters
+    const std::string& getName() const;
+    unsigned int getValue(Denomination denom) const;
+    const std::string& getLabel(Denomination denom) const;
+    const std::string& getShortLabel(Denomination denom) const;
+
+    /**
+     * @brief Get the value of the lowest denomination, prices and change are in multiples of it
+     * @return The value in cents
+    */
+    unsigned int getSmallest() const;
+
+    /**
+     * @brief Get whether the set has a change search compiled for it
+     * @return Whether it's a built in set
+    */
+    bool isSpecialised() const;
+
+    /**
+     * @brief Find the denomination with some value
+     * @param value The value in cents
+     * @return The Denomination as an index, NUM_DENOMS if the set doesn't have that value
+    */
+    unsigned int indexOf(unsigned int value) const;
+
+    /**
+     * @brief Find the fewest coins that make up the change. Every combination is looked at from the highest
+     * denomination down and the first with the fewest coins is kept. Nothing here touches the heap
+     * @param change The change in cents
+     * @param counts The number of each denomination there is (indexed by Denomination)
+     * @param coinsOut Set to the number of each denomination to give back, all 0 if there's no way
+     * @return Whether the change can be made
+    */
+    bool makeChange(unsigned int change, const unsigned int counts[NUM_DENOMS], unsigned int coinsOut[NUM_DENOMS]) const;
+
+private:
+    std::string name;
+    unsigned int values[NUM_DENOMS];
+    std::string labels[NUM_DENOMS];
+    std::string shortLabels[NUM_DENOMS];
+
+    // nullptr for a set loaded from a file
+    ChangeSolver solver;
+};
+
+#endif // DENOMINATION_SET_H
@@ -0,0 +1,281 @@
+#include "DescriptionIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include "NameIndex.h"
+
+//====POSTING LIST=====
+DescriptionIndex::PostingList::PostingList(): count(0), last(0) {}
+
+DescriptionIndex::PostingCursor::PostingCursor(const PostingList* list):
+    list(list), position(0), current(0), finished(false)
+{
+    next();
+}
+
+bool DescriptionIndex::PostingCursor::done() const
+{
+    return finished;
+}
+
+unsigned int DescriptionIndex::PostingCursor::value() const
+{
+    return current;
+}
+
+void DescriptionIndex::PostingCursor::next()
+{
+    if (list == nullptr || position >= list->bytes.size())
+    {
+        finished = true;
+    }
+    else
+    {
+        //add up the 7 bit groups until a byte without the top bit, that's the gap to the next number
+        unsigned int gap = 0;
+        unsigned int shift = 0;
+        unsigned char byte = 0;
+        do
+        {
+            byte = list->bytes[position++];
+            gap |= static_cast<unsigned int>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        current += gap;
+    }
+}
+
+//====DESCRIPTION INDEX=====
+DescriptionIndex::DescriptionIndex() {}
+
+void DescriptionIndex::clear()
+{
+    postings.clear();
+    entries.clear();
+}
+
+unsigned int DescriptionIndex::itemNumber(const std::string& itemId)
+{
+    return Stock::idToNumber(itemId);
+}
+
+std::vector<std::string> DescriptionIndex::tokenize(const std::string& text)
+{
+    std::vector<std::string> words;
+    std::string word = "";
+
+    //a word is a run of letters and digits, everything else splits them
+    for (unsigned int i = 0; i <= text.length(); ++i)
+    {
+        if (i < text.length() && std::isalnum(static_cast<unsigned char>(text[i])))
+        {
+            word += std::tolower(static_cast<unsigned char>(text[i]));
+        }
+        else
+        {
+            if (word.length() >= DESC_MIN_WORD_LENGTH)
+            {
+                words.push_back(word);
+            }
+            word.clear();
+        }
+    }
+
+    return words;
+}
+
+void DescriptionIndex::appendVarint(std::vector<unsigned char>& bytes, unsigned int value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<unsigned char>(value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<unsigned char>(value));
+}
+
+DescriptionIndex::PostingList DescriptionIndex::encode(const std::vector<unsigned int>& numbers)
+{
+    PostingList list;
+    for (unsigned int number : numbers)
+    {
+        appendVarint(list.bytes, number - list.last);
+        list.last = number;
+        ++list.count;
+    }
+    list.bytes.shrink_to_fit();
+    return list;
+}
+
+std::vector<unsigned int> DescriptionIndex::decode(const PostingList& list)
+{
+    std::vector<unsigned int> numbers;
+    numbers.reserve(list.count);
+    for (PostingCursor cursor(&list); !cursor.done(); cursor.next())
+    {
+        numbers.push_back(cursor.value());
+    }
+    return numbers;
+}
+
+void DescriptionIndex::insert(const Stock& stock)
+{
+    //an item that is already in here gets its words redone
+    remove(stock.getId());
+
+    unsigned int number = itemNumber(stock.getId());
+    Entry entry{&stock, tokenize(stock.getDescription())};
+    std::sort(entry.words.begin(), entry.words.end());
+    entry.words.erase(std::unique(entry.words.begin(), entry.words.end()), entry.words.end());
+
+    for (const std::string& word : entry.words)
+    {
+        PostingList& list = postings[word];
+        if (list.count == 0 || number > list.last)
+        {
+            //the usual case when loading in id order, just add the gap on the end
+            appendVarint(list.bytes, number - list.last);
+            list.last = number;
+            ++list.count;
+        }
+        else
+        {
+            std::vector<unsigned int> numbers = decode(list);
+            numbers.insert(std::lower_bound(numbers.begin(), numbers.end(), number), number);
+            list = encode(numbers);
+        }
+    }
+    entries[number] = entry;
+}
+
+void DescriptionIndex::remove(const std::string& itemId)
+{
+    unsigned int number = itemNumber(itemId);
+    std::unordered_map<unsigned int, Entry>::iterator found = entries.find(number);
+    if (found != entries.end())
+    {
+        for (const std::string& word : found->second.words)
+        {
+            std::unordered_map<std::string, PostingList>::iterator list = postings.find(word);
+            std::vector<unsigned int> numbers = decode(list->second);
+            numbers.erase(std::lower_bound(numbers.begin(), numbers.end(), number));
+
+            //a word nobody uses any more goes away completely
+            if (numbers.empty())
+            {
+                postings.erase(list);
+            }
+            else
+            {
+                list->second = encode(numbers);
+            }
+        }
+        entries.erase(found);
+    }
+}
+
+unsigned int DescriptionIndex::size() const
+{
+    return entries.size();
+}
+
+unsigned int DescriptionIndex::getWordCount() const
+{
+    return postings.size();
+}
+
+unsigned long DescriptionIndex::getPostingBytes() const
+{
+    unsigned long bytes = 0;
+    for (const std::pair<const std::string, PostingList>& posting : postings)
+    {
+        bytes += posting.second.bytes.size();
+    }
+    return bytes;
+}
+
+std::vector<unsigned int> DescriptionIndex::intersect(const std::vector<std::string>& words) const
+{
+    std::vector<unsigned int> results;
+    std::vector<const PostingList*> lists;
+    bool missing = false;
+
+    for (const std::string& word : words)
+    {
+        std::unordered_map<std::string, PostingList>::const_iterator list = postings.find(word);
+        if (list == postings.end()) {
+            missing = true;
+        }
+        else {
+            lists.push_back(&list->second);
+        }
+    }
+
+    if (!missing && !lists.empty())
+    {
+        //the shortest list gives the candidates, the other cursors skip forward to each one
+        std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b){
+            return a->count < b->count;
+        });
+        std::vector<PostingCursor> cursors;
+        for (const PostingList* list : lists)
+        {
+            cursors.push_back(PostingCursor(list));
+        }
+
+        bool exhausted = false;
+        for (; !cursors[0].done() && !exhausted; cursors[0].next())
+        {
+            unsigned int candidate = cursors[0].value();
+            bool inAll = true;
+            for (unsigned int i = 1; i < cursors.size() && inAll && !exhausted; ++i)
+            {
+                while (!cursors[i].done() && cursors[i].value() < candidate)
+                {
+                    cursors[i].next();
+                }
+                exhausted = cursors[i].done();
+                inAll = !exhausted && cursors[i].value() == candidate;
+            }
+            if (inAll && !exhausted)
+            {
+                results.push_back(candidate);
+            }
+        }
+    }
+
+    return results;
+}
+
+std::vector<const Stock*> DescriptionIndex::find(const std::string& query) const
+{
+    //"or" splits the query into groups, every word of a group has to be there
+    std::vector<std::vector<std::string>> groups(1);
+    for (const std::string& word : tokenize(query))
+    {
+        if (word == DESC_QUERY_OR) {
+            groups.push_back(std::vector<std::string>());
+        }
+        else {
+            groups.back().push_back(word);
+        }
+    }
+
+    std::vector<unsigned int> numbers;
+    for (const std::vector<std::string>& group : groups)
+    {
+        std::vector<unsigned int> groupNumbers = intersect(group);
+        std::vector<unsigned int> merged;
+        std::set_union(numbers.begin(), numbers.end(), groupNumbers.begin(), groupNumbers.end(), std::back_inserter(merged));
+        numbers.swap(merged);
+    }
+
+    std::vector<const Stock*> results;
+    for (unsigned int number : numbers)
+    {
+        results.push_back(entries.at(number).stock);
+    }
+    NameIndex::sortByName(results);
+
+    return results;
+}
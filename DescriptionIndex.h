@@ -0,0 +1,166 @@
+#ifndef DESCRIPTION_INDEX_H
+#define DESCRIPTION_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Node.h"
+
+// words shorter than this are not indexed (e.g. "a", "in")
+#define DESC_MIN_WORD_LENGTH 2
+
+// the word that splits a query into alternatives, e.g. "lemon tart or apple"
+#define DESC_QUERY_OR "or"
+
+/**
+ * an inverted index from the words in the item descriptions to the items that use them.
+ * each word's posting list is the item numbers in ascending order, stored as the gaps
+ * between them in a variable length encoding (7 bits a byte), so a list of nearby items
+ * takes about a byte per item. the lists are merged without decoding them into vectors.
+ * like NameIndex the items are pointed to, not copied
+ **/
+class DescriptionIndex
+{
+public:
+    DescriptionIndex();
+
+    /**
+     * @brief Forget every item
+    */
+    void clear();
+
+    /**
+     * @brief Add an item under each word of its description
+     * @param stock The item, must stay where it is until it is removed
+    */
+    void insert(const Stock& stock);
+
+    /**
+     * @brief Remove an item, it doesn't have to still exist
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Get the number of items in the index
+     * @return Number of items
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Get the number of different words in the index
+     * @return Number of words
+    */
+    unsigned int getWordCount() const;
+
+    /**
+     * @brief Get the bytes used by the encoded posting lists
+     * @return Number of bytes
+    */
+    unsigned long getPostingBytes() const;
+
+    /**
+     * @brief Find the items whose description has all the words of the query,
+     * or all the words of one of the parts of the query split by "or"
+     * @param query The words to look for, any case
+     * @return The items in ascending order of name
+    */
+    std::vector<const Stock*> find(const std::string& query) const;
+
+    /**
+     * @brief Split text into folded words, dropping punctuation and words shorter than DESC_MIN_WORD_LENGTH
+     * @param text The text
+     * @return The words in the order they appear, with repeats
+    */
+    static std::vector<std::string> tokenize(const std::string& text);
+
+private:
+    // the items with a word, as gaps between ascending item numbers
+    struct PostingList
+    {
+        std::vector<unsigned char> bytes;
+        unsigned int count;
+
+        // the biggest item number in the list, so adding a bigger one is just appending
+        unsigned int last;
+
+        PostingList();
+    };
+
+    // reads the item numbers of a posting list back in order
+    class PostingCursor
+    {
+    public:
+        PostingCursor(const PostingList* list);
+
+        /**
+         * @brief Get whether every item number has been read
+         * @return Whether the cursor is at the end
+        */
+        bool done() const;
+
+        /**
+         * @brief Get the item number the cursor is on
+         * @return The item number
+        */
+        unsigned int value() const;
+
+        /**
+         * @brief Move to the next item number
+        */
+        void next();
+
+    private:
+        const PostingList* list;
+        unsigned int position;
+        unsigned int current;
+        bool finished;
+    };
+
+    // an item in the index and the words it was added under
+    struct Entry
+    {
+        const Stock* stock;
+        std::vector<std::string> words;
+    };
+
+    std::unordered_map<std::string, PostingList> postings;
+    std::unordered_map<unsigned int, Entry> entries;
+
+    /**
+     * @brief Get the number part of an item id, e.g. 12 for I0012
+     * @param itemId The item id
+     * @return The item number
+    */
+    static unsigned int itemNumber(const std::string& itemId);
+
+    /**
+     * @brief Add a number to the end of an encoded list as 7 bits a byte, the top bit says more bytes follow
+     * @param bytes The encoded list
+     * @param value The number to add
+    */
+    static void appendVarint(std::vector<unsigned char>& bytes, unsigned int value);
+
+    /**
+     * @brief Encode ascending item numbers as a posting list
+     * @param numbers The item numbers in ascending order
+     * @return The posting list
+    */
+    static PostingList encode(const std::vector<unsigned int>& numbers);
+
+    /**
+     * @brief Decode a posting list back into item numbers
+     * @param list The posting list
+     * @return The item numbers in ascending order
+    */
+    static std::vector<unsigned int> decode(const PostingList& list);
+
+    /**
+     * @brief Find the items with every one of some words by walking their lists together
+     * @param words The folded words
+     * @return The item numbers in ascending order
+    */
+    std::vector<unsigned int> intersect(const std::vector<std::string>& words) const;
+};
+
+#endif // DESCRIPTION_INDEX_H
@@ -0,0 +1,197 @@
+#include "FleetSimulator.h"
+#include <chrono>
+#include <sys/stat.h>
+
+//====CONFIG AND REPORT=====
+FleetConfig::FleetConfig():
+    stockFile("stock.dat"), coinFile("coins.dat"), dataDir("fleet_data"), machines(1), customersPerMachine(1000),
+    batchSize(FLEET_DEFAULT_BATCH), restockInterval(FLEET_DEFAULT_RESTOCK_INTERVAL), threads(0), seed(1) {}
+
+FleetReport::FleetReport():
+    machines(0), threads(0), customers(0), purchases(0), changeFailures(0), stockouts(0), cancellations(0), steals(0), seconds(0) {}
+
+double FleetReport::getThroughput() const
+{
+    return seconds > 0 ? customers / seconds : 0;
+}
+
+double FleetReport::getChangeFailureRate() const
+{
+    //only customers that paid in full can run into a change failure
+    unsigned long paid = purchases + changeFailures;
+    return paid > 0 ? static_cast<double>(changeFailures) / paid : 0;
+}
+
+double FleetReport::getStockoutRate() const
+{
+    return customers > 0 ? static_cast<double>(stockouts) / customers : 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const FleetReport& report)
+{
+    os << "Fleet Summary" << std::endl;
+    os << "-------------" << std::endl;
+    os << "Machines:            " << report.machines << std::endl;
+    os << "Threads:             " << report.threads << std::endl;
+    os << "Customers:           " << report.customers << std::endl;
+    os << "Purchases:           " << report.purchases << std::endl;
+    os << "Cancellations:       " << report.cancellations << std::endl;
+    os << "Elapsed (s):         " << report.seconds << std::endl;
+    os << "Throughput (cust/s): " << report.getThroughput() << std::endl;
+    os << "Change failure rate: " << report.getChangeFailureRate() << std::endl;
+    os << "Stockout rate:       " << report.getStockoutRate() << std::endl;
+    os << "Stolen tasks:        " << report.steals << std::endl;
+    return os;
+}
+
+//====FLEET SIMULATOR=====
+FleetSimulator::SimulatedMachine::SimulatedMachine(unsigned int seed, unsigned int customers):
+    rng(seed), nullOut(nullptr), customersLeft(customers), sinceRestock(0), customers(0), purchases(0), changeFailures(0), stockouts(0), cancellations(0)
+{
+    //an ostream without a buffer ignores everything written to it
+    machine.setOutput(nullOut);
+}
+
+FleetSimulator::FleetSimulator(const FleetConfig& config): config(config) {}
+
+void FleetSimulator::setup()
+{
+    //the items customers can pick from
+    std::vector<Stock> stockVector = Helper::tryLoadStockFile(config.stockFile);
+    for (const Stock& stock : stockVector)
+    {
+        products.push_back(Product{stock.getId(), stock.getPrice().getValue()});
+    }
+
+    if (products.empty())
+    {
+        throw std::runtime_error("Stock file has no items for the customers to buy");
+    }
+
+    //it's fine if the directory already exists
+    mkdir(config.dataDir.c_str(), 0755);
+
+    fleet.clear();
+    for (unsigned int i = 0; i < config.machines; ++i)
+    {
+        //give each machine its own copy of the stock file and coin file
+        std::string prefix = config.dataDir + "/machine" + std::to_string(i) + "_";
+        std::string stockCopy = prefix + "stock.dat";
+        std::string coinCopy = prefix + "coins.dat";
+
+        std::ifstream stockIn(config.stockFile);
+        std::ofstream stockOut(stockCopy, std::fstream::out | std::fstream::trunc);
+        stockOut << stockIn.rdbuf();
+        stockOut.close();
+
+        std::ifstream coinIn(config.coinFile);
+        std::ofstream coinOut(coinCopy, std::fstream::out | std::fstream::trunc);
+        coinOut << coinIn.rdbuf();
+        coinOut.close();
+
+        std::unique_ptr<SimulatedMachine> sim(new SimulatedMachine(config.seed + i, config.customersPerMachine));
+        sim->stockFile = stockCopy;
+        sim->coinFile = coinCopy;
+        sim->machine.load(stockCopy, coinCopy);
+        fleet.push_back(std::move(sim));
+    }
+}
+
+void FleetSimulator::serveCustomer(SimulatedMachine& sim)
+{
+    //pick an item then keep handing over random notes/coins until it's paid for
+    std::uniform_int_distribution<unsigned int> pickProduct(0, products.size() - 1);
+    std::uniform_int_distribution<unsigned int> pickDenom(0, NUM_DENOMS - 1);
+
+    const Product& product = products[pickProduct(sim.rng)];
+    ScriptInput script;
+    script.push(product.id);
+
+    unsigned int paid = 0;
+    while (paid < product.price)
+    {
+        unsigned int value = Helper::denomToValue(static_cast<Denomination>(pickDenom(sim.rng)));
+        script.push(std::to_string(value));
+        paid += value;
+    }
+
+    PurchaseSession session(sim.machine, sim.nullOut);
+    session.run(script);
+
+    //keep count of how the purchase went
+    ++sim.customers;
+    PurchaseOutcome outcome = session.getOutcome();
+    if (outcome == PURCHASE_COMPLETED) {
+        ++sim.purchases;
+    }
+    else if (outcome == PURCHASE_NO_CHANGE) {
+        ++sim.changeFailures;
+    }
+    else if (outcome == PURCHASE_OUT_OF_STOCK) {
+        ++sim.stockouts;
+    }
+    else {
+        ++sim.cancellations;
+    }
+}
+
+void FleetSimulator::runBatch(ThreadPool& pool, SimulatedMachine& sim)
+{
+    unsigned int batch = std::min(config.batchSize, sim.customersLeft);
+    for (unsigned int i = 0; i < batch; ++i)
+    {
+        //a service visit every so often, 0 means the machine is never restocked
+        if (config.restockInterval > 0 && sim.sinceRestock == config.restockInterval)
+        {
+            sim.machine.resetStock();
+            sim.machine.resetCoin();
+            sim.sinceRestock = 0;
+        }
+
+        serveCustomer(sim);
+        ++sim.sinceRestock;
+    }
+    sim.customersLeft -= batch;
+
+    //queue the next batch for this machine, it goes on our own queue so idle workers can steal it
+    if (sim.customersLeft > 0)
+    {
+        pool.submit([this, &pool, &sim](){
+            runBatch(pool, sim);
+        });
+    }
+}
+
+FleetReport FleetSimulator::run()
+{
+    FleetReport report;
+    ThreadPool pool(config.threads);
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (std::unique_ptr<SimulatedMachine>& sim : fleet)
+    {
+        SimulatedMachine* simPtr = sim.get();
+        pool.submit([this, &pool, simPtr](){
+            runBatch(pool, *simPtr);
+        });
+    }
+    pool.wait();
+    auto endTime = std::chrono::steady_clock::now();
+
+    //add up what each machine saw
+    report.machines = fleet.size();
+    report.threads = pool.size();
+    report.steals = pool.getStealCount();
+    report.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    for (const std::unique_ptr<SimulatedMachine>& sim : fleet)
+    {
+        report.customers += sim->customers;
+        report.purchases += sim->purchases;
+        report.changeFailures += sim->changeFailures;
+        report.stockouts += sim->stockouts;
+        report.cancellations += sim->cancellations;
+        sim->machine.save(sim->stockFile, sim->coinFile);
+    }
+
+    return report;
+}
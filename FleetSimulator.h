@@ -0,0 +1,147 @@
+#ifndef FLEET_SIMULATOR_H
+#define FLEET_SIMULATOR_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "VendingMachine.h"
+#include "ThreadPool.h"
+
+// how many customers a machine serves before its task yields back to the pool
+#define FLEET_DEFAULT_BATCH 64
+
+// how many customers a machine serves between service visits (reset stock and coins)
+#define FLEET_DEFAULT_RESTOCK_INTERVAL 500
+
+/**
+ * settings for a fleet simulation
+ **/
+struct FleetConfig
+{
+    // the stock file and coin file every machine starts from
+    std::string stockFile;
+    std::string coinFile;
+
+    // the directory where each machine gets its own copy of the files
+    std::string dataDir;
+
+    unsigned int machines;
+    unsigned int customersPerMachine;
+    unsigned int batchSize;
+    unsigned int restockInterval;
+    unsigned int threads;
+    unsigned int seed;
+
+    FleetConfig();
+};
+
+/**
+ * the combined results of a fleet simulation
+ **/
+struct FleetReport
+{
+    unsigned int machines;
+    unsigned int threads;
+    unsigned long customers;
+    unsigned long purchases;
+    unsigned long changeFailures;
+    unsigned long stockouts;
+    unsigned long cancellations;
+    unsigned long steals;
+    double seconds;
+
+    FleetReport();
+
+    /**
+     * @brief Get the number of customers served per second
+     * @return Customers per second
+    */
+    double getThroughput() const;
+
+    /**
+     * @brief Get the fraction of paid customers that could not be given change
+     * @return Change failure rate between 0 and 1
+    */
+    double getChangeFailureRate() const;
+
+    /**
+     * @brief Get the fraction of customers that picked an item with none left
+     * @return Stockout rate between 0 and 1
+    */
+    double getStockoutRate() const;
+
+    //lets us std::cout the report
+    friend std::ostream& operator<<(std::ostream& os, const FleetReport& report);
+};
+
+/**
+ * hosts many independent vending machines in one process and runs synthetic
+ * customer traffic against them on a work stealing thread pool.
+ * a machine is only ever worked on by one task at a time, each task serves a
+ * batch of customers then queues the next batch for the same machine
+ **/
+class FleetSimulator
+{
+public:
+    FleetSimulator(const FleetConfig& config);
+
+    /**
+     * @brief Copy the data files for each machine and load them
+     * @throws std::runtime_error
+    */
+    void setup();
+
+    /**
+     * @brief Run all the customers against all the machines then save each machine's files
+     * @return The combined results
+    */
+    FleetReport run();
+
+private:
+    // a machine in the fleet and everything only its own task touches
+    struct SimulatedMachine
+    {
+        VendingMachine machine;
+        std::string stockFile;
+        std::string coinFile;
+        std::mt19937 rng;
+        std::ostream nullOut;
+        unsigned int customersLeft;
+        unsigned int sinceRestock;
+
+        unsigned long customers;
+        unsigned long purchases;
+        unsigned long changeFailures;
+        unsigned long stockouts;
+        unsigned long cancellations;
+
+        SimulatedMachine(unsigned int seed, unsigned int customers);
+    };
+
+    // an item customers can pick, read from the stock file all the machines start from
+    struct Product
+    {
+        std::string id;
+        unsigned int price;
+    };
+
+    FleetConfig config;
+    std::vector<Product> products;
+    std::vector<std::unique_ptr<SimulatedMachine>> fleet;
+
+    /**
+     * @brief Serve the next batch of customers of a machine then queue the rest
+     * @param pool The pool to queue the next batch on
+     * @param sim The machine to serve
+    */
+    void runBatch(ThreadPool& pool, SimulatedMachine& sim);
+
+    /**
+     * @brief Pick an item and the coins for one customer then run their purchase
+     * @param sim The machine the customer is at
+    */
+    void serveCustomer(SimulatedMachine& sim);
+};
+
+#endif // FLEET_SIMULATOR_H
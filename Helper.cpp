@@ -1,4 +1,8 @@
 #include "Helper.h"
+#include "Metrics.h"
+#include "Console.h"
+#include "DenominationSet.h"
+#include <cstdio>
 
 //Helper methods
 Helper::Helper(){}
@@ -64,10 +68,8 @@ std::vector<std::string> Helper::splitStringAndTrim(const std::string& s, const
 std::string Helper::readInput()
 {
     //FROM ASSIGNMENT 1
-    //but removed the cout new line
-    std::string input;
-    std::getline(std::cin, input);
-    return input;
+    //but removed the cout new line, and reads from the buffered console instead of std::cin
+    return Console::readLine();
 }
 
 template <typename T>
@@ -83,9 +85,9 @@ T Helper::getUserInputPersistent(const std::string& prompt, const std::function<
         std::string inputStr = Helper::readInput();
 
         //if EOF of Return on empty input then terminate
-        if (std::cin.eof() || inputStr.empty())
+        if (Console::eof() || inputStr.empty())
         {
-            if (std::cin.eof())
+            if (Console::eof())
             {
                 //this is just to make the output more bareable to look at
                 std::cout << std::endl;
@@ -177,7 +179,20 @@ unsigned int Helper::round(unsigned int num, unsigned int multiple)
     return (num - a > num - b) ? b : a;
 }
 
-std::vector<Stock> Helper::tryLoadStockFile(const std::string& fileName) {
+// read a line of a stock file without its ending, which can be "\r\n" as well as "\n"
+// returns how many characters the line takes up in the file before its "\n"
+static std::size_t readStockFileLine(std::istream& fileStream, std::string& line)
+{
+    std::getline(fileStream, line);
+    std::size_t length = line.length();
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.pop_back();
+    }
+    return length;
+}
+
+std::vector<Stock> Helper::tryLoadStockFile(const std::string& fileName, bool lazyDescriptions) {
     //the output list
     std::vector<Stock> listStock;
 
@@ -192,9 +207,19 @@ std::vector<Stock> Helper::tryLoadStockFile(const std::string& fileName) {
         throw std::runtime_error("Stock file not found");
     } 
 
+    //the descriptions get pointed at in the mapped file instead of copied, they are only read when they are looked at
+    const char* mappedFile = nullptr;
+    if (lazyDescriptions)
+    {
+        mappedFile = StringArena::catalog().mapFile(fileName);
+    }
+
     //get the first line of the file
     std::string line;
-    std::getline(fileStream, line);
+    std::size_t lineLength = readStockFileLine(fileStream, line);
+
+    //where the line starts in the file
+    std::size_t lineOffset = 0;
     
     //keeps track of the item number we're at
     int itemCounter = 0;
@@ -244,12 +269,24 @@ std::vector<Stock> Helper::tryLoadStockFile(const std::string& fileName) {
         }
 
         //add the item to the stockList and add the id to the uniqueIds set
-        Stock stock(itemId, name, desc, price, quantity);
-        listStock.push_back(stock);
+        if (mappedFile != nullptr)
+        {
+            //the trimmed description is the first thing after the name that matches it
+            std::size_t nameStart = line.find(nameStr, line.find(STOCK_DELIM));
+            std::size_t descStart = line.find(desc, nameStart + nameStr.length());
+            ArenaString description = StringArena::catalog().external(mappedFile + lineOffset + descStart, desc.length());
+            listStock.push_back(Stock(itemId, name, description, price, quantity));
+        }
+        else
+        {
+            Stock stock(itemId, name, desc, price, quantity);
+            listStock.push_back(stock);
+        }
         uniqueIds.insert(idStr);
 
-        //read the next line
-        std::getline(fileStream, line);
+        //read the next line, it starts after this one's "\n" (and its "\r" if it had one)
+        lineOffset += lineLength + 1;
+        lineLength = readStockFileLine(fileStream, line);
     }
 
     //make sure we closed the file
@@ -258,14 +295,13 @@ std::vector<Stock> Helper::tryLoadStockFile(const std::string& fileName) {
     return listStock;
 } 
 
-std::vector<Coin> Helper::tryLoadCoinsFile(const std::string& fileName) {
+CoinInventory Helper::tryLoadCoinsFile(const std::string& fileName) {
 
-    //the output list
-    std::vector<Coin> listCoins;
+    //the output inventory, each coin goes in its denomination's slot
+    CoinInventory coins;
 
-    //used to make sure we don't have duplicate denominations
-    //hopefully this copies the set please
-    std::unordered_set<Denomination> denomLeft = Coin::allDenom;
+    //a bit for each denomination we've loaded, so we don't get duplicates and know when we have them all
+    unsigned int denomsLoaded = 0;
 
     std::ifstream fileStream;
     fileStream.open(fileName);
@@ -304,7 +340,7 @@ std::vector<Coin> Helper::tryLoadCoinsFile(const std::string& fileName) {
         try
         {
             denom = tryParseDenom(valueStr);
-            if (denomLeft.find(denom) == denomLeft.end())
+            if ((denomsLoaded & (1u << denom)) != 0)
             {
                 throw std::runtime_error("Denomination already exists");
             }
@@ -321,10 +357,9 @@ std::vector<Coin> Helper::tryLoadCoinsFile(const std::string& fileName) {
             throw std::runtime_error(errorMessagePrefix + std::string(e.what()));
         }
 
-        //add the coin to the coin list and remove its Denominatio enum value from the denomLeft srt
-        Coin coin(denom, quantity);
-        listCoins.push_back(coin);
-        denomLeft.erase(denom);
+        //put the coin in its slot and mark its denomination as loaded
+        coins[denom] = Coin(denom, quantity);
+        denomsLoaded |= 1u << denom;
         
         //read the next line
         std::getline(fileStream, line);
@@ -333,35 +368,69 @@ std::vector<Coin> Helper::tryLoadCoinsFile(const std::string& fileName) {
     //make sure we close the file
     fileStream.close();
 
-    // check if the denomLeft set is empty
-    // if it is empty then all the denomination values have been added
-    if (!denomLeft.empty())
+    // check if every denomination's bit is set
+    // if it is then all the denomination values have been added
+    if (denomsLoaded != ALL_DENOMS_MASK)
     {
         throw std::runtime_error("Coins File must contain all denomination values");
     }
 
-    return listCoins;
+    return coins;
+}
+
+//write an item as a line of the stock file
+static void writeStockLine(std::ostream& file, const Stock& s)
+{
+    char price[PRICE_STRING_LEN];
+    s.getPrice().format(price, false);
+    file << s.getId() << STOCK_DELIM << s.name << STOCK_DELIM << s.description << STOCK_DELIM << price << STOCK_DELIM << s.getOnHand() << std::endl;
+}
+
+// close a file written next to fileName and move it over fileName, the temp file is deleted if either fails
+static void replaceWithTempFile(std::ofstream& file, const std::string& tempFileName, const std::string& fileName)
+{
+    file.close();
+    bool failed = file.fail() || std::rename(tempFileName.c_str(), fileName.c_str()) != 0;
+    if (failed)
+    {
+        //the old file is still there as it was
+        std::remove(tempFileName.c_str());
+        throw std::runtime_error("Could not save the stock file " + fileName);
+    }
 }
 
 void Helper::saveStockList(const std::string& fileName, const LinkedList& stockList)
 {
     std::ofstream file;
 
-    //open the file with everything cleared beforehand
-    //ASSUMPTION: file already exists, or does std::fstream::trunc create it for me? Dunno, didn't check
-    file.open(fileName, std::fstream::out | std::fstream::trunc);
+    //write a new file and move it over the old one, rewriting the old one in place would change
+    //the descriptions of a lazily loaded stock list under it while they're being saved
+    std::string tempFileName = fileName + ".tmp";
+    file.open(tempFileName, std::fstream::out | std::fstream::trunc);
 
     //loop through the stock list and shove in each item as a line of text in the file
     stockList.forEach([&file](const Stock& s)
     {
-        file << s.getId() << STOCK_DELIM << s.getName() << STOCK_DELIM << s.getDescription() << STOCK_DELIM << s.getPrice().getString(false) << STOCK_DELIM << s.getOnHand() << std::endl;
+        writeStockLine(file, s);
     });
     
-    //make sure to close the file
-    file.close();
+    //make sure to close the file, it only replaces the old one if everything was written
+    replaceWithTempFile(file, tempFileName, fileName);
 }
 
-void Helper::saveCoinList(const std::string& fileName, const std::vector<Coin>& coinList)
+void Helper::saveStockList(const std::string& fileName, const std::vector<Stock>& items)
+{
+    //the same as for the stock list, written next to the file then moved over it
+    std::string tempFileName = fileName + ".tmp";
+    std::ofstream file(tempFileName, std::fstream::out | std::fstream::trunc);
+    for (const Stock& s : items)
+    {
+        writeStockLine(file, s);
+    }
+    replaceWithTempFile(file, tempFileName, fileName);
+}
+
+void Helper::saveCoinList(const std::string& fileName, const CoinInventory& coinList)
 {
     std::ofstream file;
 
@@ -370,7 +439,7 @@ void Helper::saveCoinList(const std::string& fileName, const std::vector<Coin>&
     file.open(fileName, std::fstream::out | std::fstream::trunc);
 
     //loop through the coin list and shove in each coin as a line of text in the file
-    for (Coin coin: coinList)
+    for (const Coin& coin: coinList)
     {
         file << Helper::denomToValue(coin.getDenom()) << DELIM << coin.getCount() << std::endl;
     }
@@ -445,9 +514,10 @@ Price Helper::tryParsePrice(const std::string& s)
     }
 
     //make sure the price is in multiples of the smallest denomination
-    if (cents % FIVE_CENTS_VAL != 0)
+    unsigned int smallest = DenominationSet::active().getSmallest();
+    if (cents % smallest != 0)
     {
-        throw std::runtime_error("Price cents must be divisible by 5");
+        throw std::runtime_error("Price cents must be divisible by " + std::to_string(smallest));
     }
 
     return Price(dollars, cents);
@@ -483,157 +553,31 @@ Denomination Helper::tryParseDenom(const std::string& s)
 
 Denomination Helper::tryParseDenom(unsigned int i)
 {
-    /*
-        FIVE_CENTS      <- 5
-        TEN_CENTS       <- 10
-        TWENTY_CENTS    <- 20
-        FIFTY_CENTS     <- 50
-        ONE_DOLALR      <- 100 
-        TWO_DOLALRS     <- 200
-        FIVE_DOLLARS    <- 500
-        TEN_DOLLARS     <- 1000
-
-        ERROR           <- Else
-    */
-
-    Denomination result = FIVE_CENTS;
-
-    if (i == FIVE_CENTS_VAL) {
-        result = FIVE_CENTS;
-    }
-    else if (i == TEN_CENTS_VAL) {
-        result = TEN_CENTS;
-    }
-    else if (i == TWENTY_CENTS_VAL) {
-        result = TWENTY_CENTS;
-    }
-    else if (i == FIFTY_CENTS_VAL) {
-        result = FIFTY_CENTS;
-    }
-    else if (i == ONE_DOLLAR_VAL) {
-        result = ONE_DOLLAR;
-    }
-    else if (i == TWO_DOLLARS_VAL) {
-        result = TWO_DOLLARS;
-    }
-    else if (i == FIVE_DOLLARS_VAL) {
-        result = FIVE_DOLLARS;
-    }
-    else if (i == TEN_DOLLARS_VAL) {
-        result = TEN_DOLLARS;
-    }
-    else
+    //look the value up in the denominations the machine takes, the index it's at is the Denomination
+    unsigned int index = DenominationSet::active().indexOf(i);
+    if (index == NUM_DENOMS)
     {
         throw std::runtime_error("Denomination value needs to valid");
     }
 
-    return result;
+    return static_cast<Denomination>(index);
 }
 
 unsigned int Helper::denomToValue(Denomination denom)
 {
-    /*
-        FIVE_CENTS      -> 5
-        TEN_CENTS       -> 10
-        TWENTY_CENTS    -> 20
-        FIFTY_CENTS     -> 50
-        ONE_DOLALR      -> 100 
-        TWO_DOLALRS     -> 200
-        FIVE_DOLLARS    -> 500
-        TEN_DOLLARS     -> 1000
-    */
-    unsigned int result = 0;
-
-    if (denom == FIVE_CENTS) {
-        result = FIVE_CENTS_VAL;
-    }
-    else if (denom == TEN_CENTS) {
-        result = TEN_CENTS_VAL;
-    }
-    else if (denom == TWENTY_CENTS) {
-        result = TWENTY_CENTS_VAL;
-    }
-    else if (denom == FIFTY_CENTS) {
-        result = FIFTY_CENTS_VAL;
-    }
-    else if (denom == ONE_DOLLAR) { 
-        result = ONE_DOLLAR_VAL;
-    }
-    else if (denom == TWO_DOLLARS) {
-        result = TWO_DOLLARS_VAL;
-    }
-    else if (denom == FIVE_DOLLARS) {
-        result = FIVE_DOLLARS_VAL;
-    }
-    else if (denom == TEN_DOLLARS) {
-        result = TEN_DOLLARS_VAL;
-    }
-
-    return result;
+    return DenominationSet::active().getValue(denom);
 }
 
 std::string Helper::denomToString(Denomination denom)
 {
-    /*
-        FIVE_CENTS      -> 5 Cents
-        TEN_CENTS       -> 10 Cents
-        TWENTY_CENTS    -> 20 Cents
-        FIFTY_CENTS     -> 50 Cents
-        ONE_DOLALR      -> 1 Dollar
-        TWO_DOLALRS     -> 2 Dollar
-        FIVE_DOLLARS    -> 5 Dollar
-        TEN_DOLLARS     -> 10 Dollar
-    */
-
-    unsigned int denomVal = denomToValue(denom);
-
-    std::string result = "";
-
-    std::string dollarStr = "Dollar";
-    std::string centsStr = "Cents";
-    
-    if (denomVal >= ONE_DOLLAR_VAL)
-    {
-        result = std::to_string(denomVal / ONE_DOLLAR_VAL) + " " + dollarStr;
-    }
-    else
-    {
-        result = std::to_string(denomVal) + " " + centsStr;
-    }
-
-    return result;
+    //e.g. 5 Cents, 1 Dollar
+    return DenominationSet::active().getLabel(denom);
 }
 
 std::string Helper::denomToShortString(Denomination denom)
 {
-    /*
-        FIVE_CENTS      -> 5c
-        TEN_CENTS       -> 10c
-        TWENTY_CENTS    -> 20c
-        FIFTY_CENTS     -> 50c
-        ONE_DOLALR      -> $1
-        TWO_DOLALRS     -> $2
-        FIVE_DOLLARS    -> $5
-        TEN_DOLLARS     -> $10
-    */
-
-    unsigned int denomVal = denomToValue(denom);
-
-    std::string result = "";
-
-    std::string dollarStr = "$";
-    std::string centsStr = "c";
-    
-    if (denomVal >= ONE_DOLLAR_VAL)
-    {
-        result = dollarStr + std::to_string(denomVal / ONE_DOLLAR_VAL);
-    }
-    else
-    {
-        result = std::to_string(denomVal) + centsStr;
-    }
-
-    return result;
+    //e.g. 5c, $1
+    return DenominationSet::active().getShortLabel(denom);
 }
 
 Price Helper::valueToPrice(unsigned int value)
@@ -712,66 +656,14 @@ std::string Helper::tryParseDescription(const std::string& s)
     return tryParseStringSize(s, "Description", MINLEN, DESCLEN);
 }
 
-unsigned int Helper::getCoinsStateSum(unsigned int coinsState[NUM_DENOMS])
+bool Helper::getBestCoinCombination(unsigned int remaining, const CoinInventory& coins, unsigned int coinsOut[NUM_DENOMS])
 {
-    unsigned int sum = 0;
+    unsigned int counts[NUM_DENOMS];
     for (unsigned int i = 0; i < NUM_DENOMS; ++i)
     {
-        sum += coinsState[i];
+        counts[i] = coins[i].getCount();
     }
-    return sum;
-}
 
-void Helper::getCoinNthCombination(unsigned int remaining, const std::vector<Coin>& coinList, unsigned int coinsState[NUM_DENOMS], int index, const std::function<void(unsigned int[NUM_DENOMS])>& callback)
-{
-    const Coin& coin = coinList.at(index);
-    Denomination denom = coin.getDenom();
-    unsigned int denomValue = Helper::denomToValue(denom);
-    unsigned int perfectFit = remaining / denomValue;
-    unsigned int maxFit = std::min(perfectFit, coin.getCount());
-    
-    for (unsigned int i = 0; i <= maxFit; ++i)
-    {
-        unsigned int value = denomValue * i;
-        if (value <= remaining) {
-            unsigned int newRemaining = remaining - value;
-            coinsState[denom] = i;
-            if (index > 0) {
-                getCoinNthCombination(newRemaining, coinList, coinsState, index - 1, callback);
-            }
-            else if (newRemaining == 0)
-            {
-                callback(coinsState);
-            }
-        }
-    }       
+    //the built in denomination sets have a search compiled for their values
+    return DenominationSet::active().makeChange(remaining, counts, coinsOut);
 }
-
-std::vector<unsigned int> Helper::getBestCoinCombination(unsigned int remaining, const std::vector<Coin>& coinList)
-{
-    std::vector<unsigned int> bestCoinState;
-    bestCoinState.reserve(NUM_DENOMS);
-    unsigned int bestNumCoins = static_cast<unsigned int>(-1);
-    bool found = false;
-    unsigned int defaultState[NUM_DENOMS] = {0};
-
-    getCoinNthCombination(remaining, coinList, defaultState, coinList.size() - 1, 
-        [&](unsigned int coinsState[NUM_DENOMS])
-        {
-            unsigned int numCoins = getCoinsStateSum(coinsState);
-            if (numCoins < bestNumCoins)
-            {
-                bestCoinState = std::vector<unsigned int>(coinsState, coinsState + NUM_DENOMS);
-                bestNumCoins = numCoins;
-                found = true;
-            }
-        }
-    );
-
-    if (!found)
-    {
-        throw std::runtime_error("Cannot find coins for change");
-    }
-
-    return bestCoinState;
-}
\ No newline at end of file
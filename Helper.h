@@ -122,32 +122,43 @@ public:
     /**
      * @brief Try load the stock file into a list of Stock
      * @param fileName The directory to load from
+     * @param lazyDescriptions Whether to leave the descriptions in the file (mapped into memory) instead of copying them
      * @return List of Stock
      * @throws std::runtime_error
     */
-    static std::vector<Stock> tryLoadStockFile(const std::string& fileName);
+    static std::vector<Stock> tryLoadStockFile(const std::string& fileName, bool lazyDescriptions = false);
 
     /**
-     * @brief Try load the coin file into a list of Coin
+     * @brief Try load the coin file into a CoinInventory, the file has to have each denomination once
      * @param fileName The directory to load from
-     * @return List of Coin
+     * @return The coins indexed by Denomination
      * @throws std::runtime_error
     */
-    static std::vector<Coin> tryLoadCoinsFile(const std::string& fileName);
+    static CoinInventory tryLoadCoinsFile(const std::string& fileName);
 
     /**
-     * @brief Save the Stock list into a file
+     * @brief Save the Stock list into a file, it's written next to it then moved over it
+     * so a mapping of the old file (see tryLoadStockFile) keeps the old text
      * @param fileName The directory to save to
      * @param stockList The Stock list to save
+     * @throws std::runtime_error if the file can't be written, the old file is left as it was
     */
     static void saveStockList(const std::string& fileName, const LinkedList& stockList);
 
     /**
-     * @brief Save the Ctock list into a file
+     * @brief Save some items into a stock file, in the order they're in, the same way as the stock list
      * @param fileName The directory to save to
-     * @param stockList The Coin list to save
+     * @param items The items to save
+     * @throws std::runtime_error if the file can't be written, the old file is left as it was
     */
-    static void saveCoinList(const std::string& fileName, const std::vector<Coin>& coinList);
+    static void saveStockList(const std::string& fileName, const std::vector<Stock>& items);
+
+    /**
+     * @brief Save the coins into a file, lowest denomination first
+     * @param fileName The directory to save to
+     * @param coinList The coins to save
+    */
+    static void saveCoinList(const std::string& fileName, const CoinInventory& coinList);
 
     /**
      * @brief Try parse a string to an integer value
@@ -252,35 +263,19 @@ public:
     */
     static std::string tryParseDescription(const std::string& s);
 
-    /**
-     * @brief Get the total number of coins
-     * @param coinsState List of denomination and quantity
-     * @return The total number of coins
-    */
-    static unsigned int getCoinsStateSum(unsigned int coinsState[NUM_DENOMS]);
-
-    /**
-     * @brief
-     * @param remaining The remaining value we need to find coins for
-     * @param coinList The coin list in the vending machine (descending order?)
-     * @param coinsState The current List of denomination and quantity WHICH HAS TO BE COPIED TO PREVENT SIDE EFFECTS AGAJRGJTYJAUAKTRYJTYJATFYUAJTYRJTgj
-     * @param index The current index we are at for coin list
-     * @param callback Once we get to index=0 and remaining=0, we get a callback of the coinsState
-    */
-    static void getCoinNthCombination(unsigned int remaining, const std::vector<Coin>& coinList, unsigned int coinsState[NUM_DENOMS], int index, const std::function<void(unsigned int[NUM_DENOMS])>& callback);
-
     /**
      * @brief 
      * Go through all possible coin combinations to find the best one for the change
      * This was harder than expected.
      * No, maximum fit does not work, $1.10 with only 1x$1, 1x50c, 3x20c would have failed when it should
      * Because it will try to go for $1 then go for 10c which doesn't exist
+     * The search itself is DenominationSet::makeChange, for the denominations the machine takes
      * @param remaining The change
-     * @param coinList The coin list assumed to be sorted in descending order (or does it still work in any order?)
-     * @return definitely not a pointer because I don't want to manage that memory (gets destroyed if I don't allocate to heap)
-     * @throws std::runtime_error
+     * @param coins The coins in the vending machine
+     * @param coinsOut Set to the number of each denomination to give back (indexed by Denomination), all 0 if there's no way
+     * @return Whether the change can be made
     */
-    static std::vector<unsigned int> getBestCoinCombination(unsigned int remaining, const std::vector<Coin>& coinList);
+    static bool getBestCoinCombination(unsigned int remaining, const CoinInventory& coins, unsigned int coinsOut[NUM_DENOMS]);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "LiveState.h"
+#include <thread>
+
+LiveSnapshot::LiveSnapshot(): coinCounts{0}, hasCoin{false}, sales(0), revenue(0) {}
+
+LiveState::LiveState(): sequence(0), items(new ItemSlot[LIVE_STATE_SLOTS]), sales(0), revenue(0)
+{
+    for (unsigned int i = 0; i < LIVE_STATE_SLOTS; ++i)
+    {
+        ItemSlot& slot = items[i];
+        slot.present.store(false, std::memory_order_relaxed);
+        slot.onHand.store(0, std::memory_order_relaxed);
+        slot.price.store(0, std::memory_order_relaxed);
+        slot.sold.store(0, std::memory_order_relaxed);
+        slot.revenue.store(0, std::memory_order_relaxed);
+    }
+    for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+    {
+        coinCounts[i].store(0, std::memory_order_relaxed);
+        hasCoin[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+unsigned int LiveState::slotOf(const std::string& id)
+{
+    //ASSUMPTION: the id was already validated as I#### when it was loaded or added
+    return Stock::idToNumber(id);
+}
+
+void LiveState::beginWrite()
+{
+    //make the sequence odd before touching anything
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LiveState::endWrite()
+{
+    //make it even again, the release makes the changes visible before the new sequence
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void LiveState::setItem(const std::string& id, unsigned int onHand, unsigned int price)
+{
+    ItemSlot& slot = items[slotOf(id)];
+    slot.onHand.store(onHand, std::memory_order_relaxed);
+    slot.price.store(price, std::memory_order_relaxed);
+    slot.present.store(true, std::memory_order_relaxed);
+}
+
+void LiveState::removeItem(const std::string& id)
+{
+    ItemSlot& slot = items[slotOf(id)];
+    slot.present.store(false, std::memory_order_relaxed);
+    slot.sold.store(0, std::memory_order_relaxed);
+    slot.revenue.store(0, std::memory_order_relaxed);
+}
+
+void LiveState::clearItems()
+{
+    for (unsigned int i = 0; i < LIVE_STATE_SLOTS; ++i)
+    {
+        items[i].present.store(false, std::memory_order_relaxed);
+    }
+}
+
+void LiveState::setCoinCount(Denomination denom, unsigned int count)
+{
+    coinCounts[denom].store(count, std::memory_order_relaxed);
+    hasCoin[denom].store(true, std::memory_order_relaxed);
+}
+
+void LiveState::recordSale(const std::string& id, unsigned int price)
+{
+    //only the writer changes these so a plain load and store is enough
+    ItemSlot& slot = items[slotOf(id)];
+    slot.sold.store(slot.sold.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.revenue.store(slot.revenue.load(std::memory_order_relaxed) + price, std::memory_order_relaxed);
+    sales.store(sales.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    revenue.store(revenue.load(std::memory_order_relaxed) + price, std::memory_order_relaxed);
+}
+
+LiveSnapshot LiveState::snapshot() const
+{
+    LiveSnapshot result;
+    bool consistent = false;
+
+    while (!consistent)
+    {
+        unsigned long long before = sequence.load(std::memory_order_acquire);
+
+        //if the writer is in the middle of a change don't bother copying
+        if (before % 2 == 0)
+        {
+            result.items.clear();
+            for (unsigned int i = 0; i < LIVE_STATE_SLOTS; ++i)
+            {
+                const ItemSlot& slot = items[i];
+                if (slot.present.load(std::memory_order_relaxed))
+                {
+                    ItemSnapshot item;
+                    item.onHand = slot.onHand.load(std::memory_order_relaxed);
+                    item.price = slot.price.load(std::memory_order_relaxed);
+                    item.sold = slot.sold.load(std::memory_order_relaxed);
+                    item.revenue = slot.revenue.load(std::memory_order_relaxed);
+                    item.number = i;
+                    result.items.push_back(item);
+                }
+            }
+            for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+            {
+                result.coinCounts[i] = coinCounts[i].load(std::memory_order_relaxed);
+                result.hasCoin[i] = hasCoin[i].load(std::memory_order_relaxed);
+            }
+            result.sales = sales.load(std::memory_order_relaxed);
+            result.revenue = revenue.load(std::memory_order_relaxed);
+
+            //if the sequence didn't move the writer didn't touch anything while we copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            consistent = sequence.load(std::memory_order_relaxed) == before;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    //build the id strings outside the retry loop
+    for (ItemSnapshot& item : result.items)
+    {
+        item.id = Stock::numberToId(item.number);
+    }
+
+    return result;
+}
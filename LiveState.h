@@ -0,0 +1,138 @@
+#ifndef LIVE_STATE_H
+#define LIVE_STATE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Node.h"
+
+// the number of item slots, one for every possible item id
+#define LIVE_STATE_SLOTS (STOCK_MAX_ID + 1)
+
+/**
+ * a copy of one item's numbers
+ **/
+struct ItemSnapshot
+{
+    // the number part of the id and the whole id, e.g. 1 and I0001
+    unsigned int number;
+    std::string id;
+    unsigned int onHand;
+    unsigned int price;
+    unsigned long long sold;
+    unsigned long long revenue;
+};
+
+/**
+ * a consistent copy of the live state
+ **/
+struct LiveSnapshot
+{
+    // the items in item id order
+    std::vector<ItemSnapshot> items;
+
+    // the count of each denomination and whether the machine has that denomination at all
+    unsigned int coinCounts[NUM_DENOMS];
+    bool hasCoin[NUM_DENOMS];
+
+    // every sale since the program started, the revenue is in cents
+    unsigned long long sales;
+    unsigned long long revenue;
+
+    LiveSnapshot();
+};
+
+/**
+ * the numbers of a machine other threads want to look at (stock levels, coin counts, sales),
+ * kept in flat arrays indexed by item id and denomination.
+ * it's a seqlock: the machine's thread bumps the sequence before and after it writes,
+ * a reader copies the numbers and tries again if the sequence moved, so the machine never
+ * waits for a reader and a reader never sees half a purchase.
+ * only one thread may write
+ **/
+class LiveState
+{
+public:
+    LiveState();
+
+    LiveState(const LiveState&) = delete;
+    LiveState& operator=(const LiveState&) = delete;
+
+    /**
+     * @brief Start a group of changes, readers wait until endWrite so they see all or none of them
+    */
+    void beginWrite();
+
+    /**
+     * @brief Finish the group of changes started by beginWrite
+    */
+    void endWrite();
+
+    /**
+     * @brief Add or update an item
+     * @param id The item id, e.g. I0001
+     * @param onHand How many are on hand
+     * @param price The price in cents
+    */
+    void setItem(const std::string& id, unsigned int onHand, unsigned int price);
+
+    /**
+     * @brief Remove an item, its sales stay in the totals
+     * @param id The item id
+    */
+    void removeItem(const std::string& id);
+
+    /**
+     * @brief Remove every item
+    */
+    void clearItems();
+
+    /**
+     * @brief Set the count of a denomination
+     * @param denom The denomination
+     * @param count How many there are
+    */
+    void setCoinCount(Denomination denom, unsigned int count);
+
+    /**
+     * @brief Count a sale of an item
+     * @param id The item id
+     * @param price The price it was sold for in cents
+    */
+    void recordSale(const std::string& id, unsigned int price);
+
+    /**
+     * @brief Copy the state without blocking the writer
+     * @return The copy
+    */
+    LiveSnapshot snapshot() const;
+
+private:
+    struct ItemSlot
+    {
+        std::atomic<bool> present;
+        std::atomic<unsigned int> onHand;
+        std::atomic<unsigned int> price;
+        std::atomic<unsigned long long> sold;
+        std::atomic<unsigned long long> revenue;
+    };
+
+    // odd while the writer is in the middle of a change
+    std::atomic<unsigned long long> sequence;
+
+    std::unique_ptr<ItemSlot[]> items;
+    std::atomic<unsigned int> coinCounts[NUM_DENOMS];
+    std::atomic<bool> hasCoin[NUM_DENOMS];
+    std::atomic<unsigned long long> sales;
+    std::atomic<unsigned long long> revenue;
+
+    /**
+     * @brief Get the slot of an item id
+     * @param id The item id, e.g. I0001
+     * @return The slot index
+    */
+    static unsigned int slotOf(const std::string& id);
+};
+
+#endif // LIVE_STATE_H
@@ -0,0 +1,264 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+
+//====LATENCY HISTOGRAM=====
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+    {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+unsigned int LatencyHistogram::bucketIndex(unsigned long long value)
+{
+    unsigned int index = value;
+
+    //above the linear range, the top bit picks the power of two
+    //and the next HISTOGRAM_SUB_BUCKET_BITS bits pick the bucket inside it
+    if (value >= HISTOGRAM_LINEAR_BUCKETS)
+    {
+        unsigned int topBit = 63 - __builtin_clzll(value);
+        unsigned int shift = topBit - HISTOGRAM_SUB_BUCKET_BITS;
+        unsigned int subBucket = (value >> shift) - HISTOGRAM_SUB_BUCKETS;
+        index = HISTOGRAM_LINEAR_BUCKETS + (shift - 1) * HISTOGRAM_SUB_BUCKETS + subBucket;
+    }
+
+    return index;
+}
+
+unsigned long long LatencyHistogram::bucketUpperBound(unsigned int index)
+{
+    unsigned long long bound = index;
+
+    if (index >= HISTOGRAM_LINEAR_BUCKETS)
+    {
+        unsigned int shift = (index - HISTOGRAM_LINEAR_BUCKETS) / HISTOGRAM_SUB_BUCKETS + 1;
+        unsigned long long subBucket = (index - HISTOGRAM_LINEAR_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+        bound = ((HISTOGRAM_SUB_BUCKETS + subBucket + 1) << shift) - 1;
+    }
+
+    return bound;
+}
+
+void LatencyHistogram::record(unsigned long long nanos)
+{
+    buckets[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanos, std::memory_order_relaxed);
+
+    unsigned long long current = maxValue.load(std::memory_order_relaxed);
+    while (nanos > current && !maxValue.compare_exchange_weak(current, nanos, std::memory_order_relaxed)) {}
+}
+
+unsigned long long LatencyHistogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+unsigned long long LatencyHistogram::max() const
+{
+    return maxValue.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const
+{
+    unsigned long long n = count();
+    return n > 0 ? static_cast<double>(sum.load(std::memory_order_relaxed)) / n : 0;
+}
+
+unsigned long long LatencyHistogram::percentile(double p) const
+{
+    unsigned long long result = 0;
+    unsigned long long n = count();
+
+    if (n > 0)
+    {
+        //walk the buckets until we have seen enough values (nearest rank)
+        unsigned long long rank = static_cast<unsigned long long>(p / 100 * n + 0.999999);
+        rank = std::max(rank, 1ull);
+        unsigned long long seen = 0;
+        unsigned int i = 0;
+        for (; i < HISTOGRAM_BUCKETS && seen < rank; ++i)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+        }
+
+        //don't report more than the biggest value we actually saw
+        result = std::min(bucketUpperBound(i - 1), max());
+    }
+
+    return result;
+}
+
+//====METRICS=====
+bool Metrics::enabled = false;
+LatencyHistogram Metrics::timers[NUM_TIMERS];
+std::atomic<unsigned long long> Metrics::counters[NUM_COUNTERS];
+
+Metrics::Metrics() {}
+
+void Metrics::enable()
+{
+    enabled = true;
+}
+
+void Metrics::raise(MetricCounter counter, unsigned long long value)
+{
+    if (enabled)
+    {
+        unsigned long long current = counters[counter].load(std::memory_order_relaxed);
+        while (value > current && !counters[counter].compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+}
+
+void Metrics::record(MetricTimer timer, unsigned long long nanos)
+{
+    if (enabled)
+    {
+        timers[timer].record(nanos);
+    }
+}
+
+unsigned long long Metrics::get(MetricCounter counter)
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+const LatencyHistogram& Metrics::getTimer(MetricTimer timer)
+{
+    return timers[timer];
+}
+
+std::string Metrics::timerName(MetricTimer timer)
+{
+    static const char* const names[NUM_TIMERS] = {
+        "load", "save", "item lookup", "change", "display"
+    };
+    return names[timer];
+}
+
+std::string Metrics::counterName(MetricCounter counter)
+{
+    static const char* const names[NUM_COUNTERS] = {
+        "purchases", "cancellations", "change failures", "stockouts",
+        "combination nodes", "combination max depth", "allocations", "allocated bytes"
+    };
+    return names[counter];
+}
+
+void Metrics::print(std::ostream& os)
+{
+    int nameWidth = 16;
+    int countWidth = 9;
+    int numWidth = 11;
+    char horizontalSep = '-';
+    char verticalSep = '|';
+    double micro = 1000;
+    std::string title = "Metrics Summary";
+
+    os << title << std::endl;
+    os << std::string(title.length(), horizontalSep) << std::endl;
+    if (!enabled)
+    {
+        os << "Metrics are turned off, run with --metrics to turn them on" << std::endl;
+    }
+
+    //latencies are printed in microseconds
+    os << std::left << std::setw(nameWidth) << "Timer" << verticalSep << std::right << std::setw(countWidth) << "Count"
+       << verticalSep << std::setw(numWidth) << "Mean us" << verticalSep << std::setw(numWidth) << "p50 us"
+       << verticalSep << std::setw(numWidth) << "p99 us" << verticalSep << std::setw(numWidth) << "p999 us"
+       << verticalSep << std::setw(numWidth) << "Max us" << std::endl;
+    os << std::string(nameWidth + countWidth + 5 * numWidth + 6, horizontalSep) << std::endl;
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(2);
+    for (unsigned int i = 0; i < NUM_TIMERS; ++i)
+    {
+        const LatencyHistogram& histogram = timers[i];
+        os << std::left << std::setw(nameWidth) << timerName(static_cast<MetricTimer>(i)) << verticalSep << std::right << std::setw(countWidth) << histogram.count()
+           << verticalSep << std::setw(numWidth) << histogram.mean() / micro
+           << verticalSep << std::setw(numWidth) << histogram.percentile(50) / micro
+           << verticalSep << std::setw(numWidth) << histogram.percentile(99) / micro
+           << verticalSep << std::setw(numWidth) << histogram.percentile(99.9) / micro
+           << verticalSep << std::setw(numWidth) << histogram.max() / micro << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os << std::endl;
+
+    int counterWidth = 22;
+    int valueWidth = 14;
+    os << std::left << std::setw(counterWidth) << "Counter" << verticalSep << std::right << std::setw(valueWidth) << "Value" << std::endl;
+    os << std::string(counterWidth + valueWidth + 1, horizontalSep) << std::endl;
+    for (unsigned int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        os << std::left << std::setw(counterWidth) << counterName(static_cast<MetricCounter>(i)) << verticalSep << std::right << std::setw(valueWidth) << get(static_cast<MetricCounter>(i)) << std::endl;
+    }
+    os << std::endl;
+}
+
+void Metrics::dump(const std::string& fileName)
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+    print(file);
+    file.close();
+}
+
+//====SCOPED TIMER=====
+ScopedTimer::ScopedTimer(MetricTimer timer): timer(timer), running(Metrics::isEnabled())
+{
+    //don't even read the clock when the metrics are off
+    if (running)
+    {
+        startTime = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (running)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        Metrics::record(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+}
+
+//====ALLOCATION COUNTING=====
+//replacing the global operator new lets us count every allocation in the program
+void* operator new(std::size_t size)
+{
+    Metrics::add(COUNTER_ALLOCATIONS);
+    Metrics::add(COUNTER_ALLOCATED_BYTES, size);
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
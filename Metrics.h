@@ -0,0 +1,195 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// the first HISTOGRAM_LINEAR_BUCKETS values get a bucket each, after that every power
+// of two is split into HISTOGRAM_SUB_BUCKETS buckets, so the error is at most 1/16
+#define HISTOGRAM_LINEAR_BUCKETS 32
+#define HISTOGRAM_SUB_BUCKETS 16
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_BUCKETS 1024
+
+// the operations that get timed
+enum MetricTimer
+{
+    TIMER_LOAD, TIMER_SAVE, TIMER_ITEM_LOOKUP, TIMER_CHANGE, TIMER_DISPLAY
+};
+
+// the number of timers
+#define NUM_TIMERS 5
+
+// the things that get counted
+enum MetricCounter
+{
+    COUNTER_PURCHASES, COUNTER_CANCELLATIONS, COUNTER_CHANGE_FAILURES, COUNTER_STOCKOUTS,
+    COUNTER_COMBINATION_NODES, COUNTER_COMBINATION_MAX_DEPTH, COUNTER_ALLOCATIONS, COUNTER_ALLOCATED_BYTES
+};
+
+// the number of counters
+#define NUM_COUNTERS 8
+
+/**
+ * a HDR style latency histogram with log-linear buckets.
+ * recording is a couple of shifts and one relaxed atomic add, so it is safe to
+ * share between threads and never allocates
+ **/
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    /**
+     * @brief Record one value
+     * @param nanos The latency in nanoseconds
+    */
+    void record(unsigned long long nanos);
+
+    /**
+     * @brief Forget everything recorded so far
+    */
+    void reset();
+
+    unsigned long long count() const;
+    unsigned long long max() const;
+    double mean() const;
+
+    /**
+     * @brief Get a percentile of the recorded values (the upper end of the bucket it falls in)
+     * @param p The percentile between 0 and 100
+     * @return The latency in nanoseconds
+    */
+    unsigned long long percentile(double p) const;
+
+    /**
+     * @brief Get the bucket a value goes into
+     * @param value The value
+     * @return The bucket index
+    */
+    static unsigned int bucketIndex(unsigned long long value);
+
+    /**
+     * @brief Get the largest value that goes into a bucket
+     * @param index The bucket index
+     * @return The largest value of the bucket
+    */
+    static unsigned long long bucketUpperBound(unsigned int index);
+
+private:
+    std::atomic<unsigned long long> buckets[HISTOGRAM_BUCKETS];
+    std::atomic<unsigned long long> total;
+    std::atomic<unsigned long long> sum;
+    std::atomic<unsigned long long> maxValue;
+};
+
+/**
+ * the built in instrumentation: a latency histogram per timer and the counters.
+ * everything is off until enable() is called, when off a timer or counter is a single branch
+ **/
+class Metrics
+{
+private:
+    Metrics();
+
+    static bool enabled;
+    static LatencyHistogram timers[NUM_TIMERS];
+    static std::atomic<unsigned long long> counters[NUM_COUNTERS];
+
+public:
+    /**
+     * @brief Turn on the instrumentation
+    */
+    static void enable();
+
+    /**
+     * @brief Get whether the instrumentation is turned on
+     * @return Whether it is on
+    */
+    static bool isEnabled()
+    {
+        return enabled;
+    }
+
+    /**
+     * @brief Add to a counter if the instrumentation is on
+     * @param counter The counter
+     * @param amount How much to add
+    */
+    static void add(MetricCounter counter, unsigned long long amount = 1)
+    {
+        if (enabled)
+        {
+            counters[counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Raise a counter to a value if the value is bigger (used for maximums)
+     * @param counter The counter
+     * @param value The value
+    */
+    static void raise(MetricCounter counter, unsigned long long value);
+
+    /**
+     * @brief Record a latency if the instrumentation is on
+     * @param timer The timer
+     * @param nanos The latency in nanoseconds
+    */
+    static void record(MetricTimer timer, unsigned long long nanos);
+
+    /**
+     * @brief Get the value of a counter
+     * @param counter The counter
+     * @return The value
+    */
+    static unsigned long long get(MetricCounter counter);
+
+    /**
+     * @brief Get the histogram of a timer
+     * @param timer The timer
+     * @return The histogram
+    */
+    static const LatencyHistogram& getTimer(MetricTimer timer);
+
+    /**
+     * @brief Get the name of a timer, e.g. "item lookup"
+    */
+    static std::string timerName(MetricTimer timer);
+
+    /**
+     * @brief Get the name of a counter, e.g. "change failures"
+    */
+    static std::string counterName(MetricCounter counter);
+
+    /**
+     * @brief Print the timers and counters in tables
+     * @param os Where to print them
+    */
+    static void print(std::ostream& os);
+
+    /**
+     * @brief Print the timers and counters into a file
+     * @param fileName The file to write
+    */
+    static void dump(const std::string& fileName);
+};
+
+/**
+ * times the scope it lives in and records it on a timer when it goes out of scope
+ **/
+class ScopedTimer
+{
+public:
+    ScopedTimer(MetricTimer timer);
+    ~ScopedTimer();
+
+private:
+    MetricTimer timer;
+    bool running;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,157 @@
+#include "MetricsExporter.h"
+#include "Helper.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+MetricsExporter::MetricsExporter(const LiveState& state, const std::string& fileName, unsigned int intervalMs):
+    state(state), fileName(fileName), intervalMs(intervalMs), stopping(false) {}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+void MetricsExporter::start()
+{
+    if (!thread.joinable())
+    {
+        stopping = false;
+        thread = std::thread(&MetricsExporter::run, this);
+    }
+}
+
+void MetricsExporter::stop()
+{
+    if (thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(stopLock);
+            stopping = true;
+        }
+        stopRequested.notify_one();
+        thread.join();
+    }
+}
+
+void MetricsExporter::run()
+{
+    std::unique_lock<std::mutex> lock(stopLock);
+    bool exit = false;
+
+    while (!exit)
+    {
+        //write outside the lock so stop() never waits for the disk
+        lock.unlock();
+        try {
+            writeFile();
+        }
+        catch(const std::runtime_error& e) {
+            std::cerr << ERROR_PREFIX << e.what() << ERROR_POSTFIX << std::endl;
+        }
+        lock.lock();
+
+        //the last write happens after stop() was called, so the file has the final state
+        exit = stopping;
+        if (!exit)
+        {
+            stopRequested.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]{ return stopping; });
+        }
+    }
+}
+
+void MetricsExporter::writeFile() const
+{
+    std::string tempFileName = fileName + ".tmp";
+    std::ofstream file;
+    file.open(tempFileName, std::fstream::out | std::fstream::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not write the metrics file " + tempFileName);
+    }
+    print(state, file);
+    file.close();
+
+    if (std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+    {
+        throw std::runtime_error("Could not replace the metrics file " + fileName);
+    }
+}
+
+// print the HELP and TYPE lines of a metric
+static void printHeader(std::ostream& os, const std::string& name, const std::string& help, const std::string& type)
+{
+    os << "# HELP " << name << " " << help << std::endl;
+    os << "# TYPE " << name << " " << type << std::endl;
+}
+
+void MetricsExporter::print(const LiveState& state, std::ostream& os)
+{
+    LiveSnapshot snapshot = state.snapshot();
+    double nanosPerSecond = 1e9;
+    double centsPerDollar = ONE_DOLLAR_VAL;
+
+    printHeader(os, "ppd_item_on_hand", "Number of the item on hand.", "gauge");
+    for (const ItemSnapshot& item : snapshot.items) {
+        os << "ppd_item_on_hand{item=\"" << item.id << "\"} " << item.onHand << std::endl;
+    }
+    printHeader(os, "ppd_item_price_dollars", "Price of the item.", "gauge");
+    for (const ItemSnapshot& item : snapshot.items) {
+        os << "ppd_item_price_dollars{item=\"" << item.id << "\"} " << item.price / centsPerDollar << std::endl;
+    }
+    printHeader(os, "ppd_item_sales_total", "Number of the item sold.", "counter");
+    for (const ItemSnapshot& item : snapshot.items) {
+        os << "ppd_item_sales_total{item=\"" << item.id << "\"} " << item.sold << std::endl;
+    }
+    printHeader(os, "ppd_item_revenue_dollars_total", "Money taken for the item.", "counter");
+    for (const ItemSnapshot& item : snapshot.items) {
+        os << "ppd_item_revenue_dollars_total{item=\"" << item.id << "\"} " << item.revenue / centsPerDollar << std::endl;
+    }
+
+    printHeader(os, "ppd_coins", "Number of coins/notes of the denomination in the machine.", "gauge");
+    for (unsigned int i = 0; i < NUM_DENOMS; ++i)
+    {
+        if (snapshot.hasCoin[i]) {
+            os << "ppd_coins{denomination=\"" << Helper::denomToValue(static_cast<Denomination>(i)) << "\"} " << snapshot.coinCounts[i] << std::endl;
+        }
+    }
+
+    printHeader(os, "ppd_sales_total", "Number of items sold.", "counter");
+    os << "ppd_sales_total " << snapshot.sales << std::endl;
+    printHeader(os, "ppd_revenue_dollars_total", "Money taken for items.", "counter");
+    os << "ppd_revenue_dollars_total " << snapshot.revenue / centsPerDollar << std::endl;
+
+    //the counters, "change failures" becomes ppd_change_failures_total
+    for (unsigned int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        MetricCounter counter = static_cast<MetricCounter>(i);
+        std::string name = "ppd_" + Metrics::counterName(counter);
+        std::replace(name.begin(), name.end(), ' ', '_');
+        std::string type = "counter";
+        if (counter == COUNTER_COMBINATION_MAX_DEPTH) {
+            type = "gauge";
+        }
+        else {
+            name += "_total";
+        }
+        printHeader(os, name, "The " + Metrics::counterName(counter) + " counter.", type);
+        os << name << " " << Metrics::get(counter) << std::endl;
+    }
+
+    //the timers as summaries in seconds
+    std::string latency = "ppd_operation_latency_seconds";
+    printHeader(os, latency, "Latency of the operation.", "summary");
+    double quantiles[] = {0.5, 0.99, 0.999};
+    for (unsigned int i = 0; i < NUM_TIMERS; ++i)
+    {
+        MetricTimer timer = static_cast<MetricTimer>(i);
+        const LatencyHistogram& histogram = Metrics::getTimer(timer);
+        std::string label = "operation=\"" + Metrics::timerName(timer) + "\"";
+        for (double quantile : quantiles) {
+            os << latency << "{" << label << ",quantile=\"" << quantile << "\"} " << histogram.percentile(quantile * 100) / nanosPerSecond << std::endl;
+        }
+        os << latency << "_sum{" << label << "} " << histogram.mean() * histogram.count() / nanosPerSecond << std::endl;
+        os << latency << "_count{" << label << "} " << histogram.count() << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "LiveState.h"
+#include "Metrics.h"
+
+// how often the exposition file gets rewritten by default
+#define EXPORTER_DEFAULT_INTERVAL_MS 5000
+
+/**
+ * writes the live state and the metrics to a file in the Prometheus text format
+ * on a background thread, so a local agent can scrape it.
+ * the file is written next to itself then renamed over, so a scraper never reads half a file
+ **/
+class MetricsExporter
+{
+public:
+    /**
+     * @param state The live state of the machine, must outlive the exporter
+     * @param fileName The file to write
+     * @param intervalMs How long to wait between writes
+    */
+    MetricsExporter(const LiveState& state, const std::string& fileName, unsigned int intervalMs = EXPORTER_DEFAULT_INTERVAL_MS);
+
+    // stops the thread (writing the file one last time)
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Start writing the file in the background
+    */
+    void start();
+
+    /**
+     * @brief Stop the background thread and write the file one last time
+    */
+    void stop();
+
+    /**
+     * @brief Write the file now
+     * @throws std::runtime_error
+    */
+    void writeFile() const;
+
+    /**
+     * @brief Print the live state and the metrics in the Prometheus text format
+     * @param state The live state
+     * @param os Where to print them
+    */
+    static void print(const LiveState& state, std::ostream& os);
+
+private:
+    const LiveState& state;
+    std::string fileName;
+    unsigned int intervalMs;
+
+    std::thread thread;
+    std::mutex stopLock;
+    std::condition_variable stopRequested;
+    bool stopping;
+
+    // the body of the background thread
+    void run();
+};
+
+#endif // METRICS_EXPORTER_H
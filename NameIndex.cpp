@@ -0,0 +1,241 @@
+#include "NameIndex.h"
+#include <algorithm>
+#include "Helper.h"
+
+NameIndex::TrieNode::TrieNode(): count(0) {}
+
+NameIndex::NameIndex()
+{
+    clear();
+}
+
+void NameIndex::clear()
+{
+    nodes.clear();
+    nodes.push_back(TrieNode());
+    entries.clear();
+}
+
+std::vector<std::string> NameIndex::getKeys(const std::string& name)
+{
+    std::string folded = Helper::stringLower(Helper::stringTrim(name));
+    std::vector<std::string> keys;
+    keys.push_back(folded);
+
+    //everything from the start of each word after the first one
+    for (unsigned int i = 1; i < folded.length(); ++i)
+    {
+        if (folded[i - 1] == ' ' && folded[i] != ' ')
+        {
+            std::string key = folded.substr(i);
+            if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            {
+                keys.push_back(key);
+            }
+        }
+    }
+
+    return keys;
+}
+
+void NameIndex::insert(const Stock& stock)
+{
+    //an item that is already in here gets moved to its new spot
+    remove(stock.getId());
+
+    Entry entry{&stock, getKeys(stock.getName())};
+    for (const std::string& key : entry.keys)
+    {
+        unsigned int node = 0;
+        ++nodes[node].count;
+        for (char letter : key)
+        {
+            std::map<char, unsigned int>::const_iterator child = nodes[node].children.find(letter);
+            if (child == nodes[node].children.end())
+            {
+                //push_back can move the nodes, so don't hold a reference across it
+                nodes.push_back(TrieNode());
+                nodes[node].children[letter] = nodes.size() - 1;
+                node = nodes.size() - 1;
+            }
+            else
+            {
+                node = child->second;
+            }
+            ++nodes[node].count;
+        }
+        nodes[node].items.push_back(&stock);
+    }
+    entries[stock.getId()] = entry;
+}
+
+void NameIndex::remove(const std::string& itemId)
+{
+    std::unordered_map<std::string, Entry>::iterator found = entries.find(itemId);
+    if (found != entries.end())
+    {
+        //walk each key down again, the stock itself might be gone already so only its address is used
+        const Stock* stock = found->second.stock;
+        for (const std::string& key : found->second.keys)
+        {
+            unsigned int node = 0;
+            --nodes[node].count;
+            for (char letter : key)
+            {
+                node = nodes[node].children.at(letter);
+                --nodes[node].count;
+            }
+            std::vector<const Stock*>& items = nodes[node].items;
+            items.erase(std::find(items.begin(), items.end(), stock));
+        }
+        entries.erase(found);
+    }
+}
+
+unsigned int NameIndex::size() const
+{
+    return entries.size();
+}
+
+void NameIndex::collect(unsigned int node, std::vector<const Stock*>& results) const
+{
+    const TrieNode& trieNode = nodes[node];
+    results.insert(results.end(), trieNode.items.begin(), trieNode.items.end());
+    for (const std::pair<const char, unsigned int>& child : trieNode.children)
+    {
+        if (nodes[child.second].count > 0)
+        {
+            collect(child.second, results);
+        }
+    }
+}
+
+void NameIndex::sortByName(std::vector<const Stock*>& results)
+{
+    std::sort(results.begin(), results.end());
+    results.erase(std::unique(results.begin(), results.end()), results.end());
+
+    //the same order as the stock list, folding each name once instead of on every comparison
+    std::vector<std::pair<std::string, const Stock*>> byName;
+    byName.reserve(results.size());
+    for (const Stock* stock : results)
+    {
+        byName.push_back(std::make_pair(Helper::stringLower(stock->getName()), stock));
+    }
+    std::stable_sort(byName.begin(), byName.end(), [](const std::pair<std::string, const Stock*>& a, const std::pair<std::string, const Stock*>& b){
+        return a.first < b.first;
+    });
+    for (unsigned int i = 0; i < byName.size(); ++i)
+    {
+        results[i] = byName[i].second;
+    }
+}
+
+std::vector<const Stock*> NameIndex::findPrefix(const std::string& prefix) const
+{
+    std::vector<const Stock*> results;
+    std::string folded = Helper::stringLower(prefix);
+
+    //follow the prefix down, then everything below it matches
+    unsigned int node = 0;
+    bool found = true;
+    for (unsigned int i = 0; i < folded.length() && found; ++i)
+    {
+        std::map<char, unsigned int>::const_iterator child = nodes[node].children.find(folded[i]);
+        found = child != nodes[node].children.end();
+        if (found)
+        {
+            node = child->second;
+        }
+    }
+
+    if (found)
+    {
+        collect(node, results);
+        sortByName(results);
+    }
+
+    return results;
+}
+
+void NameIndex::searchFuzzy(unsigned int node, char letter, const std::string& query, const std::vector<unsigned int>& previousRow,
+    unsigned int maxTypos, std::vector<const Stock*>& results) const
+{
+    //row[i] is the edit distance between the first i letters of the query and the path to this node
+    std::vector<unsigned int> row(query.length() + 1);
+    row[0] = previousRow[0] + 1;
+    unsigned int rowMin = row[0];
+    for (unsigned int i = 1; i <= query.length(); ++i)
+    {
+        unsigned int substitute = previousRow[i - 1] + (query[i - 1] == letter ? 0 : 1);
+        row[i] = std::min(std::min(row[i - 1] + 1, previousRow[i] + 1), substitute);
+        rowMin = std::min(rowMin, row[i]);
+    }
+
+    if (row[query.length()] <= maxTypos)
+    {
+        //the path is close enough to the whole query, so every name below it starts close enough
+        collect(node, results);
+    }
+    else if (rowMin <= maxTypos)
+    {
+        //a longer path could still get close enough
+        for (const std::pair<const char, unsigned int>& child : nodes[node].children)
+        {
+            if (nodes[child.second].count > 0)
+            {
+                searchFuzzy(child.second, child.first, query, row, maxTypos, results);
+            }
+        }
+    }
+}
+
+std::vector<const Stock*> NameIndex::findFuzzy(const std::string& query, unsigned int maxTypos) const
+{
+    std::vector<const Stock*> results;
+    std::string folded = Helper::stringLower(query);
+
+    //the root's row is just deleting the letters of the query
+    std::vector<unsigned int> row(folded.length() + 1);
+    for (unsigned int i = 0; i <= folded.length(); ++i)
+    {
+        row[i] = i;
+    }
+
+    if (folded.length() <= maxTypos)
+    {
+        collect(0, results);
+    }
+    else
+    {
+        for (const std::pair<const char, unsigned int>& child : nodes[0].children)
+        {
+            if (nodes[child.second].count > 0)
+            {
+                searchFuzzy(child.second, child.first, folded, row, maxTypos, results);
+            }
+        }
+    }
+    sortByName(results);
+
+    return results;
+}
+
+unsigned int NameIndex::typosAllowed(unsigned int length)
+{
+    return std::min(length / NAME_SEARCH_CHARS_PER_TYPO, static_cast<unsigned int>(NAME_SEARCH_MAX_TYPOS));
+}
+
+std::vector<const Stock*> NameIndex::search(const std::string& query, unsigned int& typosUsed) const
+{
+    std::vector<const Stock*> results = findPrefix(query);
+    typosUsed = 0;
+
+    if (results.empty() && typosAllowed(query.length()) > 0)
+    {
+        typosUsed = typosAllowed(query.length());
+        results = findFuzzy(query, typosUsed);
+    }
+
+    return results;
+}
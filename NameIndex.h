@@ -0,0 +1,140 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Node.h"
+
+// a search gets one typo for every this many characters typed in
+#define NAME_SEARCH_CHARS_PER_TYPO 4
+
+// the most typos a search tolerates
+#define NAME_SEARCH_MAX_TYPOS 2
+
+/**
+ * a case folded trie over the item names for searching by name.
+ * every word of a name is a key too, so "pie" finds "Meat Pie" as well as "Pie Floater".
+ * the items are pointed to, not copied, so every item in the index has to stay in the
+ * stock list until it is removed from the index
+ **/
+class NameIndex
+{
+public:
+    NameIndex();
+
+    /**
+     * @brief Forget every item
+    */
+    void clear();
+
+    /**
+     * @brief Add an item under its name and each word of its name
+     * @param stock The item, must stay where it is until it is removed
+    */
+    void insert(const Stock& stock);
+
+    /**
+     * @brief Remove an item, it doesn't have to still exist
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Get the number of items in the index
+     * @return Number of items
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Find the items with a name (or a word of it) that starts with a prefix
+     * Only walks the prefix and the part of the trie below it
+     * @param prefix What the name starts with, any case
+     * @return The items in ascending order of name
+    */
+    std::vector<const Stock*> findPrefix(const std::string& prefix) const;
+
+    /**
+     * @brief Find the items with a name (or a word of it) that starts with something within maxTypos edits of the query
+     * Walks the trie with a row of the edit distance table per node and skips every branch
+     * that is already more than maxTypos edits away
+     * @param query What the name starts with, any case
+     * @param maxTypos The most insertions, deletions and substitutions allowed
+     * @return The items in ascending order of name
+    */
+    std::vector<const Stock*> findFuzzy(const std::string& query, unsigned int maxTypos) const;
+
+    /**
+     * @brief Find by prefix, and if nothing starts with the query try again allowing typos
+     * @param query What the customer typed in
+     * @param typosUsed Set to the number of typos allowed to find the results
+     * @return The items in ascending order of name
+    */
+    std::vector<const Stock*> search(const std::string& query, unsigned int& typosUsed) const;
+
+    /**
+     * @brief Get how many typos a query of some length tolerates
+     * @param length The length of the query
+     * @return The number of typos
+    */
+    static unsigned int typosAllowed(unsigned int length);
+
+    /**
+     * @brief Remove duplicates (an item can match under several keys) and sort by name like the stock list
+     * @param results The items
+    */
+    static void sortByName(std::vector<const Stock*>& results);
+
+private:
+    // a node of the trie, children are kept in order so results come out sorted
+    struct TrieNode
+    {
+        std::map<char, unsigned int> children;
+        std::vector<const Stock*> items;
+
+        // the number of items ending in this node or below it, so emptied branches get skipped
+        unsigned int count;
+
+        TrieNode();
+    };
+
+    // an item in the index and the folded keys it was added under
+    struct Entry
+    {
+        const Stock* stock;
+        std::vector<std::string> keys;
+    };
+
+    // nodes[0] is the root, nodes are never freed (they get reused when an item with the same name comes back)
+    std::vector<TrieNode> nodes;
+    std::unordered_map<std::string, Entry> entries;
+
+    /**
+     * @brief Get the keys a name is indexed under: the whole name folded, then from the start of each word
+     * @param name The item name
+     * @return The keys
+    */
+    static std::vector<std::string> getKeys(const std::string& name);
+
+    /**
+     * @brief Collect every item in a node and below it
+     * @param node The node index
+     * @param results Where the items get added
+    */
+    void collect(unsigned int node, std::vector<const Stock*>& results) const;
+
+    /**
+     * @brief The recursive part of findFuzzy, works out the row for a child then goes into it
+     * @param node The node index
+     * @param letter The letter on the edge into the node
+     * @param query The folded query
+     * @param previousRow The row of the parent node
+     * @param maxTypos The most edits allowed
+     * @param results Where the items get added
+    */
+    void searchFuzzy(unsigned int node, char letter, const std::string& query, const std::vector<unsigned int>& previousRow,
+        unsigned int maxTypos, std::vector<const Stock*>& results) const;
+};
+
+#endif // NAME_INDEX_H
@@ -2,7 +2,7 @@
 #include <iostream>
 
 //====PRICE=====
-Price::Price(): dollars(0), cents(0) {};
+Price::Price(): value(0) {};
 
 Price::Price(unsigned int dollars, unsigned int cents) {
     //check that number of cents cannot still be converted to a dollar
@@ -10,24 +10,53 @@ Price::Price(unsigned int dollars, unsigned int cents) {
     {
         throw std::runtime_error("Cents cant be >= 100 for Price");
     }
-    this->dollars = dollars;
-    this->cents = cents;
+    value = ONE_DOLLAR_VAL * dollars + cents;
 };
 
-unsigned int Price::getDollars() const { return dollars; }
-unsigned int Price::getCents() const { return cents; }
-unsigned int Price::getValue() const { return  ONE_DOLLAR_VAL * dollars + cents; }
+Price Price::fromValue(unsigned int value)
+{
+    Price price;
+    price.value = value;
+    return price;
+}
+
+unsigned int Price::getDollars() const { return value / ONE_DOLLAR_VAL; }
+unsigned int Price::getCents() const { return value % ONE_DOLLAR_VAL; }
+unsigned int Price::getValue() const { return value; }
 
 std::string Price::getString(bool includeSign) const
 {
     //get the string of the price, wehre we can choose to include the dollar sign or not
-    //ASSUMPTION: we didn't modify cents to be 100 or larger else where
-    std::string result = "";
+    char buffer[PRICE_STRING_LEN];
+    std::size_t length = format(buffer, includeSign);
+    return std::string(buffer, length);
+}
+
+std::size_t Price::format(char* buffer, bool includeSign) const
+{
+    //the digits go in backwards from the end of a scratch buffer: 2 cents digits, the dot, then the dollars
+    char digits[PRICE_STRING_LEN];
+    std::size_t start = PRICE_STRING_LEN;
+    unsigned int cents = getCents();
+    unsigned int dollars = getDollars();
+    digits[--start] = '0' + cents % TEN_CENTS_VAL;
+    digits[--start] = '0' + cents / TEN_CENTS_VAL;
+    digits[--start] = '.';
+    do {
+        digits[--start] = '0' + dollars % 10;
+        dollars /= 10;
+    } while (dollars > 0);
+
+    std::size_t length = 0;
     if (includeSign) {
-        result += "$ "; 
+        buffer[length++] = '$';
+        buffer[length++] = ' ';
     }
-    result += std::to_string(dollars) + "." + ((cents < TEN_CENTS_VAL) ? "0" : "") + std::to_string(cents);
-    return result;
+    for (std::size_t i = start; i < PRICE_STRING_LEN; ++i) {
+        buffer[length++] = digits[i];
+    }
+    buffer[length] = '\0';
+    return length;
 }
 
 std::ostream& operator <<(std::ostream& os, const Price& price)
@@ -37,15 +66,12 @@ std::ostream& operator <<(std::ostream& os, const Price& price)
 }
 
 //====STOCK=====
-Stock::Stock(): id("I0000"), name(""), description(""), price(Price()), on_hand(DEFAULT_STOCK_LEVEL) {};
-Stock::Stock(const std::string& id, const std::string& n, const std::string& d, const Price& p, unsigned int h):
-    id(id), name(n), description(d), price(p), on_hand(h) {};
-
-std::string Stock::getId() const { return id; }
-std::string Stock::getName() const { return name; }
-std::string Stock::getDescription() const { return description; }
+// the record has to stay small, see the comment on Stock
+static_assert(sizeof(Stock) < 32, "Stock should fit in less than 32 bytes");
 
-std::string Stock::getShortDescription() const {
+// shorten a description for the purchase messages: the start and the end with an ellipsis in between
+static std::string shortenDescription(const std::string& description)
+{
     //check if the description string is long enough to be shorted
     //if it is, then shorten it
     std::string result = "";
@@ -59,7 +85,49 @@ std::string Stock::getShortDescription() const {
     }
     return result;
 }
-Price Stock::getPrice() const { return price; }
+
+// intern the text of a price, prices repeat a lot so most items share theirs
+static ArenaString internPrice(const Price& price)
+{
+    char buffer[PRICE_STRING_LEN];
+    std::size_t length = price.format(buffer);
+    return StringArena::catalog().intern(std::string(buffer, length));
+}
+
+Stock::Stock(): id(0), price(0), on_hand(DEFAULT_STOCK_LEVEL), name(ArenaString()), description(ArenaString()), shortDescription(ArenaString()),
+    priceString(ArenaString()) {};
+Stock::Stock(const std::string& id, const std::string& n, const std::string& d, const Price& p, unsigned int h):
+    id(idToNumber(id)), price(p.getValue()), on_hand(h), name(StringArena::catalog().intern(n)),
+    description(StringArena::catalog().intern(d)), shortDescription(StringArena::catalog().intern(shortenDescription(d))),
+    priceString(internPrice(p)) {};
+Stock::Stock(const std::string& id, const std::string& n, const ArenaString& d, const Price& p, unsigned int h):
+    id(idToNumber(id)), price(p.getValue()), on_hand(h), name(StringArena::catalog().intern(n)),
+    description(d), shortDescription(ArenaString()), priceString(internPrice(p)) {};
+
+std::string Stock::getId() const { return numberToId(id); }
+unsigned int Stock::getNumber() const { return id; }
+std::string Stock::getName() const { return name.str(); }
+std::string Stock::getDescription() const { return description.str(); }
+ArenaString Stock::getShortDescription() const
+{
+    //a description that wasn't read in when the item was made gets shortened the first time
+    if (shortDescription.empty() && !description.empty())
+    {
+        shortDescription = StringArena::catalog().intern(shortenDescription(description.str()));
+    }
+    return shortDescription;
+}
+Price Stock::getPrice() const { return Price::fromValue(price); }
+
+ArenaString Stock::getPriceString() const
+{
+    //only a default made item doesn't have it yet
+    if (priceString.empty())
+    {
+        priceString = internPrice(getPrice());
+    }
+    return priceString;
+}
 unsigned int Stock::getOnHand() const { return on_hand; }
 
 void Stock::setOnHand(unsigned int numHand) {
@@ -76,6 +144,30 @@ void Stock::removeOnHand(unsigned int amount)
     on_hand -= amount;
 }
 
+unsigned int Stock::idToNumber(const std::string& itemId)
+{
+    //skip the prefix, the rest is digits
+    unsigned int number = 0;
+    for (std::size_t i = 1; i < itemId.length(); ++i)
+    {
+        number = number * 10 + (itemId[i] - '0');
+    }
+    return number;
+}
+
+std::string Stock::numberToId(unsigned int number)
+{
+    //the prefix then the number padded with zeros, built in place
+    std::string itemId(IDLEN, '0');
+    itemId[0] = STOCK_ID_PREFIX;
+    for (std::size_t i = IDLEN - 1; i > 0 && number > 0; --i)
+    {
+        itemId[i] = '0' + number % 10;
+        number /= 10;
+    }
+    return itemId;
+}
+
 std::ostream& operator<<(std::ostream& os, const Stock& stock)
 {
     os << "Stock(" << stock.getId() << "," << stock.getName() << "," << stock.getShortDescription() << "," << stock.getPrice() << "," << stock.getOnHand() << ")";
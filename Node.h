@@ -1,7 +1,9 @@
 #ifndef NODE_H
 #define NODE_H
+#include <cstdint>
 #include <string> 
 #include "Coin.h"
+#include "StringArena.h"
 
 //the id range for stock
 #define STOCK_MIN_ID 1
@@ -40,8 +42,8 @@
 //The default stock level that all new stock should start at and that we should reset to on restock
 #define DEFAULT_STOCK_LEVEL 20
 
-//The number of denominations of currency available in the system 
-#define NUM_DENOMS 8
+//room for the longest price Price::format writes (e.g. "$ 42949672.95") and its null
+#define PRICE_STRING_LEN 16
 
 /**
  * a structure to represent a price. One of the problems with the floating
@@ -52,58 +54,102 @@
 class Price
 {
 public:
-    // The dollar value, and the cents value for some price
-    unsigned dollars, cents;
+    // The price in cents, the dollars and cents are worked out from it
+    unsigned value;
 
     //constructors and destructors
     Price();
     Price(unsigned int dollars, unsigned int cents);
 
+    /**
+     * @brief Make a price from a number of cents
+     * @param value The price in cents
+     * @return The price
+    */
+    static Price fromValue(unsigned int value);
+
     //getters and setters
     unsigned int getDollars() const;
     unsigned int getCents() const;
     unsigned int getValue() const;
     std::string getString(bool includeSign = true) const;
 
+    /**
+     * @brief Write the price as text into a buffer without allocating anything, the same text as getString
+     * @param buffer Where to write it, at least PRICE_STRING_LEN characters
+     * @param includeSign Whether to start with "$ "
+     * @return The number of characters written, not counting the null at the end
+    */
+    std::size_t format(char* buffer, bool includeSign = true) const;
+
     //lets us std::cout this object, just for debugging
     friend std::ostream& operator<<(std::ostream& os, const Price& stock);
 };
 
 /**
- * data structure to represent a stock item within the system
+ * data structure to represent a stock item within the system.
+ * it's kept small (28 bytes) so a lot of them fit in the cache: the id is just its number,
+ * the price is in cents and the text is in StringArena::catalog(). the id and price only get
+ * turned into text when they are printed or saved
  **/
 class Stock
 {
 public:
-    //the unique id for this item
-    std::string id;
+    //the number part of the unique id for this item, e.g. 1 for I0001
+    uint16_t id;
 
-    //the name of this item
-    std::string name;
-    
-    //the description of this item   
-    std::string description;
-    
-    //the price of this item
-    Price price;
+    //the price of this item in cents
+    uint32_t price;
     
     // how many of this item do we have on hand? 
-    unsigned on_hand;    
+    uint32_t on_hand;
+
+    //the name of this item
+    ArenaString name;
+    
+    //the description of this item, it can be external (still in the stock file) when descriptions are loaded lazily
+    ArenaString description;
+
+    //the description shortened for the purchase messages, worked out once when the item is made
+    //or the first time it's asked for if the description is external
+    mutable ArenaString shortDescription;
+
+    //the price as text with its sign, worked out when the item is made
+    mutable ArenaString priceString;
 
     //constructors and destructors
     Stock();
     Stock(const std::string& id, const std::string& n, const std::string& d, const Price& p, unsigned int h);
 
+    // the description is used as it is, e.g. an external string pointing into the stock file
+    Stock(const std::string& id, const std::string& n, const ArenaString& d, const Price& p, unsigned int h);
+
     //getter and setters
     std::string getId() const;
+    unsigned int getNumber() const;
     std::string getName() const;
     std::string getDescription() const;
-    std::string getShortDescription() const;
+    ArenaString getShortDescription() const;
     Price getPrice() const;
+    ArenaString getPriceString() const;
     unsigned int getOnHand() const;
     void setOnHand(unsigned int numHand);
     void removeOnHand(unsigned int amount);
     
+    /**
+     * @brief Get the number part of an item id, e.g. 1 for I0001
+     * @param itemId The id, already checked to be I####
+     * @return The number
+    */
+    static unsigned int idToNumber(const std::string& itemId);
+
+    /**
+     * @brief Make the item id for a number, e.g. I0001 for 1
+     * @param number The number
+     * @return The id
+    */
+    static std::string numberToId(unsigned int number);
+
     //lets us std::cout this object, just for debugging
     friend std::ostream& operator<<(std::ostream& os, const Stock& stock);
 
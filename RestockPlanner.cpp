@@ -0,0 +1,161 @@
+#include "RestockPlanner.h"
+#include "Helper.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+RestockPlanner::RestockPlanner(): observedSince(now()) {}
+
+double RestockPlanner::now()
+{
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(sinceEpoch).count();
+}
+
+void RestockPlanner::recordSale(const std::string& id, double time)
+{
+    //decay the old sales to now then add this one
+    double windowSeconds = RESTOCK_RATE_WINDOW_HOURS * SECONDS_PER_HOUR;
+    auto found = rates.find(id);
+    if (found == rates.end())
+    {
+        rates[id] = SalesRate{1, time};
+    }
+    else
+    {
+        SalesRate& rate = found->second;
+        double elapsed = std::max(0.0, time - rate.lastSale);
+        rate.weight = rate.weight * std::exp(-elapsed / windowSeconds) + 1;
+        rate.lastSale = std::max(rate.lastSale, time);
+    }
+}
+
+void RestockPlanner::removeItem(const std::string& id)
+{
+    rates.erase(id);
+}
+
+double RestockPlanner::getExposureHours(double time) const
+{
+    //the weights of every hour watched, a full window once the planner has watched for a long time
+    double observedHours = std::max(0.0, time - observedSince) / SECONDS_PER_HOUR;
+    double exposure = RESTOCK_RATE_WINDOW_HOURS * (1 - std::exp(-observedHours / RESTOCK_RATE_WINDOW_HOURS));
+    return std::max(RESTOCK_MIN_HISTORY_HOURS, exposure);
+}
+
+double RestockPlanner::getRate(const std::string& id, double time) const
+{
+    double result = 0;
+    auto found = rates.find(id);
+    if (found != rates.end())
+    {
+        //the weight is how many sales happened in about the last window, or since the planner started watching
+        double windowSeconds = RESTOCK_RATE_WINDOW_HOURS * SECONDS_PER_HOUR;
+        double elapsed = std::max(0.0, time - found->second.lastSale);
+        result = found->second.weight * std::exp(-elapsed / windowSeconds) / getExposureHours(time);
+    }
+    return result;
+}
+
+double RestockPlanner::getObservedSince() const
+{
+    return observedSince;
+}
+
+RestockAdvice RestockPlanner::advise(const Stock& stock, double time) const
+{
+    RestockAdvice advice;
+    advice.id = stock.getId();
+    advice.onHand = stock.getOnHand();
+    advice.rate = getRate(advice.id, time);
+    advice.hoursToStockout = advice.rate > 0 ? advice.onHand / advice.rate : -1;
+
+    //an item that hasn't sold over the whole time watched has a rate of 0, which is history too
+    double observedHours = (time - observedSince) / SECONDS_PER_HOUR;
+    advice.hasHistory = observedHours >= RESTOCK_MIN_HISTORY_HOURS;
+
+    //enough to last until the next restock with some to spare, a rate without enough history behind it can only add
+    double needed = std::ceil(advice.rate * RESTOCK_COVER_HOURS * RESTOCK_SAFETY_FACTOR);
+    advice.level = std::min<double>(RESTOCK_MAX_LEVEL, std::max<double>(RESTOCK_MIN_LEVEL, needed));
+    if (!advice.hasHistory)
+    {
+        advice.level = std::max<unsigned int>(DEFAULT_STOCK_LEVEL, advice.level);
+    }
+    advice.toAdd = advice.level > advice.onHand ? advice.level - advice.onHand : 0;
+
+    return advice;
+}
+
+std::vector<RestockAdvice> RestockPlanner::plan(const LinkedList& stockList, double time) const
+{
+    std::vector<RestockAdvice> advice;
+    stockList.forEach([&](const Stock& stock){
+        advice.push_back(advise(stock, time));
+    });
+
+    //the items that run out first come first, the ones that never run out go last
+    std::stable_sort(advice.begin(), advice.end(), [](const RestockAdvice& a, const RestockAdvice& b){
+        bool aRunsOut = a.hoursToStockout >= 0;
+        bool bRunsOut = b.hoursToStockout >= 0;
+        return aRunsOut != bRunsOut ? aRunsOut : a.hoursToStockout < b.hoursToStockout;
+    });
+
+    return advice;
+}
+
+std::string RestockPlanner::fileFor(const std::string& stockFile)
+{
+    return stockFile + RESTOCK_FILE_SUFFIX;
+}
+
+void RestockPlanner::load(const std::string& fileName)
+{
+    rates.clear();
+    observedSince = now();
+    std::ifstream fileStream(fileName);
+
+    //no file yet means nothing has sold yet
+    if (fileStream)
+    {
+        std::string line;
+        int lineCounter = 0;
+        while (std::getline(fileStream, line) && !line.empty())
+        {
+            lineCounter += 1;
+            std::vector<std::string> fields = Helper::splitStringAndTrim(line, STOCK_DELIM);
+            try {
+                if (fields.size() == 2 && fields[0] == RESTOCK_SINCE_LINE && Helper::isNumber(fields[1]))
+                {
+                    observedSince = std::stod(fields[1]);
+                }
+                //some files have a sales count after the time, the rate doesn't need it
+                else if ((fields.size() != 3 && fields.size() != 4) || !Helper::isNumber(fields[1]) || !Helper::isNumber(fields[2]))
+                {
+                    throw std::runtime_error("Needs an item id, a weight and a time");
+                }
+                else
+                {
+                    rates[Helper::tryParseItemId(fields[0])] = SalesRate{std::stod(fields[1]), std::stod(fields[2])};
+                }
+            }
+            catch(const std::runtime_error& e) {
+                throw std::runtime_error("Restock line No. " + std::to_string(lineCounter) + " failed, " + std::string(e.what()));
+            }
+        }
+    }
+}
+
+void RestockPlanner::save(const std::string& fileName) const
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+    file << std::fixed << std::setprecision(6);
+    file << RESTOCK_SINCE_LINE << STOCK_DELIM << observedSince << std::endl;
+    for (const auto& rate : rates)
+    {
+        file << rate.first << STOCK_DELIM << rate.second.weight << STOCK_DELIM << rate.second.lastSale << std::endl;
+    }
+    file.close();
+}
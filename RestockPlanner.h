@@ -0,0 +1,155 @@
+#ifndef RESTOCK_PLANNER_H
+#define RESTOCK_PLANNER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LinkedList.h"
+
+// how far back the sales rate looks, a sale this long ago counts 1/e as much as one now
+#define RESTOCK_RATE_WINDOW_HOURS 72.0
+
+// how long the stock should last until the next restock, and the extra on top for bad luck
+#define RESTOCK_COVER_HOURS 48.0
+#define RESTOCK_SAFETY_FACTOR 1.25
+
+// the lowest and highest level the planner recommends for an item, even one that hasn't sold
+#define RESTOCK_MIN_LEVEL 2
+#define RESTOCK_MAX_LEVEL 60
+
+// how long the planner has to have watched before a rate is trusted enough to recommend less than
+// DEFAULT_STOCK_LEVEL, sold or not. a rate is never worked out over less time than this either
+#define RESTOCK_MIN_HISTORY_HOURS 24.0
+
+// the first word of the line in the planner file with when the planner started watching
+#define RESTOCK_SINCE_LINE "SINCE"
+
+// the file the planner is saved to is the stock file with this on the end
+#define RESTOCK_FILE_SUFFIX ".restock"
+
+#define SECONDS_PER_HOUR 3600.0
+
+/**
+ * the planner's view of one item
+ **/
+struct RestockAdvice
+{
+    std::string id;
+    unsigned int onHand;
+
+    // the estimated sales per hour, 0 if it never sold
+    double rate;
+
+    // hours until it runs out at that rate, negative if it never will
+    double hoursToStockout;
+
+    // the level to restock it to, and how many that adds
+    unsigned int level;
+    unsigned int toAdd;
+
+    // whether the planner has watched long enough to trust the rate, if not the item gets at least DEFAULT_STOCK_LEVEL
+    bool hasHistory;
+};
+
+/**
+ * estimates how fast each item sells with an exponentially weighted rate, updated on
+ * every sale in O(1), and recommends restock levels from it so fast sellers get more
+ * and slow sellers get less than DEFAULT_STOCK_LEVEL. the sales are divided by the weighted
+ * time the planner has been watching, so a new planner doesn't take one sale for a slow seller
+ **/
+class RestockPlanner
+{
+public:
+    RestockPlanner();
+
+    /**
+     * @brief Get the current time in seconds since the epoch
+     * @return The time
+    */
+    static double now();
+
+    /**
+     * @brief Count a sale of an item
+     * @param id The item id
+     * @param time When it sold in seconds since the epoch
+    */
+    void recordSale(const std::string& id, double time = now());
+
+    /**
+     * @brief Forget an item that was removed from the menu
+     * @param id The item id
+    */
+    void removeItem(const std::string& id);
+
+    /**
+     * @brief Get the estimated sales per hour of an item
+     * @param id The item id
+     * @param time The time to estimate it at
+     * @return The sales per hour, 0 if it never sold
+    */
+    double getRate(const std::string& id, double time = now()) const;
+
+    /**
+     * @brief Work out the advice for an item
+     * @param stock The item
+     * @param time The time to work it out at
+     * @return The advice
+    */
+    RestockAdvice advise(const Stock& stock, double time = now()) const;
+
+    /**
+     * @brief Work out the advice for every item, the ones running out first come first
+     * @param stockList The items
+     * @param time The time to work it out at
+     * @return The advice
+    */
+    std::vector<RestockAdvice> plan(const LinkedList& stockList, double time = now()) const;
+
+    /**
+     * @brief Get the file the planner of a stock file is saved to
+     * @param stockFile The stock file
+     * @return The planner file
+    */
+    static std::string fileFor(const std::string& stockFile);
+
+    /**
+     * @brief Get when the planner started watching the sales
+     * @return The time in seconds since the epoch
+    */
+    double getObservedSince() const;
+
+    /**
+     * @brief Load the sales rates, a file that doesn't exist yet means nothing has sold and the planner starts watching now
+     * @param fileName The planner file
+     * @throws std::runtime_error
+    */
+    void load(const std::string& fileName);
+
+    /**
+     * @brief Save the sales rates
+     * @param fileName The planner file
+    */
+    void save(const std::string& fileName) const;
+
+private:
+    // the weighted number of sales as of the last sale, it decays by e every window
+    struct SalesRate
+    {
+        double weight;
+        double lastSale;
+    };
+
+    std::unordered_map<std::string, SalesRate> rates;
+
+    // when the planner started watching, in seconds since the epoch
+    double observedSince;
+
+    /**
+     * @brief Get the hours of watching the sales are divided by, each hour weighted like a sale at that time
+     * @param time The time to work it out at
+     * @return The hours, at least RESTOCK_MIN_HISTORY_HOURS
+    */
+    double getExposureHours(double time) const;
+};
+
+#endif // RESTOCK_PLANNER_H
@@ -0,0 +1,269 @@
+#include "SalesAnalytics.h"
+#include "Helper.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+//====HOURLY RING=====
+HourlyRing::HourlyRing(): newestHour(0)
+{
+    buckets.fill(0);
+}
+
+void HourlyRing::add(long long hour, unsigned long long amount)
+{
+    //clear the slots of the hours we skipped, at most the whole ring
+    if (hour > newestHour)
+    {
+        long long from = std::max(newestHour + 1, hour - ANALYTICS_HOURS + 1);
+        for (long long h = from; h <= hour; ++h)
+        {
+            buckets[h % ANALYTICS_HOURS] = 0;
+        }
+        newestHour = hour;
+    }
+
+    if (hour > newestHour - ANALYTICS_HOURS)
+    {
+        buckets[hour % ANALYTICS_HOURS] += amount;
+    }
+}
+
+unsigned long long HourlyRing::get(long long hour) const
+{
+    unsigned long long value = 0;
+    if (hour <= newestHour && hour > newestHour - ANALYTICS_HOURS)
+    {
+        value = buckets[hour % ANALYTICS_HOURS];
+    }
+    return value;
+}
+
+std::string HourlyRing::toString(long long hour) const
+{
+    std::string result = "";
+    for (long long h = hour - ANALYTICS_HOURS + 1; h <= hour; ++h)
+    {
+        result += std::to_string(get(h)) + (h < hour ? DELIM : "");
+    }
+    return result;
+}
+
+void HourlyRing::fromString(const std::string& s, long long hour)
+{
+    std::vector<std::string> values = Helper::splitStringAndTrim(s, DELIM);
+    if (values.size() != ANALYTICS_HOURS)
+    {
+        throw std::runtime_error("Needs " + std::to_string(ANALYTICS_HOURS) + " hourly values");
+    }
+
+    buckets.fill(0);
+    newestHour = hour;
+    for (unsigned int i = 0; i < ANALYTICS_HOURS; ++i)
+    {
+        if (values[i].find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw std::runtime_error("Hourly values need to be whole numbers");
+        }
+        buckets[(hour - ANALYTICS_HOURS + 1 + i) % ANALYTICS_HOURS] = std::stoull(values[i]);
+    }
+}
+
+//====SALES ANALYTICS=====
+SalesAnalytics::SalesAnalytics(): totalSales(0), totalRevenue(0), latestHour(currentHour()) {}
+
+long long SalesAnalytics::currentHour()
+{
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::hours>(sinceEpoch).count();
+}
+
+void SalesAnalytics::recordSale(const std::string& id, unsigned int price, long long hour)
+{
+    ItemSales& item = items[id];
+    item.sold += 1;
+    item.revenue += price;
+    item.hourly.add(hour, 1);
+
+    totalSales += 1;
+    totalRevenue += price;
+    hourlySales.add(hour, 1);
+    hourlyRevenue.add(hour, price);
+    latestHour = std::max(latestHour, hour);
+
+    updateTop(id);
+}
+
+void SalesAnalytics::updateTop(const std::string& id)
+{
+    //a sale only adds 1 so the item can only pass the items just above it,
+    //and an item outside the best sellers gets in by passing the last one
+    unsigned long long sold = items[id].sold;
+    auto found = std::find(top.begin(), top.end(), id);
+    unsigned int pos = found - top.begin();
+
+    if (found == top.end())
+    {
+        if (top.size() < ANALYTICS_TOP_N)
+        {
+            top.push_back(id);
+            pos = top.size() - 1;
+        }
+        else if (sold > items[top.back()].sold)
+        {
+            top.back() = id;
+            pos = top.size() - 1;
+        }
+    }
+
+    //bubble it up past everything it now beats
+    while (pos < top.size() && pos > 0 && items[top[pos - 1]].sold < sold)
+    {
+        std::swap(top[pos - 1], top[pos]);
+        --pos;
+    }
+}
+
+void SalesAnalytics::rebuildTop()
+{
+    std::vector<std::string> ids;
+    for (const auto& item : items)
+    {
+        ids.push_back(item.first);
+    }
+
+    //only the first ANALYTICS_TOP_N need to be in order, ties go to the smaller id
+    unsigned int count = std::min<std::size_t>(ANALYTICS_TOP_N, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + count, ids.end(), [this](const std::string& a, const std::string& b){
+        unsigned long long soldA = items.at(a).sold;
+        unsigned long long soldB = items.at(b).sold;
+        return soldA > soldB || (soldA == soldB && a < b);
+    });
+    top.assign(ids.begin(), ids.begin() + count);
+}
+
+void SalesAnalytics::removeItem(const std::string& id)
+{
+    if (items.erase(id) > 0 && std::find(top.begin(), top.end(), id) != top.end())
+    {
+        rebuildTop();
+    }
+}
+
+std::vector<TopSeller> SalesAnalytics::getTopSellers() const
+{
+    std::vector<TopSeller> result;
+    for (const std::string& id : top)
+    {
+        result.push_back(getItem(id));
+    }
+    return result;
+}
+
+TopSeller SalesAnalytics::getItem(const std::string& id) const
+{
+    TopSeller result = {id, 0, 0};
+    auto found = items.find(id);
+    if (found != items.end())
+    {
+        result.sold = found->second.sold;
+        result.revenue = found->second.revenue;
+    }
+    return result;
+}
+
+unsigned long long SalesAnalytics::getTotalSales() const { return totalSales; }
+unsigned long long SalesAnalytics::getTotalRevenue() const { return totalRevenue; }
+unsigned long long SalesAnalytics::getHourlySales(long long hour) const { return hourlySales.get(hour); }
+unsigned long long SalesAnalytics::getHourlyRevenue(long long hour) const { return hourlyRevenue.get(hour); }
+
+unsigned long long SalesAnalytics::getItemHourlySales(const std::string& id, long long hour) const
+{
+    auto found = items.find(id);
+    return found == items.end() ? 0 : found->second.hourly.get(hour);
+}
+
+std::string SalesAnalytics::fileFor(const std::string& stockFile)
+{
+    return stockFile + ANALYTICS_FILE_SUFFIX;
+}
+
+void SalesAnalytics::load(const std::string& fileName)
+{
+    items.clear();
+    top.clear();
+    totalSales = 0;
+    totalRevenue = 0;
+    hourlySales = HourlyRing();
+    hourlyRevenue = HourlyRing();
+    latestHour = currentHour();
+
+    std::ifstream fileStream(fileName);
+
+    //no file yet means nothing has sold yet
+    if (fileStream)
+    {
+        std::string line;
+        int lineCounter = 0;
+        long long fileHour = 0;
+
+        while (std::getline(fileStream, line) && !line.empty())
+        {
+            lineCounter += 1;
+            std::vector<std::string> fields = Helper::splitStringAndTrim(line, STOCK_DELIM);
+
+            try {
+                if (fields.size() == 2 && fields[0] == ANALYTICS_HOUR_LINE)
+                {
+                    fileHour = std::stoll(fields[1]);
+                    latestHour = std::max(latestHour, fileHour);
+                }
+                else if (fields.size() == 5 && fields[0] == ANALYTICS_TOTAL_LINE)
+                {
+                    totalSales = std::stoull(fields[1]);
+                    totalRevenue = std::stoull(fields[2]);
+                    hourlySales.fromString(fields[3], fileHour);
+                    hourlyRevenue.fromString(fields[4], fileHour);
+                }
+                else if (fields.size() == 4)
+                {
+                    ItemSales& item = items[Helper::tryParseItemId(fields[0])];
+                    item.sold = std::stoull(fields[1]);
+                    item.revenue = std::stoull(fields[2]);
+                    item.hourly.fromString(fields[3], fileHour);
+                }
+                else
+                {
+                    throw std::runtime_error("Not a valid analytics line");
+                }
+            }
+            catch(const std::logic_error& e) {
+                //std::stoull throws these
+                throw std::runtime_error("Sales line No. " + std::to_string(lineCounter) + " failed, Needs to be whole numbers");
+            }
+            catch(const std::runtime_error& e) {
+                throw std::runtime_error("Sales line No. " + std::to_string(lineCounter) + " failed, " + std::string(e.what()));
+            }
+        }
+
+        rebuildTop();
+    }
+}
+
+void SalesAnalytics::save(const std::string& fileName) const
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+
+    //the hourly values of every line end at the same hour
+    file << ANALYTICS_HOUR_LINE << STOCK_DELIM << latestHour << std::endl;
+    file << ANALYTICS_TOTAL_LINE << STOCK_DELIM << totalSales << STOCK_DELIM << totalRevenue << STOCK_DELIM
+         << hourlySales.toString(latestHour) << STOCK_DELIM << hourlyRevenue.toString(latestHour) << std::endl;
+    for (const auto& item : items)
+    {
+        file << item.first << STOCK_DELIM << item.second.sold << STOCK_DELIM << item.second.revenue << STOCK_DELIM
+             << item.second.hourly.toString(latestHour) << std::endl;
+    }
+
+    file.close();
+}
@@ -0,0 +1,189 @@
+#ifndef SALES_ANALYTICS_H
+#define SALES_ANALYTICS_H
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// how many hours the hourly series go back
+#define ANALYTICS_HOURS 24
+
+// how many best sellers are kept
+#define ANALYTICS_TOP_N 10
+
+// the file the analytics are saved to is the stock file with this on the end
+#define ANALYTICS_FILE_SUFFIX ".sales"
+
+// the first word of the lines in the analytics file that aren't items
+#define ANALYTICS_HOUR_LINE "HOUR"
+#define ANALYTICS_TOTAL_LINE "TOTAL"
+
+/**
+ * a value per hour for the last ANALYTICS_HOURS hours in a fixed size ring,
+ * hours are counted from the epoch and slots are cleared as time moves past them
+ **/
+class HourlyRing
+{
+public:
+    HourlyRing();
+
+    /**
+     * @brief Add to the value of an hour, moving the ring forward if the hour is newer
+     * @param hour The hour, ignored if it fell out of the ring already
+     * @param amount How much to add
+    */
+    void add(long long hour, unsigned long long amount);
+
+    /**
+     * @brief Get the value of an hour
+     * @param hour The hour
+     * @return The value, 0 if the hour isn't in the ring
+    */
+    unsigned long long get(long long hour) const;
+
+    /**
+     * @brief Get the values of the ANALYTICS_HOURS hours up to an hour, oldest first, separated by commas
+     * @param hour The newest hour
+     * @return The values
+    */
+    std::string toString(long long hour) const;
+
+    /**
+     * @brief Set the ring from values written by toString
+     * @param s The values
+     * @param hour The newest hour they were written with
+     * @throws std::runtime_error
+    */
+    void fromString(const std::string& s, long long hour);
+
+private:
+    std::array<unsigned long long, ANALYTICS_HOURS> buckets;
+    long long newestHour;
+};
+
+/**
+ * a best seller
+ **/
+struct TopSeller
+{
+    std::string id;
+    unsigned long long sold;
+    unsigned long long revenue;
+};
+
+/**
+ * counts the sales and revenue (in cents) of each item, keeps hourly series of them and
+ * the best sellers. the best sellers are kept in order as sales come in (a sale can only move
+ * its item up), so getting them never sorts the catalog
+ **/
+class SalesAnalytics
+{
+public:
+    SalesAnalytics();
+
+    /**
+     * @brief Get the current hour counted from the epoch
+     * @return The hour
+    */
+    static long long currentHour();
+
+    /**
+     * @brief Count a sale
+     * @param id The item id
+     * @param price The price it was sold for in cents
+     * @param hour The hour it was sold in
+    */
+    void recordSale(const std::string& id, unsigned int price, long long hour = currentHour());
+
+    /**
+     * @brief Forget an item that was removed from the menu
+     * @param id The item id
+    */
+    void removeItem(const std::string& id);
+
+    /**
+     * @brief Get the best sellers, best first
+     * @return Up to ANALYTICS_TOP_N items
+    */
+    std::vector<TopSeller> getTopSellers() const;
+
+    /**
+     * @brief Get the number sold and revenue of an item
+     * @param id The item id
+     * @return The item's numbers (0 if it never sold)
+    */
+    TopSeller getItem(const std::string& id) const;
+
+    unsigned long long getTotalSales() const;
+    unsigned long long getTotalRevenue() const;
+
+    /**
+     * @brief Get the sales or revenue of an hour
+     * @param hour The hour
+     * @return The number of items sold, or the revenue in cents
+    */
+    unsigned long long getHourlySales(long long hour) const;
+    unsigned long long getHourlyRevenue(long long hour) const;
+
+    /**
+     * @brief Get the number of items sold in an hour
+     * @param id The item id
+     * @param hour The hour
+     * @return The number sold
+    */
+    unsigned long long getItemHourlySales(const std::string& id, long long hour) const;
+
+    /**
+     * @brief Get the file the analytics of a stock file are saved to
+     * @param stockFile The stock file
+     * @return The analytics file
+    */
+    static std::string fileFor(const std::string& stockFile);
+
+    /**
+     * @brief Load the analytics, a file that doesn't exist yet means nothing has sold
+     * @param fileName The analytics file
+     * @throws std::runtime_error
+    */
+    void load(const std::string& fileName);
+
+    /**
+     * @brief Save the analytics
+     * @param fileName The analytics file
+    */
+    void save(const std::string& fileName) const;
+
+private:
+    struct ItemSales
+    {
+        unsigned long long sold = 0;
+        unsigned long long revenue = 0;
+        HourlyRing hourly;
+    };
+
+    std::unordered_map<std::string, ItemSales> items;
+    unsigned long long totalSales;
+    unsigned long long totalRevenue;
+    HourlyRing hourlySales;
+    HourlyRing hourlyRevenue;
+
+    // the newest hour anything was recorded in, the rings are saved up to it
+    long long latestHour;
+
+    // the ids of the best sellers, best first
+    std::vector<std::string> top;
+
+    /**
+     * @brief Move an item that just sold up the best sellers (or into them)
+     * @param id The item id
+    */
+    void updateTop(const std::string& id);
+
+    /**
+     * @brief Work out the best sellers from scratch, for after loading or removing one
+    */
+    void rebuildTop();
+};
+
+#endif // SALES_ANALYTICS_H
@@ -0,0 +1,215 @@
+#include "Session.h"
+#include "Helper.h"
+#include "Console.h"
+#include <chrono>
+#include <thread>
+
+// wait a bit when nothing had input, yielding at first and sleeping once it has gone on a while,
+// so waiting for a slow source doesn't keep a cpu busy. idlePolls counts the waits in a row
+static void waitIdle(unsigned int& idlePolls)
+{
+    ++idlePolls;
+    if (idlePolls < SESSION_IDLE_SPINS)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SESSION_IDLE_SLEEP_MS));
+    }
+}
+
+//====INPUT SOURCES=====
+InputSource::~InputSource() {}
+
+InputStatus ConsoleInput::readLine(std::string& line)
+{
+    //same as getUserInputPersistent, reaching EOF terminates even if we got some characters
+    line = Helper::readInput();
+    return Console::eof() ? INPUT_END : INPUT_READY;
+}
+
+ScriptInput::ScriptInput(): nextLine(0) {}
+ScriptInput::ScriptInput(const std::vector<std::string>& lines): lines(lines), nextLine(0) {}
+
+void ScriptInput::push(const std::string& line)
+{
+    lines.push_back(line);
+}
+
+unsigned int ScriptInput::getConsumed() const
+{
+    return nextLine;
+}
+
+InputStatus ScriptInput::readLine(std::string& line)
+{
+    InputStatus status = INPUT_END;
+    if (nextLine < lines.size())
+    {
+        line = lines[nextLine];
+        ++nextLine;
+        status = INPUT_READY;
+    }
+    return status;
+}
+
+//====SESSION=====
+Session::Session(std::ostream& out): out(out), finished(false) {}
+Session::~Session() {}
+
+void Session::start()
+{
+    onStart();
+}
+
+bool Session::isFinished() const
+{
+    return finished;
+}
+
+void Session::finish()
+{
+    finished = true;
+}
+
+void Session::printPrompt()
+{
+    out << getPrompt();
+}
+
+void Session::input(const std::string& line)
+{
+    //Return on empty input terminates the session
+    if (line.empty())
+    {
+        onTerminate();
+        finish();
+    }
+    else
+    {
+        //trim the string before handing it to the current state
+        try
+        {
+            onInput(Helper::stringTrim(line));
+        }
+        catch(const std::runtime_error& e)
+        {
+            //if the input was invalid, print the error message and stay in the same state
+            out << ERROR_PREFIX << e.what() << ERROR_POSTFIX << std::endl;
+        }
+    }
+}
+
+void Session::end()
+{
+    //this is just to make the output more bareable to look at
+    out << std::endl;
+    onTerminate();
+    finish();
+}
+
+void Session::run(InputSource& source)
+{
+    start();
+
+    //only prompt again if the last read actually gave us something
+    bool needPrompt = true;
+    unsigned int idlePolls = 0;
+    std::string line;
+    while (!finished)
+    {
+        if (needPrompt)
+        {
+            printPrompt();
+        }
+
+        InputStatus status = source.readLine(line);
+        needPrompt = status != INPUT_PENDING;
+        if (status == INPUT_READY)
+        {
+            input(line);
+        }
+        else if (status == INPUT_END)
+        {
+            end();
+        }
+
+        if (status == INPUT_PENDING)
+        {
+            waitIdle(idlePolls);
+        }
+        else
+        {
+            idlePolls = 0;
+        }
+    }
+}
+
+//====SESSION SCHEDULER=====
+SessionScheduler::SessionScheduler() {}
+
+void SessionScheduler::add(std::unique_ptr<Session> session, InputSource& source)
+{
+    session->start();
+    if (!session->isFinished())
+    {
+        session->printPrompt();
+        entries.push_back(Entry{std::move(session), &source});
+    }
+}
+
+unsigned int SessionScheduler::poll()
+{
+    unsigned int stepped = 0;
+    std::string line;
+
+    //give each session at most one line so a busy source can't starve the others
+    for (Entry& entry : entries)
+    {
+        InputStatus status = entry.source->readLine(line);
+        if (status == INPUT_READY)
+        {
+            entry.session->input(line);
+            ++stepped;
+        }
+        else if (status == INPUT_END)
+        {
+            entry.session->end();
+            ++stepped;
+        }
+
+        if (status != INPUT_PENDING && !entry.session->isFinished())
+        {
+            entry.session->printPrompt();
+        }
+    }
+
+    //drop the sessions that have finished
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& entry){
+        return entry.session->isFinished();
+    }), entries.end());
+
+    return stepped;
+}
+
+void SessionScheduler::runAll()
+{
+    unsigned int idlePolls = 0;
+    while (!entries.empty())
+    {
+        if (poll() == 0)
+        {
+            waitIdle(idlePolls);
+        }
+        else
+        {
+            idlePolls = 0;
+        }
+    }
+}
+
+unsigned int SessionScheduler::activeCount() const
+{
+    return entries.size();
+}
@@ -0,0 +1,202 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+// how many times in a row nothing can have input before the loops waiting for it start to sleep,
+// and how long they sleep each time after that
+#define SESSION_IDLE_SPINS 64
+#define SESSION_IDLE_SLEEP_MS 1
+
+// the state of an input source after trying to read a line from it
+enum InputStatus
+{
+    INPUT_READY, INPUT_PENDING, INPUT_END
+};
+
+/**
+ * a source of lines for a session, e.g. the console, a replay script or a socket.
+ * sources that can't produce a line straight away return INPUT_PENDING
+ * so that a single thread can keep driving the other sessions
+ **/
+class InputSource
+{
+public:
+    virtual ~InputSource();
+
+    /**
+     * @brief Try to read the next line from the source
+     * @param line Where the line gets stored if one is ready
+     * @return INPUT_READY if a line was read, INPUT_PENDING if there is no line yet, INPUT_END on EOF
+    */
+    virtual InputStatus readLine(std::string& line) = 0;
+};
+
+/**
+ * blocking input source reading from the console (stdin), this is the normal console UI
+ **/
+class ConsoleInput : public InputSource
+{
+public:
+    InputStatus readLine(std::string& line) override;
+};
+
+/**
+ * input source that hands out a list of lines that was prepared beforehand
+ **/
+class ScriptInput : public InputSource
+{
+public:
+    ScriptInput();
+    ScriptInput(const std::vector<std::string>& lines);
+
+    /**
+     * @brief Add another line to the end of the script
+     * @param line The line to add
+    */
+    void push(const std::string& line);
+
+    /**
+     * @brief Get how many lines have been handed out so far
+     * @return Number of lines read
+    */
+    unsigned int getConsumed() const;
+
+    InputStatus readLine(std::string& line) override;
+
+private:
+    // the lines to hand out and the index of the next one
+    std::vector<std::string> lines;
+    unsigned int nextLine;
+};
+
+/**
+ * a resumable prompt driven flow (purchase, add item, remove item...)
+ * instead of blocking on std::cin, the session waits in a state until it is given
+ * the next line of input, so the caller decides where the input comes from
+ **/
+class Session
+{
+public:
+    Session(std::ostream& out);
+    virtual ~Session();
+
+    /**
+     * @brief Print the opening messages and move to the first state waiting for input
+    */
+    void start();
+
+    /**
+     * @brief Get whether the session has finished (completed or terminated)
+     * @return Whether the session has finished
+    */
+    bool isFinished() const;
+
+    /**
+     * @brief Print the prompt for the state we are waiting in
+    */
+    void printPrompt();
+
+    /**
+     * @brief
+     * Give the session the next line of input
+     * An empty line terminates the session, invalid input prints an error and keeps the same state
+     * @param line The line of input
+    */
+    void input(const std::string& line);
+
+    /**
+     * @brief Terminate the session because the input source reached EOF
+    */
+    void end();
+
+    /**
+     * @brief Keep driving the session from an input source until it finishes
+     * @param source The blocking input source to read from
+    */
+    void run(InputSource& source);
+
+protected:
+    // where all the messages of the session get written to
+    std::ostream& out;
+
+    /**
+     * @brief Print the opening messages, finish() can be called if there is nothing to prompt for
+    */
+    virtual void onStart() = 0;
+
+    /**
+     * @brief Get the prompt for the current state
+     * @return The prompt
+    */
+    virtual std::string getPrompt() const = 0;
+
+    /**
+     * @brief Handle a trimmed non empty line of input for the current state
+     * @param s The line of input
+     * @throws std::runtime_error if the input is not valid for the current state
+    */
+    virtual void onInput(const std::string& s) = 0;
+
+    /**
+     * @brief Handle the user terminating the session with ^D or Enter
+    */
+    virtual void onTerminate() = 0;
+
+    /**
+     * @brief Mark the session as finished
+    */
+    void finish();
+
+private:
+    bool finished;
+};
+
+/**
+ * drives many sessions from their own input sources on a single thread.
+ * each call to poll() gives every session that has a line ready one step
+ **/
+class SessionScheduler
+{
+public:
+    SessionScheduler();
+
+    /**
+     * @brief Start a session and add it to the scheduler
+     * @param session The session to drive, the scheduler takes ownership
+     * @param source The input source of the session, must outlive the session
+    */
+    void add(std::unique_ptr<Session> session, InputSource& source);
+
+    /**
+     * @brief Step every session that has input ready and drop the finished ones
+     * @return Number of sessions that consumed input
+    */
+    unsigned int poll();
+
+    /**
+     * @brief Keep polling until every session has finished, sleeping a little while no source has input
+    */
+    void runAll();
+
+    /**
+     * @brief Get the number of sessions that have not finished
+     * @return Number of active sessions
+    */
+    unsigned int activeCount() const;
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<Session> session;
+        InputSource* source;
+    };
+
+    std::vector<Entry> entries;
+};
+
+#endif // SESSION_H
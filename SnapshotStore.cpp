@@ -0,0 +1,205 @@
+#include "SnapshotStore.h"
+#include "Helper.h"
+#include <atomic>
+
+SnapshotStore::SnapshotStore(): live(std::make_shared<Version>()), rowOf(STOCK_MAX_ID + 1, -1), chunksCopied(0),
+    pendingCounters(nullptr), writing(false), stopping(false), savesWritten(0)
+{
+    live->count = 0;
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    if (thread.joinable())
+    {
+        //the thread writes whatever is still waiting before it stops
+        {
+            std::lock_guard<std::mutex> guard(saveLock);
+            stopping = true;
+        }
+        saveChanged.notify_all();
+        thread.join();
+    }
+}
+
+SnapshotStore::Version& SnapshotStore::writableVersion()
+{
+    //only this thread adds references to a version, so if it looks unshared it is. the acquire makes
+    //sure the background thread is done reading anything it let go of
+    if (live.use_count() > 1)
+    {
+        live = std::make_shared<Version>(*live);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return *live;
+}
+
+Stock& SnapshotStore::writableRow(unsigned int row)
+{
+    std::shared_ptr<Chunk>& chunk = writableVersion().chunks[row / SNAPSHOT_CHUNK_ITEMS];
+    if (chunk.use_count() > 1)
+    {
+        chunk = std::make_shared<Chunk>(*chunk);
+        chunksCopied++;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return chunk->items[row % SNAPSHOT_CHUNK_ITEMS];
+}
+
+void SnapshotStore::clear()
+{
+    //a snapshot being written keeps the old version
+    live = std::make_shared<Version>();
+    live->count = 0;
+    std::fill(rowOf.begin(), rowOf.end(), -1);
+}
+
+void SnapshotStore::insert(const Stock& stock)
+{
+    Version& version = writableVersion();
+    if (version.count == version.chunks.size() * SNAPSHOT_CHUNK_ITEMS)
+    {
+        version.chunks.push_back(std::make_shared<Chunk>());
+    }
+
+    unsigned int row = version.count;
+    version.count++;
+    writableRow(row) = stock;
+    rowOf[stock.getNumber()] = row;
+}
+
+void SnapshotStore::update(const Stock& stock)
+{
+    writableRow(rowOf[stock.getNumber()]) = stock;
+}
+
+void SnapshotStore::remove(const std::string& itemId)
+{
+    unsigned int number = Stock::idToNumber(itemId);
+    int row = rowOf[number];
+    if (row >= 0)
+    {
+        //move the last row into the hole so the rows stay packed
+        Version& version = writableVersion();
+        unsigned int last = version.count - 1;
+        if (static_cast<unsigned int>(row) != last)
+        {
+            Stock moved = version.chunks[last / SNAPSHOT_CHUNK_ITEMS]->items[last % SNAPSHOT_CHUNK_ITEMS];
+            rowOf[moved.getNumber()] = row;
+            writableRow(row) = moved;
+        }
+        rowOf[number] = -1;
+        version.count--;
+
+        //let go of the last block once it's empty
+        if (version.count == (version.chunks.size() - 1) * SNAPSHOT_CHUNK_ITEMS)
+        {
+            version.chunks.pop_back();
+        }
+    }
+}
+
+unsigned int SnapshotStore::size() const
+{
+    return live->count;
+}
+
+void SnapshotStore::saveInBackground(const CoinInventory& coins, const std::string& stockFile, const std::string& coinFile, CounterFile* counters)
+{
+    {
+        std::lock_guard<std::mutex> guard(saveLock);
+        pending = live;
+        pendingCoins = coins;
+        pendingStockFile = stockFile;
+        pendingCoinFile = coinFile;
+        pendingCounters = counters;
+    }
+
+    if (!thread.joinable())
+    {
+        thread = std::thread(&SnapshotStore::run, this);
+    }
+    saveChanged.notify_all();
+}
+
+void SnapshotStore::waitForSaves()
+{
+    std::unique_lock<std::mutex> guard(saveLock);
+    saveChanged.wait(guard, [this](){ return pending == nullptr && !writing; });
+}
+
+unsigned long SnapshotStore::getSavesWritten()
+{
+    std::lock_guard<std::mutex> guard(saveLock);
+    return savesWritten;
+}
+
+unsigned long SnapshotStore::getChunksCopied() const
+{
+    return chunksCopied;
+}
+
+void SnapshotStore::run()
+{
+    std::unique_lock<std::mutex> guard(saveLock);
+    bool done = false;
+    while (!done)
+    {
+        saveChanged.wait(guard, [this](){ return stopping || pending != nullptr; });
+        if (pending != nullptr)
+        {
+            //take the snapshot and write it without holding the lock, so another save can be asked for meanwhile
+            //moved out rather than copied, only the customer thread ever adds a reference to a version
+            std::shared_ptr<const Version> snapshot = std::move(pending);
+            CoinInventory coins = pendingCoins;
+            std::string stockFile = pendingStockFile;
+            std::string coinFile = pendingCoinFile;
+            CounterFile* counters = pendingCounters;
+            pending.reset();
+            writing = true;
+
+            guard.unlock();
+            bool written = true;
+            try {
+                writeSnapshot(*snapshot, coins, stockFile, coinFile);
+            }
+            catch(const std::runtime_error& e) {
+                std::cerr << ERROR_PREFIX << e.what() << ERROR_POSTFIX << std::endl;
+                written = false;
+            }
+            snapshot.reset();
+
+            //the counters have every change since the snapshot, so they're ahead of the files just written, not behind
+            if (written && counters != nullptr)
+            {
+                counters->markSavedInBackground();
+            }
+            guard.lock();
+
+            writing = false;
+            savesWritten++;
+            saveChanged.notify_all();
+        }
+        done = stopping && pending == nullptr;
+    }
+}
+
+void SnapshotStore::writeSnapshot(const Version& version, const CoinInventory& coins, const std::string& stockFile, const std::string& coinFile)
+{
+    std::vector<Stock> items;
+    items.reserve(version.count);
+    for (unsigned int row = 0; row < version.count; ++row)
+    {
+        items.push_back(version.chunks[row / SNAPSHOT_CHUNK_ITEMS]->items[row % SNAPSHOT_CHUNK_ITEMS]);
+    }
+
+    //the same order as the stock list, items with the same name go by id
+    std::sort(items.begin(), items.end(), [](const Stock& a, const Stock& b){
+        std::string nameA = Helper::stringLower(a.name.str());
+        std::string nameB = Helper::stringLower(b.name.str());
+        return nameA < nameB || (nameA == nameB && a.id < b.id);
+    });
+
+    Helper::saveCoinList(coinFile, coins);
+    Helper::saveStockList(stockFile, items);
+}
@@ -0,0 +1,152 @@
+#ifndef SNAPSHOT_STORE_H
+#define SNAPSHOT_STORE_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Node.h"
+#include "Coin.h"
+#include "CounterFile.h"
+
+// the items in each block of a version, a write to a block a snapshot still has copies only that block
+#define SNAPSHOT_CHUNK_ITEMS 64
+
+/**
+ * a copy-on-write copy of the catalog that the stock file and coin file can be saved from on a
+ * background thread. the items are kept in blocks shared between versions: taking a snapshot
+ * only keeps a reference to the current version, and the first write after it copies the list of
+ * blocks and then each block it touches, so the snapshot never changes while it's written out.
+ * the rows are in no particular order, the items are sorted by name when they're saved
+ **/
+class SnapshotStore
+{
+public:
+    SnapshotStore();
+
+    // waits for the saves asked for to be written
+    ~SnapshotStore();
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /**
+     * @brief Forget every item
+    */
+    void clear();
+
+    /**
+     * @brief Add an item as a new row
+     * @param stock The item
+    */
+    void insert(const Stock& stock);
+
+    /**
+     * @brief Copy an item into its row
+     * @param stock The item, it has to be in the store
+    */
+    void update(const Stock& stock);
+
+    /**
+     * @brief Remove an item's row, the last row moves into its place
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Get the number of items
+     * @return Number of items
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Save the items as they are now to the files on the background thread. Only a reference to
+     * the current version and a copy of the coins are taken here. If a save is already waiting to be
+     * written it's replaced by this one
+     * @param coins The coins as they are now
+     * @param stockFile The stock file to write
+     * @param coinFile The coin file to write
+     * @param counters The counter file to tell once the files are written, nullptr if there isn't one
+    */
+    void saveInBackground(const CoinInventory& coins, const std::string& stockFile, const std::string& coinFile, CounterFile* counters);
+
+    /**
+     * @brief Wait until every save asked for has been written
+    */
+    void waitForSaves();
+
+    /**
+     * @brief Get the number of snapshots written to the files
+     * @return Number of saves
+    */
+    unsigned long getSavesWritten();
+
+    /**
+     * @brief Get the number of blocks copied because a snapshot still had them
+     * @return Number of blocks
+    */
+    unsigned long getChunksCopied() const;
+
+private:
+    struct Chunk
+    {
+        Stock items[SNAPSHOT_CHUNK_ITEMS];
+    };
+
+    // a version of the catalog, a snapshot shares it (and its blocks) until the next write
+    struct Version
+    {
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        unsigned int count;
+    };
+
+    // only the thread writing the items changes this
+    std::shared_ptr<Version> live;
+
+    // the row of each item number, -1 if it's not in the store
+    std::vector<int> rowOf;
+    unsigned long chunksCopied;
+
+    // the snapshot waiting to be written and where to, only used under saveLock
+    std::shared_ptr<const Version> pending;
+    CoinInventory pendingCoins;
+    std::string pendingStockFile;
+    std::string pendingCoinFile;
+    CounterFile* pendingCounters;
+    bool writing;
+    bool stopping;
+    unsigned long savesWritten;
+
+    std::thread thread;
+    std::mutex saveLock;
+    std::condition_variable saveChanged;
+
+    /**
+     * @brief Get the live version to change, copying it first if a snapshot still has it
+     * @return The version
+    */
+    Version& writableVersion();
+
+    /**
+     * @brief Get a row to change, copying its block first if a snapshot still has it
+     * @param row The row
+     * @return The item in the row
+    */
+    Stock& writableRow(unsigned int row);
+
+    // the body of the background thread
+    void run();
+
+    /**
+     * @brief Write a snapshot to the files, sorted by name like the stock list
+     * @param version The snapshot
+     * @param coins The coins
+     * @param stockFile The stock file to write
+     * @param coinFile The coin file to write
+    */
+    static void writeSnapshot(const Version& version, const CoinInventory& coins, const std::string& stockFile, const std::string& coinFile);
+};
+
+#endif // SNAPSHOT_STORE_H
@@ -0,0 +1,240 @@
+#include "SortedIndex.h"
+
+// the treap priorities come from a fixed seed so the tree shape is the same every run
+#define SORTED_INDEX_SEED 1
+
+SortedIndex::SortedIndex(SortKey sortKey): sortKey(sortKey), root(-1), rng(SORTED_INDEX_SEED) {}
+
+void SortedIndex::clear()
+{
+    nodes.clear();
+    freeNodes.clear();
+    nodeOf.clear();
+    root = -1;
+}
+
+unsigned int SortedIndex::keyOf(SortKey sortKey, const Stock& stock)
+{
+    unsigned int key = stock.getOnHand();
+    if (sortKey == SORT_BY_PRICE)
+    {
+        key = stock.getPrice().getValue();
+    }
+    return key;
+}
+
+unsigned int SortedIndex::sizeOf(int node) const
+{
+    return node < 0 ? 0 : nodes[node].size;
+}
+
+void SortedIndex::resize(int node)
+{
+    nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+}
+
+bool SortedIndex::before(unsigned int key, unsigned int number, const TreeNode& node) const
+{
+    return node.key < key || (node.key == key && node.number < number);
+}
+
+void SortedIndex::split(int node, unsigned int key, unsigned int number, int& left, int& right)
+{
+    if (node < 0)
+    {
+        left = -1;
+        right = -1;
+    }
+    else if (before(key, number, nodes[node]))
+    {
+        //the node and its left subtree go left, its right subtree gets split
+        split(nodes[node].right, key, number, nodes[node].right, right);
+        left = node;
+        resize(node);
+    }
+    else
+    {
+        split(nodes[node].left, key, number, left, nodes[node].left);
+        right = node;
+        resize(node);
+    }
+}
+
+int SortedIndex::merge(int left, int right)
+{
+    int result = left < 0 ? right : left;
+
+    //the higher priority becomes the root, so the tree stays balanced on average
+    if (left >= 0 && right >= 0)
+    {
+        if (nodes[left].priority > nodes[right].priority)
+        {
+            nodes[left].right = merge(nodes[left].right, right);
+            resize(left);
+            result = left;
+        }
+        else
+        {
+            nodes[right].left = merge(left, nodes[right].left);
+            resize(right);
+            result = right;
+        }
+    }
+
+    return result;
+}
+
+void SortedIndex::remove(const std::string& itemId)
+{
+    std::unordered_map<std::string, int>::iterator found = nodeOf.find(itemId);
+    if (found != nodeOf.end())
+    {
+        //split out exactly the item's node, then join the two sides back together
+        int node = found->second;
+        int left = -1;
+        int middle = -1;
+        int right = -1;
+        split(root, nodes[node].key, nodes[node].number, left, middle);
+        split(middle, nodes[node].key, nodes[node].number + 1, middle, right);
+        root = merge(left, right);
+
+        freeNodes.push_back(node);
+        nodeOf.erase(found);
+    }
+}
+
+void SortedIndex::update(const Stock& stock)
+{
+    unsigned int key = keyOf(sortKey, stock);
+    std::unordered_map<std::string, int>::const_iterator found = nodeOf.find(stock.getId());
+
+    //nothing to do if it's already in the right spot, e.g. on hand didn't change
+    if (found == nodeOf.end() || nodes[found->second].key != key || nodes[found->second].stock != &stock)
+    {
+        remove(stock.getId());
+
+        int node = 0;
+        if (freeNodes.empty())
+        {
+            nodes.push_back(TreeNode());
+            node = nodes.size() - 1;
+        }
+        else
+        {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+        }
+
+        nodes[node] = TreeNode{key, stock.getNumber(), static_cast<unsigned int>(rng()), 1, -1, -1, &stock};
+
+        int left = -1;
+        int right = -1;
+        split(root, key, nodes[node].number, left, right);
+        root = merge(merge(left, node), right);
+        nodeOf[stock.getId()] = node;
+    }
+}
+
+unsigned int SortedIndex::size() const
+{
+    return sizeOf(root);
+}
+
+unsigned int SortedIndex::countBelow(unsigned int key) const
+{
+    //walk down once, everything left of where key would go is below it
+    unsigned int count = 0;
+    int node = root;
+    while (node >= 0)
+    {
+        if (nodes[node].key < key)
+        {
+            count += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+        else
+        {
+            node = nodes[node].left;
+        }
+    }
+    return count;
+}
+
+const Stock* SortedIndex::at(unsigned int rank) const
+{
+    const Stock* result = nullptr;
+    int node = root;
+    while (node >= 0 && result == nullptr)
+    {
+        unsigned int leftSize = sizeOf(nodes[node].left);
+        if (rank < leftSize)
+        {
+            node = nodes[node].left;
+        }
+        else if (rank == leftSize)
+        {
+            result = nodes[node].stock;
+        }
+        else
+        {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+    return result;
+}
+
+void SortedIndex::collectRange(int node, unsigned int low, unsigned int high, std::vector<const Stock*>& results) const
+{
+    if (node >= 0)
+    {
+        const TreeNode& treeNode = nodes[node];
+        if (treeNode.key >= low)
+        {
+            collectRange(treeNode.left, low, high, results);
+        }
+        if (treeNode.key >= low && treeNode.key <= high)
+        {
+            results.push_back(treeNode.stock);
+        }
+        if (treeNode.key <= high)
+        {
+            collectRange(treeNode.right, low, high, results);
+        }
+    }
+}
+
+std::vector<const Stock*> SortedIndex::range(unsigned int low, unsigned int high) const
+{
+    std::vector<const Stock*> results;
+    collectRange(root, low, high, results);
+    return results;
+}
+
+void SortedIndex::collectEdge(int node, unsigned int k, bool fromLowest, std::vector<const Stock*>& results) const
+{
+    if (node >= 0 && results.size() < k)
+    {
+        const TreeNode& treeNode = nodes[node];
+        collectEdge(fromLowest ? treeNode.left : treeNode.right, k, fromLowest, results);
+        if (results.size() < k)
+        {
+            results.push_back(treeNode.stock);
+        }
+        collectEdge(fromLowest ? treeNode.right : treeNode.left, k, fromLowest, results);
+    }
+}
+
+std::vector<const Stock*> SortedIndex::lowest(unsigned int k) const
+{
+    std::vector<const Stock*> results;
+    collectEdge(root, k, true, results);
+    return results;
+}
+
+std::vector<const Stock*> SortedIndex::highest(unsigned int k) const
+{
+    std::vector<const Stock*> results;
+    collectEdge(root, k, false, results);
+    return results;
+}
@@ -0,0 +1,170 @@
+#ifndef SORTED_INDEX_H
+#define SORTED_INDEX_H
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Node.h"
+
+// what a sorted index orders the items by
+enum SortKey
+{
+    SORT_BY_PRICE, SORT_BY_ON_HAND
+};
+
+/**
+ * an order statistic tree (a treap where every node knows the size of its subtree)
+ * of the items ordered by price or on hand, ties ordered by item id.
+ * adding, removing or moving an item, counting the items under a key and finding
+ * the kth item all take O(log n), a range or the first k items take O(log n + k).
+ * like NameIndex the items are pointed to, not copied
+ **/
+class SortedIndex
+{
+public:
+    SortedIndex(SortKey sortKey);
+
+    /**
+     * @brief Forget every item
+    */
+    void clear();
+
+    /**
+     * @brief Add an item, or move it if its key changed since it was added
+     * @param stock The item, must stay where it is until it is removed
+    */
+    void update(const Stock& stock);
+
+    /**
+     * @brief Remove an item, it doesn't have to still exist
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Get the number of items in the index
+     * @return Number of items
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Count the items with a key lower than a value
+     * @param key The value
+     * @return Number of items
+    */
+    unsigned int countBelow(unsigned int key) const;
+
+    /**
+     * @brief Get the item at a position in the order
+     * @param rank The position starting at 0
+     * @return The item or nullptr if there aren't that many items
+    */
+    const Stock* at(unsigned int rank) const;
+
+    /**
+     * @brief Get the items with a key between two values (both included) in order
+     * @param low The lowest key
+     * @param high The highest key
+     * @return The items in ascending order of key
+    */
+    std::vector<const Stock*> range(unsigned int low, unsigned int high) const;
+
+    /**
+     * @brief Get the items with the lowest keys
+     * @param k How many items
+     * @return Up to k items in ascending order of key
+    */
+    std::vector<const Stock*> lowest(unsigned int k) const;
+
+    /**
+     * @brief Get the items with the highest keys
+     * @param k How many items
+     * @return Up to k items in descending order of key
+    */
+    std::vector<const Stock*> highest(unsigned int k) const;
+
+    /**
+     * @brief Get the key an item is ordered by in an index sorted by sortKey
+     * @param sortKey What the index is sorted by
+     * @param stock The item
+     * @return The key
+    */
+    static unsigned int keyOf(SortKey sortKey, const Stock& stock);
+
+private:
+    // a node of the treap, the children are indexes into nodes
+    struct TreeNode
+    {
+        unsigned int key;
+        unsigned int number;
+        unsigned int priority;
+        unsigned int size;
+        int left;
+        int right;
+        const Stock* stock;
+    };
+
+    SortKey sortKey;
+    std::vector<TreeNode> nodes;
+
+    // nodes that were removed and can be used again
+    std::vector<int> freeNodes;
+    int root;
+    std::mt19937 rng;
+
+    // the node of each item, it holds the key the item was added with so it can be found again when the key changes
+    std::unordered_map<std::string, int> nodeOf;
+
+    /**
+     * @brief Get the number of nodes in a subtree
+     * @param node The root of the subtree or -1
+     * @return Number of nodes
+    */
+    unsigned int sizeOf(int node) const;
+
+    /**
+     * @brief Work out a node's size from its children
+     * @param node The node
+    */
+    void resize(int node);
+
+    /**
+     * @brief Whether a node comes before (key, number) in the order, by key then by item number
+     * @param key The key
+     * @param number The item number
+     * @param node The node
+     * @return Whether the node comes first
+    */
+    bool before(unsigned int key, unsigned int number, const TreeNode& node) const;
+
+    /**
+     * @brief Split a subtree into the nodes before (key, number) and the rest
+     * @param node The root of the subtree
+     * @param key The key to split at
+     * @param number The item number to split at
+     * @param left Set to the root of the nodes before
+     * @param right Set to the root of the rest
+    */
+    void split(int node, unsigned int key, unsigned int number, int& left, int& right);
+
+    /**
+     * @brief Join two subtrees where every node of the left one comes first
+     * @param left The root of the left subtree
+     * @param right The root of the right subtree
+     * @return The root of the joined tree
+    */
+    int merge(int left, int right);
+
+    /**
+     * @brief Add the items of a subtree with keys in a range to results in order, skipping subtrees outside it
+    */
+    void collectRange(int node, unsigned int low, unsigned int high, std::vector<const Stock*>& results) const;
+
+    /**
+     * @brief Add the first (or last) items of a subtree to results until there are k of them
+    */
+    void collectEdge(int node, unsigned int k, bool fromLowest, std::vector<const Stock*>& results) const;
+};
+
+#endif // SORTED_INDEX_H
@@ -0,0 +1,536 @@
+#include "StockTable.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STOCK_TABLE_X86 1
+#endif
+
+// the top bit gets flipped before comparing, so the signed compares of SSE2/AVX2 order unsigned values
+#define SIGN_FLIP 0x80000000u
+
+//====SCALAR KERNELS=====
+static unsigned int countEqualScalar(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        count += values[i] == value;
+    }
+    return count;
+}
+
+static unsigned int countBelowScalar(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        count += values[i] < value;
+    }
+    return count;
+}
+
+static void filterBelowScalar(const uint32_t* values, unsigned int start, unsigned int n, uint32_t value, std::vector<unsigned int>& rows)
+{
+    for (unsigned int i = start; i < n; ++i)
+    {
+        if (values[i] < value)
+        {
+            rows.push_back(i);
+        }
+    }
+}
+
+static unsigned long long sumScalar(const uint32_t* values, unsigned int start, unsigned int n)
+{
+    unsigned long long sum = 0;
+    for (unsigned int i = start; i < n; ++i)
+    {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static unsigned long long sumProductsScalar(const uint32_t* a, const uint32_t* b, unsigned int start, unsigned int n)
+{
+    unsigned long long sum = 0;
+    for (unsigned int i = start; i < n; ++i)
+    {
+        sum += static_cast<unsigned long long>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+#ifdef STOCK_TABLE_X86
+//====SSE2 KERNELS (4 items at a time)=====
+static unsigned int countEqualSse2(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    //a match is -1 in its lane, so subtracting the mask counts it
+    __m128i target = _mm_set1_epi32(value);
+    __m128i counts = _mm_setzero_si128();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(block, target));
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + countEqualScalar(values + i, n - i, value);
+}
+
+static unsigned int countBelowSse2(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    __m128i flip = _mm_set1_epi32(SIGN_FLIP);
+    __m128i target = _mm_xor_si128(_mm_set1_epi32(value), flip);
+    __m128i counts = _mm_setzero_si128();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), flip);
+        counts = _mm_sub_epi32(counts, _mm_cmplt_epi32(block, target));
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + countBelowScalar(values + i, n - i, value);
+}
+
+static void filterBelowSse2(const uint32_t* values, unsigned int n, uint32_t value, std::vector<unsigned int>& rows)
+{
+    __m128i flip = _mm_set1_epi32(SIGN_FLIP);
+    __m128i target = _mm_xor_si128(_mm_set1_epi32(value), flip);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        //one bit per lane that matched, then walk the set bits
+        __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), flip);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, target)));
+        while (mask != 0)
+        {
+            rows.push_back(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    filterBelowScalar(values, i, n, value, rows);
+}
+
+static unsigned long long sumSse2(const uint32_t* values, unsigned int n)
+{
+    //widen each half of the block to 64 bits so the sum can't overflow
+    __m128i zero = _mm_setzero_si128();
+    __m128i sums = _mm_setzero_si128();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(block, zero));
+        sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(block, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    return lanes[0] + lanes[1] + sumScalar(values, i, n);
+}
+
+static unsigned long long sumProductsSse2(const uint32_t* a, const uint32_t* b, unsigned int n)
+{
+    //_mm_mul_epu32 multiplies lanes 0 and 2 into 64 bits, shifting moves lanes 1 and 3 down for the second one
+    __m128i sums = _mm_setzero_si128();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        sums = _mm_add_epi64(sums, _mm_mul_epu32(blockA, blockB));
+        sums = _mm_add_epi64(sums, _mm_mul_epu32(_mm_srli_epi64(blockA, 32), _mm_srli_epi64(blockB, 32)));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    return lanes[0] + lanes[1] + sumProductsScalar(a, b, i, n);
+}
+
+//====AVX2 KERNELS (8 items at a time)=====
+__attribute__((target("avx2")))
+static unsigned int countEqualAvx2(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    __m256i target = _mm256_set1_epi32(value);
+    __m256i counts = _mm256_setzero_si256();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        counts = _mm256_sub_epi32(counts, _mm256_cmpeq_epi32(block, target));
+    }
+
+    uint32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts);
+    unsigned int count = 0;
+    for (unsigned int lane = 0; lane < 8; ++lane)
+    {
+        count += lanes[lane];
+    }
+    return count + countEqualScalar(values + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static unsigned int countBelowAvx2(const uint32_t* values, unsigned int n, uint32_t value)
+{
+    __m256i flip = _mm256_set1_epi32(SIGN_FLIP);
+    __m256i target = _mm256_xor_si256(_mm256_set1_epi32(value), flip);
+    __m256i counts = _mm256_setzero_si256();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), flip);
+        counts = _mm256_sub_epi32(counts, _mm256_cmpgt_epi32(target, block));
+    }
+
+    uint32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts);
+    unsigned int count = 0;
+    for (unsigned int lane = 0; lane < 8; ++lane)
+    {
+        count += lanes[lane];
+    }
+    return count + countBelowScalar(values + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static void filterBelowAvx2(const uint32_t* values, unsigned int n, uint32_t value, std::vector<unsigned int>& rows)
+{
+    __m256i flip = _mm256_set1_epi32(SIGN_FLIP);
+    __m256i target = _mm256_xor_si256(_mm256_set1_epi32(value), flip);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), flip);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, block)));
+        while (mask != 0)
+        {
+            rows.push_back(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    filterBelowScalar(values, i, n, value, rows);
+}
+
+__attribute__((target("avx2")))
+static unsigned long long sumAvx2(const uint32_t* values, unsigned int n)
+{
+    __m256i sums = _mm256_setzero_si256();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        //widen 4 at a time to 64 bits
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 4));
+        sums = _mm256_add_epi64(sums, _mm256_cvtepu32_epi64(low));
+        sums = _mm256_add_epi64(sums, _mm256_cvtepu32_epi64(high));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sums);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(values, i, n);
+}
+
+__attribute__((target("avx2")))
+static unsigned long long sumProductsAvx2(const uint32_t* a, const uint32_t* b, unsigned int n)
+{
+    __m256i sums = _mm256_setzero_si256();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i blockA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i blockB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        sums = _mm256_add_epi64(sums, _mm256_mul_epu32(blockA, blockB));
+        sums = _mm256_add_epi64(sums, _mm256_mul_epu32(_mm256_srli_epi64(blockA, 32), _mm256_srli_epi64(blockB, 32)));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sums);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumProductsScalar(a, b, i, n);
+}
+
+__attribute__((target("avx2")))
+static void fillAvx2(uint32_t* values, unsigned int n, uint32_t value)
+{
+    __m256i block = _mm256_set1_epi32(value);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), block);
+    }
+    for (; i < n; ++i)
+    {
+        values[i] = value;
+    }
+}
+#endif
+
+//====STOCK TABLE=====
+SimdLevel StockTable::simdLevel = StockTable::detectSimdLevel();
+
+StockTable::StockTable(): garbage(0), rowOf(STOCK_MAX_ID + 1, -1) {}
+
+SimdLevel StockTable::detectSimdLevel()
+{
+    SimdLevel level = SIMD_SCALAR;
+#ifdef STOCK_TABLE_X86
+    //SSE2 is always there on x86-64, AVX2 has to be asked for
+    level = SIMD_SSE2;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        level = SIMD_AVX2;
+    }
+#endif
+    return level;
+}
+
+SimdLevel StockTable::getSimdLevel()
+{
+    return simdLevel;
+}
+
+void StockTable::setSimdLevel(SimdLevel level)
+{
+    simdLevel = std::min(level, detectSimdLevel());
+}
+
+std::string StockTable::simdName(SimdLevel level)
+{
+    static const char* const names[] = {"scalar", "SSE2", "AVX2"};
+    return names[level];
+}
+
+void StockTable::clear()
+{
+    numbers.clear();
+    prices.clear();
+    onHands.clear();
+    names.clear();
+    descriptions.clear();
+    arena.clear();
+    garbage = 0;
+    std::fill(rowOf.begin(), rowOf.end(), -1);
+}
+
+StockTable::TextRef StockTable::addText(const std::string& text)
+{
+    TextRef ref{static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(text.length())};
+    arena += text;
+    return ref;
+}
+
+void StockTable::compactArena()
+{
+    if (garbage * 2 > arena.size())
+    {
+        std::string compacted;
+        compacted.reserve(arena.size() - garbage);
+        for (unsigned int row = 0; row < numbers.size(); ++row)
+        {
+            TextRef name{static_cast<uint32_t>(compacted.size()), names[row].length};
+            compacted.append(arena, names[row].offset, names[row].length);
+            TextRef description{static_cast<uint32_t>(compacted.size()), descriptions[row].length};
+            compacted.append(arena, descriptions[row].offset, descriptions[row].length);
+            names[row] = name;
+            descriptions[row] = description;
+        }
+        arena.swap(compacted);
+        garbage = 0;
+    }
+}
+
+void StockTable::insert(const Stock& stock)
+{
+    unsigned int number = stock.getNumber();
+
+    //an item that is already in here gets a fresh row
+    remove(stock.getId());
+
+    rowOf[number] = numbers.size();
+    numbers.push_back(number);
+    prices.push_back(stock.getPrice().getValue());
+    onHands.push_back(stock.getOnHand());
+    names.push_back(addText(stock.getName()));
+    descriptions.push_back(addText(stock.getDescription()));
+}
+
+void StockTable::update(const Stock& stock)
+{
+    int row = rowOf[stock.getNumber()];
+    if (row >= 0)
+    {
+        onHands[row] = stock.getOnHand();
+    }
+}
+
+void StockTable::remove(const std::string& itemId)
+{
+    unsigned int number = Stock::idToNumber(itemId);
+    int row = rowOf[number];
+    if (row >= 0)
+    {
+        garbage += names[row].length + descriptions[row].length;
+
+        //move the last row into the hole so the columns stay dense
+        unsigned int last = numbers.size() - 1;
+        numbers[row] = numbers[last];
+        prices[row] = prices[last];
+        onHands[row] = onHands[last];
+        names[row] = names[last];
+        descriptions[row] = descriptions[last];
+        rowOf[numbers[row]] = row;
+        rowOf[number] = -1;
+
+        numbers.pop_back();
+        prices.pop_back();
+        onHands.pop_back();
+        names.pop_back();
+        descriptions.pop_back();
+        compactArena();
+    }
+}
+
+void StockTable::fillOnHand(unsigned int onHand)
+{
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2)
+    {
+        fillAvx2(onHands.data(), onHands.size(), onHand);
+    }
+    else
+#endif
+    {
+        std::fill(onHands.begin(), onHands.end(), onHand);
+    }
+}
+
+unsigned int StockTable::size() const
+{
+    return numbers.size();
+}
+
+unsigned int StockTable::countOnHandEqual(unsigned int onHand) const
+{
+    unsigned int count = 0;
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2) {
+        count = countEqualAvx2(onHands.data(), onHands.size(), onHand);
+    }
+    else if (simdLevel == SIMD_SSE2) {
+        count = countEqualSse2(onHands.data(), onHands.size(), onHand);
+    }
+    else
+#endif
+    {
+        count = countEqualScalar(onHands.data(), onHands.size(), onHand);
+    }
+    return count;
+}
+
+unsigned int StockTable::countOnHandBelow(unsigned int onHand) const
+{
+    unsigned int count = 0;
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2) {
+        count = countBelowAvx2(onHands.data(), onHands.size(), onHand);
+    }
+    else if (simdLevel == SIMD_SSE2) {
+        count = countBelowSse2(onHands.data(), onHands.size(), onHand);
+    }
+    else
+#endif
+    {
+        count = countBelowScalar(onHands.data(), onHands.size(), onHand);
+    }
+    return count;
+}
+
+std::vector<unsigned int> StockTable::filterOnHandBelow(unsigned int onHand) const
+{
+    std::vector<unsigned int> rows;
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2) {
+        filterBelowAvx2(onHands.data(), onHands.size(), onHand, rows);
+    }
+    else if (simdLevel == SIMD_SSE2) {
+        filterBelowSse2(onHands.data(), onHands.size(), onHand, rows);
+    }
+    else
+#endif
+    {
+        filterBelowScalar(onHands.data(), 0, onHands.size(), onHand, rows);
+    }
+    return rows;
+}
+
+unsigned long long StockTable::totalOnHand() const
+{
+    unsigned long long total = 0;
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2) {
+        total = sumAvx2(onHands.data(), onHands.size());
+    }
+    else if (simdLevel == SIMD_SSE2) {
+        total = sumSse2(onHands.data(), onHands.size());
+    }
+    else
+#endif
+    {
+        total = sumScalar(onHands.data(), 0, onHands.size());
+    }
+    return total;
+}
+
+unsigned long long StockTable::inventoryValue() const
+{
+    unsigned long long value = 0;
+#ifdef STOCK_TABLE_X86
+    if (simdLevel == SIMD_AVX2) {
+        value = sumProductsAvx2(prices.data(), onHands.data(), onHands.size());
+    }
+    else if (simdLevel == SIMD_SSE2) {
+        value = sumProductsSse2(prices.data(), onHands.data(), onHands.size());
+    }
+    else
+#endif
+    {
+        value = sumProductsScalar(prices.data(), onHands.data(), 0, onHands.size());
+    }
+    return value;
+}
+
+std::string StockTable::getId(unsigned int row) const
+{
+    return Stock::numberToId(numbers[row]);
+}
+
+std::string StockTable::getName(unsigned int row) const
+{
+    return arena.substr(names[row].offset, names[row].length);
+}
+
+std::string StockTable::getDescription(unsigned int row) const
+{
+    return arena.substr(descriptions[row].offset, descriptions[row].length);
+}
+
+unsigned int StockTable::getPrice(unsigned int row) const
+{
+    return prices[row];
+}
+
+unsigned int StockTable::getOnHand(unsigned int row) const
+{
+    return onHands[row];
+}
+
+unsigned long StockTable::getArenaBytes() const
+{
+    return arena.size();
+}
@@ -0,0 +1,172 @@
+#ifndef STOCK_TABLE_H
+#define STOCK_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Node.h"
+
+// the vector instructions the table's scans can use, the best one the cpu has is picked at startup
+enum SimdLevel
+{
+    SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2
+};
+
+/**
+ * a columnar copy of the catalog: the item numbers, prices in cents and on hand amounts
+ * are each a dense array (one row per item, in no particular order), and the names and
+ * descriptions are packed one after another in a single string arena.
+ * the count, sum and filter scans go through the arrays with SSE2 or AVX2 (4 or 8 items
+ * per instruction) and fall back to plain loops on other cpus
+ **/
+class StockTable
+{
+public:
+    StockTable();
+
+    /**
+     * @brief Forget every item
+    */
+    void clear();
+
+    /**
+     * @brief Add an item as a new row
+     * @param stock The item
+    */
+    void insert(const Stock& stock);
+
+    /**
+     * @brief Copy an item's on hand amount into its row
+     * @param stock The item, it has to be in the table
+    */
+    void update(const Stock& stock);
+
+    /**
+     * @brief Remove an item's row, the last row moves into its place
+     * @param itemId The id of the item
+    */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief Set every item's on hand amount (what resetStock does)
+     * @param onHand The amount
+    */
+    void fillOnHand(unsigned int onHand);
+
+    /**
+     * @brief Get the number of rows
+     * @return Number of items
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Count the items with exactly some amount on hand, e.g. 0 for sold out
+     * @param onHand The amount
+     * @return Number of items
+    */
+    unsigned int countOnHandEqual(unsigned int onHand) const;
+
+    /**
+     * @brief Count the items with less than some amount on hand
+     * @param onHand The amount
+     * @return Number of items
+    */
+    unsigned int countOnHandBelow(unsigned int onHand) const;
+
+    /**
+     * @brief Get the rows of the items with less than some amount on hand
+     * @param onHand The amount
+     * @return The rows in ascending order
+    */
+    std::vector<unsigned int> filterOnHandBelow(unsigned int onHand) const;
+
+    /**
+     * @brief Add up the on hand amounts of every item
+     * @return The number of items in the machine
+    */
+    unsigned long long totalOnHand() const;
+
+    /**
+     * @brief Add up the price times the on hand amount of every item
+     * @return The value of everything in the machine in cents
+    */
+    unsigned long long inventoryValue() const;
+
+    // the columns of a row
+    std::string getId(unsigned int row) const;
+    std::string getName(unsigned int row) const;
+    std::string getDescription(unsigned int row) const;
+    unsigned int getPrice(unsigned int row) const;
+    unsigned int getOnHand(unsigned int row) const;
+
+    /**
+     * @brief Get the bytes the arena uses, including the text of removed rows not compacted yet
+     * @return Number of bytes
+    */
+    unsigned long getArenaBytes() const;
+
+    /**
+     * @brief Get the instructions the scans use
+     * @return The SIMD level
+    */
+    static SimdLevel getSimdLevel();
+
+    /**
+     * @brief Make the scans use some instructions, e.g. SIMD_SCALAR to compare against the vector ones.
+     * asking for more than the cpu has gets the best it has
+     * @param level The SIMD level
+    */
+    static void setSimdLevel(SimdLevel level);
+
+    /**
+     * @brief Get the name of a SIMD level, e.g. "AVX2"
+     * @param level The SIMD level
+     * @return The name
+    */
+    static std::string simdName(SimdLevel level);
+
+private:
+    // where a row's text is in the arena
+    struct TextRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::vector<uint32_t> numbers;
+    std::vector<uint32_t> prices;
+    std::vector<uint32_t> onHands;
+    std::vector<TextRef> names;
+    std::vector<TextRef> descriptions;
+
+    // the names and descriptions of every row one after another
+    std::string arena;
+
+    // bytes of the arena that belong to removed rows
+    unsigned long garbage;
+
+    // the row of each item number, -1 if it's not in the table
+    std::vector<int> rowOf;
+
+    static SimdLevel simdLevel;
+
+    /**
+     * @brief Get the best SIMD level this cpu supports
+     * @return The SIMD level
+    */
+    static SimdLevel detectSimdLevel();
+
+    /**
+     * @brief Copy text onto the end of the arena
+     * @param text The text
+     * @return Where it is
+    */
+    TextRef addText(const std::string& text);
+
+    /**
+     * @brief Copy the text that is still used into a new arena once more than half of it is garbage
+    */
+    void compactArena();
+};
+
+#endif // STOCK_TABLE_H
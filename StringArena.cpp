@@ -0,0 +1,319 @@
+#include "StringArena.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// the longest text a std::string keeps inside itself without going to the heap (libstdc++)
+#define STRING_INLINE_CAPACITY 15
+
+// malloc adds this many bytes to every block, rounds up to this and never gives out less than the minimum (glibc, 64 bit)
+#define MALLOC_OVERHEAD 8
+#define MALLOC_ALIGN 16
+#define MALLOC_MIN_CHUNK 32
+
+// the bytes in front of each string holding its length
+#define ARENA_LENGTH_BYTES 2
+
+// how a handle is split into the external flag, the block number and where in the block
+#define HANDLE_EXTERNAL_BIT 0x80000000u
+#define HANDLE_CHUNK_SHIFT 16
+#define HANDLE_CHUNK_MASK 0x7FFF
+#define HANDLE_OFFSET_MASK 0xFFFF
+
+// an external string's block holds where the text is then its length
+#define EXTERNAL_RECORD_BYTES (sizeof(const char*) + sizeof(uint32_t))
+
+//====ARENA STRING=====
+ArenaString::ArenaString(): handle(0) {}
+
+ArenaString::ArenaString(uint32_t handle): handle(handle) {}
+
+bool ArenaString::isExternal() const
+{
+    return (handle & HANDLE_EXTERNAL_BIT) != 0;
+}
+
+const char* ArenaString::data() const
+{
+    const char* text = "";
+    if (isExternal())
+    {
+        std::memcpy(&text, StringArena::catalog().locate(handle), sizeof(text));
+    }
+    else if (handle != 0)
+    {
+        text = reinterpret_cast<const char*>(StringArena::catalog().locate(handle) + ARENA_LENGTH_BYTES);
+    }
+    return text;
+}
+
+unsigned int ArenaString::length() const
+{
+    unsigned int size = 0;
+    if (isExternal())
+    {
+        uint32_t stored = 0;
+        std::memcpy(&stored, StringArena::catalog().locate(handle) + sizeof(const char*), sizeof(stored));
+        size = stored;
+    }
+    else if (handle != 0)
+    {
+        const unsigned char* stored = StringArena::catalog().locate(handle);
+        size = stored[0] | (stored[1] << 8);
+    }
+    return size;
+}
+
+bool ArenaString::empty() const { return handle == 0; }
+
+std::string ArenaString::str() const
+{
+    return std::string(data(), length());
+}
+
+std::string ArenaString::substr(unsigned int start, unsigned int count) const
+{
+    return std::string(data() + start, count);
+}
+
+bool ArenaString::operator==(const ArenaString& other) const
+{
+    //interned text always has the same handle, external text has to be compared
+    bool equal = handle == other.handle;
+    if (!equal && (isExternal() || other.isExternal()))
+    {
+        equal = length() == other.length() && std::memcmp(data(), other.data(), length()) == 0;
+    }
+    return equal;
+}
+
+std::ostream& operator<<(std::ostream& os, const ArenaString& s)
+{
+    //pad on whichever side std::left/std::right says, nothing gets copied out of the arena
+    std::streamsize padding = os.width() > s.length() ? os.width() - s.length() : 0;
+    bool padRight = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+    for (std::streamsize i = 0; i < padding && !padRight; ++i)
+    {
+        os.put(os.fill());
+    }
+    os.write(s.data(), s.length());
+    for (std::streamsize i = 0; i < padding && padRight; ++i)
+    {
+        os.put(os.fill());
+    }
+    os.width(0);
+    return os;
+}
+
+//====STRING ARENA=====
+StringArena::StringArena(): chunkUsed(0), stats(ArenaStats()), catalogs(0)
+{
+    chunks.reserve(ARENA_MAX_CHUNKS);
+}
+
+StringArena& StringArena::catalog()
+{
+    static StringArena arena;
+    return arena;
+}
+
+uint64_t StringArena::hashText(const char* text, unsigned int length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+const unsigned char* StringArena::locate(uint32_t handle) const
+{
+    return chunks[((handle >> HANDLE_CHUNK_SHIFT) & HANDLE_CHUNK_MASK) - 1].get() + (handle & HANDLE_OFFSET_MASK);
+}
+
+uint32_t StringArena::allocate(unsigned long needed)
+{
+    //start a new block when it doesn't fit in what's left of the last one
+    if (chunks.empty() || chunkUsed + needed > ARENA_CHUNK_SIZE)
+    {
+        if (chunks.size() == ARENA_MAX_CHUNKS)
+        {
+            throw std::runtime_error("The string arena is full");
+        }
+        chunks.push_back(std::unique_ptr<unsigned char[]>(new unsigned char[ARENA_CHUNK_SIZE]));
+        chunkUsed = 0;
+        stats.chunks++;
+        stats.bytesReserved += ARENA_CHUNK_SIZE;
+    }
+
+    uint32_t handle = (static_cast<uint32_t>(chunks.size()) << HANDLE_CHUNK_SHIFT) | chunkUsed;
+    chunkUsed += needed;
+    return handle;
+}
+
+ArenaString StringArena::intern(const std::string& text)
+{
+    if (text.length() > ARENA_MAX_LENGTH)
+    {
+        throw std::runtime_error("Text is too long for the string arena");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ArenaString result;
+    if (!text.empty())
+    {
+        //compare against every string with the same hash, it only gets copied in if it's new
+        uint64_t hash = hashText(text.data(), text.length());
+        typedef std::unordered_multimap<uint64_t, uint32_t>::const_iterator Iterator;
+        std::pair<Iterator, Iterator> candidates = strings.equal_range(hash);
+        for (Iterator it = candidates.first; it != candidates.second && result.empty(); ++it)
+        {
+            const unsigned char* stored = locate(it->second);
+            unsigned int storedLength = stored[0] | (stored[1] << 8);
+            if (storedLength == text.length() && std::memcmp(stored + ARENA_LENGTH_BYTES, text.data(), storedLength) == 0)
+            {
+                result = ArenaString(it->second);
+            }
+        }
+
+        if (!result.empty())
+        {
+            stats.duplicates++;
+            stats.bytesSaved += text.length();
+        }
+        else
+        {
+            unsigned long needed = ARENA_LENGTH_BYTES + text.length();
+            uint32_t handle = allocate(needed);
+            unsigned char* stored = chunks.back().get() + (handle & HANDLE_OFFSET_MASK);
+            stored[0] = text.length() & 0xFF;
+            stored[1] = text.length() >> 8;
+            std::memcpy(stored + ARENA_LENGTH_BYTES, text.data(), text.length());
+
+            strings.insert(std::make_pair(hash, handle));
+            result = ArenaString(handle);
+            stats.strings++;
+            stats.bytesUsed += needed;
+        }
+    }
+    return result;
+}
+
+ArenaString StringArena::external(const char* text, unsigned int length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ArenaString result;
+    if (length > 0)
+    {
+        uint32_t handle = allocate(EXTERNAL_RECORD_BYTES);
+        unsigned char* stored = chunks.back().get() + (handle & HANDLE_OFFSET_MASK);
+        uint32_t storedLength = length;
+        std::memcpy(stored, &text, sizeof(text));
+        std::memcpy(stored + sizeof(text), &storedLength, sizeof(storedLength));
+
+        result = ArenaString(handle | HANDLE_EXTERNAL_BIT);
+        stats.externals++;
+        stats.bytesExternal += length;
+        stats.bytesUsed += EXTERNAL_RECORD_BYTES;
+    }
+    return result;
+}
+
+const char* StringArena::mapFile(const std::string& fileName)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("Could not open " + fileName + " to map it");
+    }
+
+    //the mapping keeps the file around even after the descriptor is closed
+    const char* result = nullptr;
+    std::size_t size = info.st_size;
+    if (size > 0)
+    {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            throw std::runtime_error("Could not map " + fileName);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        mappings.push_back(std::make_pair(mapped, size));
+        stats.bytesMapped += size;
+        result = static_cast<const char*>(mapped);
+    }
+    else
+    {
+        close(fd);
+    }
+    return result;
+}
+
+void StringArena::attach()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    catalogs++;
+}
+
+void StringArena::detach()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    catalogs--;
+}
+
+bool StringArena::recycle()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bool wasReset = false;
+    if (catalogs <= 1)
+    {
+        reset();
+        wasReset = true;
+    }
+    return wasReset;
+}
+
+void StringArena::reset()
+{
+    //one free per block, not one per string
+    chunks.clear();
+    strings.clear();
+    chunkUsed = 0;
+    for (const std::pair<void*, std::size_t>& mapping : mappings)
+    {
+        munmap(mapping.first, mapping.second);
+    }
+    mappings.clear();
+    stats = ArenaStats();
+}
+
+ArenaStats StringArena::getStats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+unsigned long StringArena::heapBytesFor(unsigned int length)
+{
+    unsigned long bytes = 0;
+    if (length > STRING_INLINE_CAPACITY)
+    {
+        //the text and its terminating null, plus what malloc keeps for itself
+        unsigned long requested = length + 1 + MALLOC_OVERHEAD;
+        bytes = std::max(static_cast<unsigned long>(MALLOC_MIN_CHUNK), (requested + MALLOC_ALIGN - 1) / MALLOC_ALIGN * MALLOC_ALIGN);
+    }
+    return bytes;
+}
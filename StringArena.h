@@ -0,0 +1,223 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the size of each block the arena hands out text from, an ArenaString can only point this far into a block
+#define ARENA_CHUNK_SIZE 65536
+
+// the most blocks the arena can have, an ArenaString only has room for this many
+#define ARENA_MAX_CHUNKS 32767
+
+// the longest text the arena takes, each string is stored after a 2 byte length
+#define ARENA_MAX_LENGTH (ARENA_CHUNK_SIZE - 2)
+
+/**
+ * a string that lives in StringArena::catalog(). it's only 4 bytes, the number of the block
+ * the text is in and where it starts in the block, so copying one never allocates.
+ * an external string's text is somewhere else (in a file the arena mapped), the block only
+ * has where it is and how long it is.
+ * it stays valid until the arena is reset
+ **/
+class ArenaString
+{
+public:
+    // an empty string, it doesn't need the arena
+    ArenaString();
+
+    const char* data() const;
+    unsigned int length() const;
+    bool empty() const;
+
+    /**
+     * @brief Copy the text out into a std::string
+     * @return The text
+    */
+    std::string str() const;
+
+    /**
+     * @brief Copy part of the text out into a std::string
+     * @param start The first character
+     * @param count The number of characters
+     * @return The text
+    */
+    std::string substr(unsigned int start, unsigned int count) const;
+
+    bool operator==(const ArenaString& other) const;
+
+    // writes the text straight from the arena, padded like a std::string for std::setw
+    friend std::ostream& operator<<(std::ostream& os, const ArenaString& s);
+
+private:
+    // the top bit is set for an external string, then the block number plus one in the next 15 bits
+    // (so 0 is the empty string) and where the text (or where to find it) starts in the bottom 16
+    uint32_t handle;
+
+    /**
+     * @brief Whether the text is outside the arena
+     * @return Whether it's external
+    */
+    bool isExternal() const;
+
+    explicit ArenaString(uint32_t handle);
+
+    friend class StringArena;
+};
+
+/**
+ * what an arena is using, for the memory usage display
+ **/
+struct ArenaStats
+{
+    // the different strings stored and the bytes of text they take up
+    unsigned long strings;
+    unsigned long bytesUsed;
+
+    // the bytes of every block allocated, used or not
+    unsigned long bytesReserved;
+    unsigned long chunks;
+
+    // the strings that were already there when they got interned and the bytes that saved
+    unsigned long duplicates;
+    unsigned long bytesSaved;
+
+    // the external strings and the bytes of text they point at
+    unsigned long externals;
+    unsigned long bytesExternal;
+
+    // the bytes of the files mapped
+    unsigned long bytesMapped;
+};
+
+/**
+ * a bump allocator for the item names and descriptions: text is copied one after another
+ * into big blocks and is never freed on its own, all of it goes at once when the arena is reset.
+ * every string is interned, so items with the same name or description (common when the machines
+ * of a fleet share a catalog) share one copy.
+ * there is only the one arena, StringArena::catalog(), the machines share it and it's only reset by a
+ * machine reloading when no other machine is using it. it can be used from several threads
+ **/
+class StringArena
+{
+public:
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    /**
+     * @brief Get the arena the Stock text is stored in
+     * @return The arena
+    */
+    static StringArena& catalog();
+
+    /**
+     * @brief Get the copy of some text in the arena, copying it in if it isn't there yet
+     * @param text The text
+     * @return The arena's copy
+     * @throws std::runtime_error if the text is longer than ARENA_MAX_LENGTH or the arena is full
+    */
+    ArenaString intern(const std::string& text);
+
+    /**
+     * @brief Make a string out of text that is already in memory somewhere else and stays there,
+     * e.g. in a file mapped with mapFile. It isn't interned or copied
+     * @param text Where the text starts
+     * @param length The number of characters
+     * @return The string
+     * @throws std::runtime_error if the arena is full
+    */
+    ArenaString external(const char* text, unsigned int length);
+
+    /**
+     * @brief Map a file into memory read only, it stays mapped until the arena is reset.
+     * Nothing is read until the memory is looked at, then only the pages looked at come in from the page cache
+     * @param fileName The file
+     * @return Where the file starts, nullptr for an empty file
+     * @throws std::runtime_error if the file can't be mapped
+    */
+    const char* mapFile(const std::string& fileName);
+
+    /**
+     * @brief Find where a string's length and text are stored
+     * @param handle The string's handle, not 0
+     * @return The 2 byte length, the text comes right after it
+    */
+    const unsigned char* locate(uint32_t handle) const;
+
+    /**
+     * @brief Say that a catalog (a machine) is keeping strings from the arena
+    */
+    void attach();
+
+    /**
+     * @brief Say that a catalog isn't keeping strings from the arena anymore
+    */
+    void detach();
+
+    /**
+     * @brief Free every string at once if no catalog other than the caller's is attached,
+     * the caller must not be keeping any strings from the arena
+     * @return Whether the arena was reset
+    */
+    bool recycle();
+
+    /**
+     * @brief Get what the arena is using
+     * @return The numbers
+    */
+    ArenaStats getStats();
+
+    /**
+     * @brief Get the bytes a std::string of some length takes from the heap, 0 for the ones short enough
+     * to fit inside the std::string itself. Used to compare against the arena
+     * @param length The length of the text
+     * @return Number of bytes
+    */
+    static unsigned long heapBytesFor(unsigned int length);
+
+private:
+    StringArena();
+
+    // room for ARENA_MAX_CHUNKS is reserved up front so a block never moves while another thread reads it
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+
+    // how much of the last block is used
+    unsigned long chunkUsed;
+
+    // the handles of the strings by the hash of their text
+    std::unordered_multimap<uint64_t, uint32_t> strings;
+
+    // the files mapped by mapFile and their sizes
+    std::vector<std::pair<void*, std::size_t>> mappings;
+    ArenaStats stats;
+    unsigned int catalogs;
+    std::mutex mutex;
+
+    /**
+     * @brief Free every block, unmap every file and forget every string
+    */
+    void reset();
+
+    /**
+     * @brief Make room at the end of the last block, starting a new block if it doesn't fit
+     * @param needed The number of bytes
+     * @return The handle of where the room starts
+     * @throws std::runtime_error if the arena is full
+    */
+    uint32_t allocate(unsigned long needed);
+
+    /**
+     * @brief Hash some text (FNV-1a)
+     * @param text The text
+     * @param length The number of characters
+     * @return The hash
+    */
+    static uint64_t hashText(const char* text, unsigned int length);
+};
+
+#endif // STRING_ARENA_H
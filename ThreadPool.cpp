@@ -0,0 +1,156 @@
+#include "ThreadPool.h"
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local unsigned int ThreadPool::currentWorker = 0;
+
+ThreadPool::ThreadPool(unsigned int numThreads): queued(0), pending(0), steals(0), nextQueue(0), stopping(false)
+{
+    //hardware_concurrency can return 0 if it doesn't know
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+
+    //only start the threads after all the queues exist since they steal from each other
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(const std::function<void()>& task)
+{
+    //tasks from a worker stay local, everything else is spread round robin
+    unsigned int index = 0;
+    if (currentPool == this)
+    {
+        index = currentWorker;
+    }
+    else
+    {
+        index = nextQueue.fetch_add(1) % queues.size();
+    }
+
+    ++pending;
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(task);
+    }
+
+    //take the sleep lock so a worker can't miss the wake up between checking and sleeping
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        ++queued;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(sleepLock);
+    allDone.wait(guard, [this](){
+        return pending == 0;
+    });
+}
+
+unsigned int ThreadPool::size() const
+{
+    return workers.size();
+}
+
+unsigned long ThreadPool::getStealCount() const
+{
+    return steals;
+}
+
+bool ThreadPool::tryTake(unsigned int index, std::function<void()>& task)
+{
+    bool found = false;
+
+    //newest task from our own queue first since it is the most likely to be in cache
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        if (!queues[index]->tasks.empty())
+        {
+            task = std::move(queues[index]->tasks.back());
+            queues[index]->tasks.pop_back();
+            found = true;
+        }
+    }
+
+    //otherwise steal the oldest task from the other workers, starting with our neighbour
+    for (unsigned int i = 1; i < queues.size() && !found; ++i)
+    {
+        WorkerQueue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+            ++steals;
+        }
+    }
+
+    if (found)
+    {
+        --queued;
+    }
+
+    return found;
+}
+
+void ThreadPool::workerLoop(unsigned int index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    bool quit = false;
+    std::function<void()> task;
+
+    while (!quit)
+    {
+        if (tryTake(index, task))
+        {
+            task();
+            task = nullptr;
+
+            //the last task to finish wakes up wait()
+            if (--pending == 0)
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                allDone.notify_all();
+            }
+        }
+        else
+        {
+            //nothing to do anywhere, sleep until something gets submitted
+            std::unique_lock<std::mutex> guard(sleepLock);
+            workAvailable.wait(guard, [this](){
+                return stopping || queued > 0;
+            });
+            quit = stopping && queued == 0;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/**
+ * a work stealing thread pool.
+ * every worker has its own queue of tasks, it takes its newest task first
+ * and when it runs out it steals the oldest task from another worker.
+ * tasks submitted from inside a task go to the queue of the worker running it
+ **/
+class ThreadPool
+{
+public:
+    /**
+     * @brief Start the worker threads
+     * @param numThreads Number of workers, 0 means one per core
+    */
+    ThreadPool(unsigned int numThreads = 0);
+
+    // waits for the queued tasks then stops the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task to be run by one of the workers
+     * @param task The task to run
+    */
+    void submit(const std::function<void()>& task);
+
+    /**
+     * @brief Block until every submitted task (including ones they submitted) has finished
+    */
+    void wait();
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Number of workers
+    */
+    unsigned int size() const;
+
+    /**
+     * @brief Get how many tasks were stolen from another worker's queue
+     * @return Number of stolen tasks
+    */
+    unsigned long getStealCount() const;
+
+private:
+    // the queue of tasks belonging to one worker
+    struct WorkerQueue
+    {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    // used to put idle workers to sleep and to wake up wait()
+    std::mutex sleepLock;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+
+    // tasks sitting in a queue, and tasks submitted but not finished yet
+    std::atomic<unsigned long> queued;
+    std::atomic<unsigned long> pending;
+    std::atomic<unsigned long> steals;
+    std::atomic<unsigned int> nextQueue;
+    bool stopping;
+
+    // which pool and worker the current thread belongs to, so submit() can use the local queue
+    static thread_local ThreadPool* currentPool;
+    static thread_local unsigned int currentWorker;
+
+    /**
+     * @brief The loop each worker thread runs until the pool is stopped
+     * @param index The worker index
+    */
+    void workerLoop(unsigned int index);
+
+    /**
+     * @brief Take the newest task from our own queue or steal the oldest from another one
+     * @param index The worker index
+     * @param task Where the task gets stored
+     * @return Whether a task was found
+    */
+    bool tryTake(unsigned int index, std::function<void()>& task);
+};
+
+#endif // THREAD_POOL_H
@@ -1,18 +1,353 @@
 #include "VendingMachine.h"
 
-VendingMachine::VendingMachine() {};
+VendingMachine::VendingMachine(): output(&std::cout), liveState(nullptr), creditTable(nullptr), analytics(nullptr), planner(nullptr), nameIndex(nullptr), descriptionIndex(nullptr),
+    priceIndex(nullptr), onHandIndex(nullptr), stockTable(nullptr), snapshots(nullptr), catalogRcu(nullptr), counters(nullptr), lazyDescriptions(false)
+{
+    StringArena::catalog().attach();
+};
+
+VendingMachine::~VendingMachine()
+{
+    //free the items before saying we're done with their text
+    stockList.clear();
+    StringArena::catalog().detach();
+}
+
+void VendingMachine::setOutput(std::ostream& out)
+{
+    output = &out;
+}
+
+void VendingMachine::setLiveState(LiveState& state)
+{
+    liveState = &state;
+    publishAll();
+}
+
+void VendingMachine::setCreditTable(CreditTable& table)
+{
+    creditTable = &table;
+}
+
+void VendingMachine::setAnalytics(SalesAnalytics& salesAnalytics)
+{
+    analytics = &salesAnalytics;
+}
+
+void VendingMachine::setPlanner(RestockPlanner& restockPlanner)
+{
+    planner = &restockPlanner;
+}
+
+void VendingMachine::setNameIndex(NameIndex& index)
+{
+    nameIndex = &index;
+    indexAll();
+}
+
+void VendingMachine::setDescriptionIndex(DescriptionIndex& index)
+{
+    descriptionIndex = &index;
+    indexAll();
+}
+
+void VendingMachine::setSortedIndexes(SortedIndex& byPrice, SortedIndex& byOnHand)
+{
+    priceIndex = &byPrice;
+    onHandIndex = &byOnHand;
+    indexAll();
+}
+
+void VendingMachine::setStockTable(StockTable& table)
+{
+    stockTable = &table;
+    indexAll();
+}
+
+void VendingMachine::setSnapshotStore(SnapshotStore& store)
+{
+    snapshots = &store;
+    indexAll();
+}
+
+void VendingMachine::setCatalogRcu(CatalogRcu& catalog)
+{
+    catalogRcu = &catalog;
+    indexAll();
+}
+
+void VendingMachine::setCounterFile(CounterFile& file)
+{
+    counters = &file;
+    if (file.matchesTextFiles())
+    {
+        //the counters were changed after the text files were written, a slot missing is an item removed since
+        std::vector<unsigned int> removed;
+        unsigned int index = 0;
+        stockList.forEach([&file, &removed, &index](Stock& stock){
+            if (file.hasItem(stock.getNumber()))
+            {
+                stock.setOnHand(file.getOnHand(stock.getNumber()));
+            }
+            else
+            {
+                removed.push_back(index);
+            }
+            index++;
+        });
+        //from the back, so the indexes still to go don't move
+        for (std::vector<unsigned int>::reverse_iterator it = removed.rbegin(); it != removed.rend(); ++it)
+        {
+            stockList.removeAt(*it);
+        }
+        for (Coin& coin : coinList) {
+            coin.setCoinCount(file.getCoinCount(coin.getDenom()));
+        }
+        indexAll();
+    }
+    publishAll();
+    file.markTextFilesSaved();
+}
+
+void VendingMachine::setLazyDescriptions(bool lazy)
+{
+    lazyDescriptions = lazy;
+}
+
+void VendingMachine::indexAll()
+{
+    if (nameIndex != nullptr)
+    {
+        nameIndex->clear();
+        stockList.forEach([this](const Stock& stock){
+            nameIndex->insert(stock);
+        });
+    }
+    if (descriptionIndex != nullptr)
+    {
+        descriptionIndex->clear();
+        stockList.forEach([this](const Stock& stock){
+            descriptionIndex->insert(stock);
+        });
+    }
+    if (priceIndex != nullptr)
+    {
+        priceIndex->clear();
+        onHandIndex->clear();
+        stockList.forEach([this](const Stock& stock){
+            priceIndex->update(stock);
+            onHandIndex->update(stock);
+        });
+    }
+    if (stockTable != nullptr)
+    {
+        stockTable->clear();
+        stockList.forEach([this](const Stock& stock){
+            stockTable->insert(stock);
+        });
+    }
+    if (snapshots != nullptr)
+    {
+        snapshots->clear();
+        stockList.forEach([this](const Stock& stock){
+            snapshots->insert(stock);
+        });
+    }
+    if (catalogRcu != nullptr)
+    {
+        catalogRcu->rebuild(stockList);
+    }
+}
+
+void VendingMachine::publishAll()
+{
+    if (liveState != nullptr)
+    {
+        liveState->beginWrite();
+        liveState->clearItems();
+        stockList.forEach([this](const Stock& stock){
+            liveState->setItem(stock.getId(), stock.getOnHand(), stock.getPrice().getValue());
+        });
+        for (const Coin& coin : coinList) {
+            liveState->setCoinCount(coin.getDenom(), coin.getCount());
+        }
+        liveState->endWrite();
+    }
+    if (onHandIndex != nullptr)
+    {
+        stockList.forEach([this](const Stock& stock){
+            onHandIndex->update(stock);
+        });
+    }
+    if (counters != nullptr)
+    {
+        counters->clearItems();
+        stockList.forEach([this](const Stock& stock){
+            counters->setItem(stock.getNumber(), stock.getOnHand());
+        });
+        for (const Coin& coin : coinList) {
+            counters->setCoinCount(coin.getDenom(), coin.getCount());
+        }
+        counters->commit();
+    }
+}
+
+void VendingMachine::publishItem(const Stock& stock)
+{
+    if (liveState != nullptr)
+    {
+        liveState->beginWrite();
+        liveState->setItem(stock.getId(), stock.getOnHand(), stock.getPrice().getValue());
+        liveState->endWrite();
+    }
+    if (onHandIndex != nullptr)
+    {
+        onHandIndex->update(stock);
+    }
+    if (stockTable != nullptr)
+    {
+        stockTable->update(stock);
+    }
+    if (snapshots != nullptr)
+    {
+        snapshots->update(stock);
+    }
+    if (catalogRcu != nullptr)
+    {
+        //only the count changed, it doesn't need a new version
+        catalogRcu->setOnHand(stock.getNumber(), stock.getOnHand());
+    }
+    if (counters != nullptr)
+    {
+        counters->setItem(stock.getNumber(), stock.getOnHand());
+        counters->commit();
+    }
+}
+
+void VendingMachine::itemRemoved(const std::string& itemId)
+{
+    if (liveState != nullptr)
+    {
+        liveState->beginWrite();
+        liveState->removeItem(itemId);
+        liveState->endWrite();
+    }
+    if (analytics != nullptr)
+    {
+        analytics->removeItem(itemId);
+    }
+    if (planner != nullptr)
+    {
+        planner->removeItem(itemId);
+    }
+    if (nameIndex != nullptr)
+    {
+        nameIndex->remove(itemId);
+    }
+    if (descriptionIndex != nullptr)
+    {
+        descriptionIndex->remove(itemId);
+    }
+    if (priceIndex != nullptr)
+    {
+        priceIndex->remove(itemId);
+        onHandIndex->remove(itemId);
+    }
+    if (stockTable != nullptr)
+    {
+        stockTable->remove(itemId);
+    }
+    if (snapshots != nullptr)
+    {
+        snapshots->remove(itemId);
+    }
+    if (catalogRcu != nullptr)
+    {
+        catalogRcu->remove(itemId);
+    }
+    if (counters != nullptr)
+    {
+        counters->removeItem(Stock::idToNumber(itemId));
+        counters->commit();
+    }
+}
+
+void VendingMachine::itemSold(const Stock& stock)
+{
+    //the item, the coins and the sale change together so readers see all of it or none of it
+    if (liveState != nullptr)
+    {
+        liveState->beginWrite();
+        liveState->setItem(stock.getId(), stock.getOnHand(), stock.getPrice().getValue());
+        for (const Coin& coin : coinList) {
+            liveState->setCoinCount(coin.getDenom(), coin.getCount());
+        }
+        liveState->recordSale(stock.getId(), stock.getPrice().getValue());
+        liveState->endWrite();
+    }
+    if (analytics != nullptr)
+    {
+        analytics->recordSale(stock.getId(), stock.getPrice().getValue());
+    }
+    if (planner != nullptr)
+    {
+        planner->recordSale(stock.getId());
+    }
+    if (onHandIndex != nullptr)
+    {
+        onHandIndex->update(stock);
+    }
+    if (stockTable != nullptr)
+    {
+        stockTable->update(stock);
+    }
+    if (snapshots != nullptr)
+    {
+        snapshots->update(stock);
+    }
+    if (catalogRcu != nullptr)
+    {
+        catalogRcu->setOnHand(stock.getNumber(), stock.getOnHand());
+    }
+    if (counters != nullptr)
+    {
+        //the item and the coins in one commit
+        counters->setItem(stock.getNumber(), stock.getOnHand());
+        for (const Coin& coin : coinList) {
+            counters->setCoinCount(coin.getDenom(), coin.getCount());
+        }
+        counters->commit();
+    }
+}
 
 void VendingMachine::load(const std::string& stockFile, const std::string& coinFile)
 {
-    //clear the lists in case we are reloading more
-    coinList.clear();
+    ScopedTimer timer(TIMER_LOAD);
+
+    //a save still being written in the background needs the old text
+    if (snapshots != nullptr)
+    {
+        snapshots->waitForSaves();
+    }
+
+    //clear the list in case we are reloading more, every coin gets replaced by the load
     stockList.clear();
 
+    //the published versions point at the names in the arena, so every reader has to be out of them first
+    if (catalogRcu != nullptr)
+    {
+        catalogRcu->clear();
+        catalogRcu->synchronize();
+    }
+
+    //the old names and descriptions all go in one go, unless another machine still uses the arena
+    StringArena::catalog().recycle();
+
     std::vector<Stock> stockVector;
 
     //try to load the the stock file and coin file else rethrow the error
     try{
-        stockVector = Helper::tryLoadStockFile(stockFile);
+        stockVector = Helper::tryLoadStockFile(stockFile, lazyDescriptions);
         coinList = Helper::tryLoadCoinsFile(coinFile);
     }
     catch (const std::runtime_error& e){
@@ -28,20 +363,41 @@ void VendingMachine::load(const std::string& stockFile, const std::string& coinF
         stockList.prepend(stockVector[i]);
     }
 
-    //sort the coin list be increasing order of the denomination value
-    std::sort(coinList.begin(), coinList.end(), [](const Coin& a, const Coin& b){
-        return Helper::denomToValue(a.getDenom()) < Helper::denomToValue(b.getDenom());
-    });
+    indexAll();
+    publishAll();
 }
 
 void VendingMachine::save(const std::string& stockFile, const std::string& coinFile)
 {
+    ScopedTimer timer(TIMER_SAVE);
+
+    //don't write the files while a background save is writing them too
+    if (snapshots != nullptr)
+    {
+        snapshots->waitForSaves();
+    }
+
     //save the coinList into a file
     Helper::saveCoinList(coinFile, coinList);
     //save the stockList into a file
     Helper::saveStockList(stockFile, stockList);
-    std::cout << "Stock list and coin list has been saved" << std::endl;
-    std::cout << std::endl;
+    if (counters != nullptr)
+    {
+        //the text files have the same counts now, so they're in step with the counters again
+        counters->markTextFilesSaved();
+    }
+    *output << "Stock list and coin list has been saved" << std::endl;
+    *output << std::endl;
+}
+
+void VendingMachine::saveInBackground(const std::string& stockFile, const std::string& coinFile)
+{
+    ScopedTimer timer(TIMER_SAVE);
+
+    //only the current version is kept here, the background thread writes it out
+    snapshots->saveInBackground(coinList, stockFile, coinFile, counters);
+    *output << "Stock list and coin list are being saved in the background" << std::endl;
+    *output << std::endl;
 }
 
 void VendingMachine::resetStock()
@@ -50,8 +406,59 @@ void VendingMachine::resetStock()
     stockList.forEach([](Stock& stock){
         stock.setOnHand(DEFAULT_STOCK_LEVEL);
     });
-    std::cout << "All stock has been reset to the default level of " << DEFAULT_STOCK_LEVEL << std::endl;
-    std::cout << std::endl;
+    if (stockTable != nullptr)
+    {
+        //every row gets the same amount so the whole column is filled in one go
+        stockTable->fillOnHand(DEFAULT_STOCK_LEVEL);
+    }
+    if (snapshots != nullptr)
+    {
+        stockList.forEach([this](const Stock& stock){
+            snapshots->update(stock);
+        });
+    }
+    if (catalogRcu != nullptr)
+    {
+        //one new version for the whole reset
+        catalogRcu->rebuild(stockList);
+    }
+    publishAll();
+    *output << "All stock has been reset to the default level of " << DEFAULT_STOCK_LEVEL << std::endl;
+    *output << std::endl;
+}
+
+void VendingMachine::smartResetStock()
+{
+    if (planner == nullptr)
+    {
+        *output << "The restock planner is turned off, run with --planner to turn it on" << std::endl;
+    }
+    else
+    {
+        //one pass over stockList, each item is topped up to its own recommended level, stock above it stays
+        double time = RestockPlanner::now();
+        unsigned int added = 0;
+        stockList.forEach([this, time, &added](Stock& stock){
+            RestockAdvice advice = planner->advise(stock, time);
+            added += advice.toAdd;
+            stock.setOnHand(std::max(stock.getOnHand(), advice.level));
+            if (stockTable != nullptr)
+            {
+                stockTable->update(stock);
+            }
+            if (snapshots != nullptr)
+            {
+                snapshots->update(stock);
+            }
+        });
+        if (catalogRcu != nullptr)
+        {
+            catalogRcu->rebuild(stockList);
+        }
+        publishAll();
+        *output << "All stock has been topped up to the levels recommended by the restock planner (" << added << " items added)" << std::endl;
+    }
+    *output << std::endl;
 }
 
 void VendingMachine::resetCoin()
@@ -60,84 +467,83 @@ void VendingMachine::resetCoin()
     for (Coin& coin : coinList) {
         coin.setCoinCount(DEFAULT_COIN_COUNT);
     }
-    std::cout << "All coins have been reset to the default level of " << DEFAULT_COIN_COUNT << std::endl;
-    std::cout << std::endl;
+    publishAll();
+    *output << "All coins have been reset to the default level of " << DEFAULT_COIN_COUNT << std::endl;
+    *output << std::endl;
 }
 
-unsigned int VendingMachine::getUserItemIndexPersistent(const std::string& prompt)
+unsigned int VendingMachine::getAvailable(const Stock& stock) const
 {
-    //call getUserInputPersistent with the following validating lambda
-    return Helper::getUserInputPersistent<unsigned int>(prompt, [this](const std::string& s) {
-        std::string itemId = "";
-
-        //check if the input item id is valid
-        try{
-            itemId = Helper::tryParseItemId(s);
-        }
-        catch(const std::runtime_error& e) {
-            throw std::runtime_error(e.what());
-        }
-
-        //check if the input item id exists in the stockList
-        unsigned int foundIndex = LinkedList::invalidPos;
-
-        foundIndex = this->stockList.findFirst([&itemId](const Stock& stock){
-            return stock.getId() == itemId;
-        });
-
-        if (foundIndex == LinkedList::invalidPos)
-        {
-            throw std::runtime_error("Item Id does not exist");
-        }
-
-        return foundIndex;
-    });
+    unsigned int available = stock.getOnHand();
+    auto found = reserved.find(stock.getNumber());
+    if (found != reserved.end())
+    {
+        //a reset can leave less on hand than is reserved
+        available = available > found->second ? available - found->second : 0;
+    }
+    return available;
 }
 
-std::string VendingMachine::getUserNamePersistent(const std::string& prompt)
+void VendingMachine::reserveItem(const Stock& stock)
 {
-    //call getUserInputPersistent with tryParseName validator
-    return Helper::getUserInputPersistent<std::string>(prompt, Helper::tryParseName);
+    reserved[stock.getNumber()]++;
 }
 
-std::string VendingMachine::getUserDescriptionPersistent(const std::string& prompt)
+void VendingMachine::releaseItem(const std::string& itemId)
 {
-    //call getUserInputPersistent with tryParseDescription validator
-    return Helper::getUserInputPersistent<std::string>(prompt, Helper::tryParseDescription);
+    auto found = reserved.find(Stock::idToNumber(itemId));
+    if (found != reserved.end())
+    {
+        found->second--;
+        if (found->second == 0)
+        {
+            reserved.erase(found);
+        }
+    }
 }
 
-Price VendingMachine::getUserPricePersistent(const std::string& prompt)
+unsigned int VendingMachine::findItemIndex(const std::string& itemId) const
 {
-    //call getUserInputPersistent with tryParsePrice validator
-    return Helper::getUserInputPersistent<Price>(prompt, Helper::tryParsePrice);
+    ScopedTimer timer(TIMER_ITEM_LOOKUP);
+    //compare the numbers, not the id strings
+    unsigned int number = Stock::idToNumber(itemId);
+    unsigned int index = LinkedList::invalidPos;
+    if (catalogRcu != nullptr)
+    {
+        //the published version has the items in list order, so an item's row is its index in stockList
+        int row = catalogRcu->read().rowOf[number];
+        index = row >= 0 ? row : LinkedList::invalidPos;
+    }
+    else
+    {
+        index = stockList.findFirst([number](const Stock& stock){
+            return stock.getNumber() == number;
+        });
+    }
+    return index;
 }
 
-Denomination VendingMachine::getUserDenomPersistent(const std::string& prompt)
+unsigned int VendingMachine::tryFindItemIndex(const std::string& s) const
 {
-    //call getUserInputPersistent with the following validating lambda
-    return Helper::getUserInputPersistent<Denomination>(prompt, [](const std::string s) {
-        Denomination denom = FIVE_CENTS;
-        unsigned int denomVal = 0;
+    std::string itemId = "";
 
-        //check if the input denom is an integer
-        try{
-            denomVal = Helper::tryParseInt(s);
-        }
-        catch(const std::runtime_error& e){
-            throw std::runtime_error("Denomination needs to be a valid integer");
-        }
+    //check if the input item id is valid
+    try{
+        itemId = Helper::tryParseItemId(s);
+    }
+    catch(const std::runtime_error& e) {
+        throw std::runtime_error(e.what());
+    }
 
-        //check if the input denom integer is an actual denom value
-        try{
-            denom = Helper::tryParseDenom(denomVal);
-        }
-        catch(const std::runtime_error& e){
-            std::string priceString = Helper::valueToPrice(denomVal).getString();
-            throw std::runtime_error(priceString + " is not a valid denomination of money");
-        }
+    //check if the input item id exists in the stockList
+    unsigned int foundIndex = findItemIndex(itemId);
 
-        return denom;
-    });
+    if (foundIndex == LinkedList::invalidPos)
+    {
+        throw std::runtime_error("Item Id does not exist");
+    }
+
+    return foundIndex;
 }
 
 std::string VendingMachine::generateNextId()
@@ -154,8 +560,7 @@ std::string VendingMachine::generateNextId()
     //get all the item ids as a list of integers
     //ASSUMPTION: all item ids are an integer past the first character (we did not modify them elsewhere)
     std::vector<int> ids = stockList.getTransformedValues<int>([](const Stock& s){
-        int numberPartStartIndex = 1;
-        return Helper::tryParseInt(s.getId().substr(numberPartStartIndex));
+        return s.getNumber();
     });
 
     //sort the item ids so we can find the gap id
@@ -190,124 +595,129 @@ std::string VendingMachine::generateNextId()
     return result;
 }
 
-Stock VendingMachine::getUserItem(const std::string& newItemId)
+void VendingMachine::insertItemSorted(const Stock& newItem)
 {
-    std::cout << "The id of the new stock will be: " << newItemId << std::endl;
-
-    std::string name = "";
-    std::string desc = "";
-    Price price;
+    //find the index to insert before so we can keep the ascending order of item names
+    //ASSUMPTION: stockList is already sorted (we did not modify it elsewhere)
+    unsigned int insertBeforeIndex = stockList.findFirst([&newItem](const Stock& s){
+        return Helper::stringLower(newItem.getName()) <= Helper::stringLower(s.getName());
+    });
 
-    //try to get the item name, descrition and price from the user
-    try{
-        name = getUserNamePersistent("Enter the item name: ");
-        desc = getUserDescriptionPersistent("Enter the item description: ");
-        price = getUserPricePersistent("Enter the price for the item: ");
+    if (stockList.empty())
+    {
+        insertBeforeIndex = 0;
+        stockList.prepend(newItem);
     }
-    catch(const std::exception& e)
+    else if (insertBeforeIndex == LinkedList::invalidPos)
     {
-        throw std::runtime_error("Terminated add item");
+        insertBeforeIndex = stockList.size();
+        stockList.append(newItem);
+    }
+    else
+    {
+        stockList.insertBefore(insertBeforeIndex, newItem);
     }
 
-    //if we succeeded, create the stock item
-    Stock stock(newItemId, name, desc, price, DEFAULT_STOCK_LEVEL);
-    return stock;
+    //the indexes point at the copy in stockList, which is now where insertBeforeIndex was
+    if (nameIndex != nullptr)
+    {
+        nameIndex->insert(stockList.at(insertBeforeIndex));
+    }
+    if (descriptionIndex != nullptr)
+    {
+        descriptionIndex->insert(stockList.at(insertBeforeIndex));
+    }
+    if (priceIndex != nullptr)
+    {
+        priceIndex->update(stockList.at(insertBeforeIndex));
+    }
+    if (stockTable != nullptr)
+    {
+        stockTable->insert(stockList.at(insertBeforeIndex));
+    }
+    if (snapshots != nullptr)
+    {
+        snapshots->insert(stockList.at(insertBeforeIndex));
+    }
+    if (catalogRcu != nullptr)
+    {
+        catalogRcu->insert(insertBeforeIndex, stockList.at(insertBeforeIndex));
+    }
+    publishItem(stockList.at(insertBeforeIndex));
 }
 
-void VendingMachine::addUserItem()
+bool VendingMachine::takePayment(const unsigned int coinsPutIn[NUM_DENOMS], unsigned int change, unsigned int coinsOut[NUM_DENOMS])
 {
-    std::string newItemId = "";
-    Stock newItem;
-    bool success = true;
-    std::string terminatedMsg = "Terminated add item";
-
-    //try to generate the new item id
-    try {
-        newItemId = generateNextId();
-    } catch(const std::runtime_error& e) {
-        success = false;
-        std::cout << ERROR_PREFIX << e.what() << std::endl;
-        std::cout << terminatedMsg << std::endl;
-    }
-    
-    //we were able to generate the item id, now try to prompt the item info from the user
-    if (success)
-    {
-        try {
-            newItem = getUserItem(newItemId);
-        } catch(const std::runtime_error& e) {
-            success = false;
-            std::cout << terminatedMsg << std::endl;
-        }
+    bool foundChange = true;
+    std::fill(coinsOut, coinsOut + NUM_DENOMS, 0);
+
+    //put the coins the user put in, into the system, just in case we need them for change
+    for (unsigned int denom = 0; denom < NUM_DENOMS; ++denom)
+    {
+        coinList[denom].addCoinCount(coinsPutIn[denom]);
     }
 
-    //we were able to get the item info from the user, now add the item to the stockList
-    if (success)
+    //if there is change, we need to calculate which coins to give to the user
+    if (change > 0)
     {
-        //find the index to insert before so we can keep the ascending order of item names
-        //ASSUMPTION: stockList is already sorted (we did not modify it elsewhere)
-        //DISCLAIMER: this does two linear searches but I don't care
-        unsigned int insertBeforeIndex = stockList.findFirst([&newItem](const Stock& s){
-            return Helper::stringLower(newItem.getName()) <= Helper::stringLower(s.getName());
-        });
+        ScopedTimer timer(TIMER_CHANGE);
+        foundChange = Helper::getBestCoinCombination(change, coinList, coinsOut);
+    }
 
-        if (stockList.empty())
-        {
-            stockList.prepend(newItem);
-        }
-        else if (insertBeforeIndex == LinkedList::invalidPos)
+    for (unsigned int denom = 0; denom < NUM_DENOMS; ++denom)
+    {
+        if (foundChange)
         {
-            stockList.append(newItem);
+            //remove the change from the coinList
+            coinList[denom].removeCoinCount(coinsOut[denom]);
         }
         else
         {
-            stockList.insertBefore(insertBeforeIndex, newItem);
+            //take the coins back out from the system and give it back to the user
+            coinList[denom].removeCoinCount(coinsPutIn[denom]);
         }
-
-        std::cout << "\"" << newItem.getId() << " - " << newItem.getName() << " - " << newItem.getDescription() <<  "\" has been added to the menu." << std::endl;
     }
-    std::cout << std::endl;
+
+    return foundChange;
 }
 
-void VendingMachine::removeUserItem()
+void VendingMachine::printChange(std::ostream& os, const unsigned int coinsOut[NUM_DENOMS]) const
 {
-    bool success = true;
-    std::string terminatedMsg = "Terminated Remove Item";
-
-    //make sure the stockList is not empty so we can actually remove an item
-    if (stockList.empty())
+    //loop from the back so we can print out change from highest to lowest
+    for (int denom = NUM_DENOMS - 1; denom >= 0; --denom)
     {
-        success = false;
-        std::cout << ERROR_PREFIX << "Cannot remove more items from an empty stock list" << std::endl;
-        std::cout << terminatedMsg << std::endl;
-    }
+        unsigned int denomAmountOut = coinsOut[denom];
 
-    //after making sure the stockList is not empty, try to find the index of the item in stockList
-    unsigned int foundItemIndex = LinkedList::invalidPos;
-    if (success)
-    {
-        try{
-            foundItemIndex = getUserItemIndexPersistent("Enter the item id of the item to remove from the menu: ");
-        } catch(const std::exception& e){
-            success = false;
-            std::cout << terminatedMsg << std::endl;
+        if (denomAmountOut > 1) {
+            os << denomAmountOut << "X";
         }
-    }
 
-    //if we haven't terminated yet, remove the item in the stockList at the found index
-    //DISCLAIMER: this does two linear searches but I don't care
-    if (success)
-    {
-        Stock removedStock = stockList.removeAt(foundItemIndex);
-        std::cout << "\"" << removedStock.getId() <<  " - " << removedStock.getName() << " - " << removedStock.getDescription() << 
-            "\" has been removed from the system." << std::endl;
+        if (denomAmountOut > 0) {
+            os << DenominationSet::active().getShortLabel(static_cast<Denomination>(denom)) << " ";
+        }
     }
+}
+
+void VendingMachine::addUserItem()
+{
+    //drive the add item session from the console
+    ConsoleInput console;
+    AddItemSession session(*this, *output);
+    session.run(console);
+}
 
-    std::cout << std::endl;
+void VendingMachine::removeUserItem()
+{
+    //drive the remove item session from the console
+    ConsoleInput console;
+    RemoveItemSession session(*this, *output);
+    session.run(console);
 }
 
 void VendingMachine::displayCoins()
 {
+    ScopedTimer timer(TIMER_DISPLAY);
+
     //display the coins with the correct allignment and stuff
     int denomWidth = 16;
     int countWidth = 10;
@@ -316,18 +726,18 @@ void VendingMachine::displayCoins()
     int rowCharLen = denomWidth + countWidth + COIN_ATTRIB - 1;
     std::string title = "Coins Summary";
 
-    std::cout << title << std::endl;
-    std::cout << std::string(title.length(), horizontalSep) << std::endl;
-    std::cout << std::left << std::setw(denomWidth) << "Denomination" << verticalSep << std::right << std::setw(countWidth) << "Count " << std::endl;
-    std::cout << std::string(rowCharLen, horizontalSep) << std::endl;
-    for (Coin coin: coinList)
+    *output << title << std::endl;
+    *output << std::string(title.length(), horizontalSep) << std::endl;
+    *output << std::left << std::setw(denomWidth) << "Denomination" << verticalSep << std::right << std::setw(countWidth) << "Count " << std::endl;
+    *output << std::string(rowCharLen, horizontalSep) << std::endl;
+    for (const Coin& coin: coinList)
     {
-        std::cout << std::left << std::setw(denomWidth) << Helper::denomToString(coin.getDenom()) << verticalSep << std::right << std::setw(countWidth) << coin.getCount() << std::endl;
+        *output << std::left << std::setw(denomWidth) << DenominationSet::active().getLabel(coin.getDenom()) << verticalSep << std::right << std::setw(countWidth) << coin.getCount() << std::endl;
     }
-    std::cout << std::endl;
+    *output << std::endl;
 }
 
-void VendingMachine::displayStock() 
+int VendingMachine::printItemsHeader(const std::string& title)
 {
     //display the items with the correct allignment and stuff
     int idWidth = 5;
@@ -337,174 +747,321 @@ void VendingMachine::displayStock()
     char horizontalSep = '-';
     char verticalSep = '|';
     int rowCharLen = idWidth + nameWidth + availableWidth + priceWidth + STOCK_ATTRIB - 2;
-    std::string title = "Items Menu";
-
-    std::cout << title << std::endl;
-    std::cout << std::string(title.length(), horizontalSep) << std::endl;
-    std::cout << std::left << std::setw(idWidth) << "ID" << verticalSep << std::left << std::setw(nameWidth) << "Name" << verticalSep << std::left << std::setw(availableWidth) << " Available" << verticalSep << std::left << std::setw(priceWidth) << " Price" << std::endl;
-    std::cout << std::string(rowCharLen, horizontalSep) << std::endl;
-    stockList.forEach([=, &title](Stock& stock){
-        //woah what is this?
-        //"=" means to pass in all the local variables into this lambda
-        //"&title" is here because I don't want to copy it
-        std::cout << std::left << std::setw(idWidth) << stock.getId() << verticalSep << std::left << std::setw(nameWidth) << stock.getName() << verticalSep << std::left << std::setw(availableWidth) << stock.getOnHand() << verticalSep << std::left << std::setw(priceWidth) << stock.price.getString() << std::endl;
+
+    *output << title << std::endl;
+    *output << std::string(title.length(), horizontalSep) << std::endl;
+    *output << std::left << std::setw(idWidth) << "ID" << verticalSep << std::left << std::setw(nameWidth) << "Name" << verticalSep << std::left << std::setw(availableWidth) << " Available" << verticalSep << std::left << std::setw(priceWidth) << " Price" << std::endl;
+    *output << std::string(rowCharLen, horizontalSep) << std::endl;
+
+    return rowCharLen;
+}
+
+void VendingMachine::printItemRow(const Stock& stock)
+{
+    int idWidth = 5;
+    int nameWidth = 40;
+    int availableWidth = 11;
+    int priceWidth = 8;
+    char verticalSep = '|';
+
+    *output << std::left << std::setw(idWidth) << stock.getId() << verticalSep << std::left << std::setw(nameWidth) << stock.name << verticalSep << std::left << std::setw(availableWidth) << stock.getOnHand() << verticalSep << std::left << std::setw(priceWidth) << stock.getPriceString() << std::endl;
+}
+
+void VendingMachine::displayStock() 
+{
+    ScopedTimer timer(TIMER_DISPLAY);
+
+    int rowCharLen = printItemsHeader("Items Menu");
+    stockList.forEach([this](const Stock& stock){
+        printItemRow(stock);
     });
 
     //if the stockList is empty print a center alligned special message
     if (stockList.empty())
     {
         std::string emptyMsg = "EMPTY ITEM LIST ;(";
-        std::cout << std::string((rowCharLen - emptyMsg.length()) / 2, ' ') << emptyMsg << std::endl;
+        *output << std::string((rowCharLen - emptyMsg.length()) / 2, ' ') << emptyMsg << std::endl;
     }
-    std::cout << std::endl;
+    *output << std::endl;
 }
 
-void VendingMachine::purchaseItem()
+void VendingMachine::displayItemList(const std::string& title, const std::vector<const Stock*>& items)
 {
-    //Oh boy this one was hard to implement.
-
-    std::string terminatedMsg = "Terminated Purchase Item";
+    ScopedTimer timer(TIMER_DISPLAY);
 
-    //try to get the index of the item in the stock list from the user's entered item id string
-    bool interrupted = false;
-    unsigned int purchaseItemIndex = LinkedList::invalidPos;
-    try {
-        purchaseItemIndex = getUserItemIndexPersistent("Please enter the id of the item you wish to purchase: ");
-    }
-    catch(const std::exception& e) {
-        interrupted = true;
-        std::cout << terminatedMsg << std::endl;
+    int rowCharLen = printItemsHeader(title);
+    for (const Stock* stock : items)
+    {
+        printItemRow(*stock);
     }
 
-    //had to do nested if statement because of the way references work, please let me have multiple return statements
-    //if we managed to get the index of the item in the stock list
-    if (!interrupted)
+    if (items.empty())
     {
-        //get the reference of the item at the stock list index
-        Stock& stockRef = stockList.at(purchaseItemIndex);
+        std::string emptyMsg = "NO ITEMS FOUND";
+        *output << std::string((rowCharLen - emptyMsg.length()) / 2, ' ') << emptyMsg << std::endl;
+    }
+    *output << std::endl;
+}
 
-        //check if we have the item in stock
-        if (stockRef.getOnHand() == 0)
+void VendingMachine::displaySales()
+{
+    int rankWidth = 5;
+    int idWidth = 5;
+    int nameWidth = 40;
+    int soldWidth = 10;
+    int revenueWidth = 12;
+    char horizontalSep = '-';
+    char verticalSep = '|';
+    std::string title = "Sales Summary";
+
+    *output << title << std::endl;
+    *output << std::string(title.length(), horizontalSep) << std::endl;
+    if (analytics == nullptr)
+    {
+        *output << "Sales analytics are turned off, run with --analytics to turn them on" << std::endl;
+    }
+    else
+    {
+        *output << "Items sold: " << analytics->getTotalSales() << std::endl;
+        *output << "Revenue: " << Helper::valueToPrice(analytics->getTotalRevenue()).getString() << std::endl;
+        *output << std::endl;
+
+        //the best sellers are already in order, we only need their names
+        *output << "Best Sellers" << std::endl;
+        *output << std::left << std::setw(rankWidth) << "Rank" << verticalSep << std::setw(idWidth) << "ID" << verticalSep << std::setw(nameWidth) << "Name"
+            << verticalSep << std::right << std::setw(soldWidth) << "Sold " << verticalSep << std::setw(revenueWidth) << "Revenue " << std::endl;
+        *output << std::string(rankWidth + idWidth + nameWidth + soldWidth + revenueWidth + 4, horizontalSep) << std::endl;
+        std::vector<TopSeller> top = analytics->getTopSellers();
+        for (unsigned int i = 0; i < top.size(); ++i)
         {
-            interrupted = true;
-            std::cout << ERROR_PREFIX << "Cannot purchase that item as there is none left" << std::endl;
-            std::cout << terminatedMsg << std::endl;
+            unsigned int index = findItemIndex(top[i].id);
+            std::string name = index == LinkedList::invalidPos ? "" : stockList.at(index).getName();
+            *output << std::left << std::setw(rankWidth) << i + 1 << verticalSep << std::setw(idWidth) << top[i].id << verticalSep << std::setw(nameWidth) << name
+                << verticalSep << std::right << std::setw(soldWidth) << top[i].sold << verticalSep << std::setw(revenueWidth) << Helper::valueToPrice(top[i].revenue).getString() << std::endl;
         }
-
-        //a dictionary to store the number of each denomination put into the vending machine
-        unsigned int coinsPutIn[NUM_DENOMS] = {0};
-
-        unsigned int moneyTarget = stockRef.getPrice().getValue();
-        unsigned int moneyIn = 0;
-
-        //now we checked that the item is in stock, the user is then prompted to put in denomination until they can afford the item
-        if (!interrupted)
+        *output << std::endl;
+
+        //the hours are printed in UTC, oldest first
+        int hourWidth = 8;
+        long long hoursPerDay = 24;
+        long long now = SalesAnalytics::currentHour();
+        *output << "Last " << ANALYTICS_HOURS << " Hours (UTC)" << std::endl;
+        *output << std::left << std::setw(hourWidth) << "Hour" << verticalSep << std::right << std::setw(soldWidth) << "Sold " << verticalSep << std::setw(revenueWidth) << "Revenue " << std::endl;
+        *output << std::string(hourWidth + soldWidth + revenueWidth + 2, horizontalSep) << std::endl;
+        for (long long hour = now - ANALYTICS_HOURS + 1; hour <= now; ++hour)
         {
-            std::cout << "You have selected \"" << stockRef.getName() << " - " << stockRef.getShortDescription() << "\". This will cost you " << stockRef.getPrice().getString() << "." << std::endl;
-            std::cout << "Please hand over the money - type in the value of each note/coin in cents." << std::endl;
-            std::cout << "Please enter or ctrl-d on a new line to cancel this purchase:" << std::endl;
-
-            //keep prompting the user until they can afford the item or they terminate
-            while (moneyIn < moneyTarget && !interrupted)
-            {
-                unsigned int moneyOwe = moneyTarget - moneyIn;
-                Price priceOwe = Helper::valueToPrice(moneyOwe);
-                Denomination denom = FIVE_CENTS;
-
-                try{
-                    denom = getUserDenomPersistent("You still need to give us " + priceOwe.getString() + ": ");
-                    //if we manage to get a valid denomination value from the user
-                    //increment the number of that denomination put in
-                    //and add to the money put in
-                    coinsPutIn[denom]  += 1;
-                    moneyIn += Helper::denomToValue(denom);
-                }
-                catch(const std::exception& e){
-                    interrupted = true;
-                    std::cout << terminatedMsg << std::endl;
-                }
-            }
+            std::string hourLabel = std::to_string(hour % hoursPerDay) + ":00";
+            *output << std::left << std::setw(hourWidth) << hourLabel << verticalSep << std::right << std::setw(soldWidth) << analytics->getHourlySales(hour)
+                << verticalSep << std::setw(revenueWidth) << Helper::valueToPrice(analytics->getHourlyRevenue(hour)).getString() << std::endl;
         }
+    }
+    *output << std::endl;
+}
 
-        unsigned int change = 0;
+void VendingMachine::displayRestockPlan()
+{
+    int idWidth = 5;
+    int nameWidth = 40;
+    int numWidth = 10;
+    int stockoutWidth = 13;
+    char horizontalSep = '-';
+    char verticalSep = '|';
+    double hoursPerDay = 24;
+    std::string title = "Restock Plan";
 
-        //now that the user has put in enough money and has not terminated, the vending machine needs to give change to the user
-        if (!interrupted)
+    *output << title << std::endl;
+    *output << std::string(title.length(), horizontalSep) << std::endl;
+    if (planner == nullptr)
+    {
+        *output << "The restock planner is turned off, run with --planner to turn it on" << std::endl;
+    }
+    else
+    {
+        *output << std::left << std::setw(idWidth) << "ID" << verticalSep << std::setw(nameWidth) << "Name" << verticalSep << std::right
+            << std::setw(numWidth) << "On Hand " << verticalSep << std::setw(numWidth) << "Per Day " << verticalSep
+            << std::setw(stockoutWidth) << "Runs Out In " << verticalSep << std::setw(numWidth) << "Level " << verticalSep << std::setw(numWidth) << "Add " << std::endl;
+        *output << std::string(idWidth + nameWidth + 4 * numWidth + stockoutWidth + 6, horizontalSep) << std::endl;
+
+        std::ios::fmtflags flags = output->flags();
+        std::streamsize precision = output->precision();
+        *output << std::fixed << std::setprecision(1);
+        for (const RestockAdvice& advice : planner->plan(stockList))
         {
-            //this round was in case if we didn't get a price in multiples of 5
-            //but I guess it doesn't matter anymore since we force the stock file to have prices divisible by 5
-            change = Helper::round(moneyIn - moneyTarget, FIVE_CENTS_VAL);
-
-            //put the coins the user put in, into the system, just in case we need them for change
-            for (Coin& coin: coinList)
-            {
-                Denomination denom = coin.getDenom();
-                coin.addCoinCount(coinsPutIn[denom]);
+            //the rate is shown per day and the time to run out in days or hours
+            std::ostringstream runsOut;
+            runsOut << std::fixed << std::setprecision(1);
+            if (advice.hoursToStockout < 0) {
+                runsOut << "never";
             }
-
-            //if the there is no change, then we don't need to give any coins to the user and the transaction ends
-            if (change == 0)
-            {
-                stockRef.removeOnHand(1);
-                std::cout << "Here is your " << stockRef.getName() << " with no change" << std::endl;
-                interrupted = true;
+            else if (advice.hoursToStockout >= hoursPerDay) {
+                runsOut << advice.hoursToStockout / hoursPerDay << " days";
+            }
+            else {
+                runsOut << advice.hoursToStockout << " hours";
             }
+
+            const Stock& stock = stockList.at(findItemIndex(advice.id));
+            *output << std::left << std::setw(idWidth) << advice.id << verticalSep << std::setw(nameWidth) << stock.getName() << verticalSep << std::right
+                << std::setw(numWidth) << advice.onHand << verticalSep << std::setw(numWidth) << advice.rate * hoursPerDay << verticalSep
+                << std::setw(stockoutWidth) << runsOut.str() << verticalSep << std::setw(numWidth) << advice.level << verticalSep
+                << std::setw(numWidth) << advice.toAdd << std::endl;
         }
+        output->flags(flags);
+        output->precision(precision);
+        *output << "Until the planner has watched for " << RESTOCK_MIN_HISTORY_HOURS << " hours items are restocked to at least the default level of " << DEFAULT_STOCK_LEVEL << std::endl;
+    }
+    *output << std::endl;
+}
 
-        //now we know the user has change, we need to calculate which coins to give to the user
-        if (!interrupted)
-        {   
-            bool foundChange = true;
-            std::vector<unsigned int> coinsOut;
+void VendingMachine::purchaseItem()
+{
+    //drive the purchase session from the console
+    ConsoleInput console;
+    PurchaseSession session(*this, *output);
+    session.run(console);
+}
 
-            try {
-                coinsOut = Helper::getBestCoinCombination(change,  coinList);
-            }
-            catch(const std::runtime_error& e) {
-                foundChange = false;
-            }
+void VendingMachine::searchItems()
+{
+    //drive the search session from the console
+    ConsoleInput console;
+    SearchItemsSession session(*this, *output);
+    session.run(console);
+}
 
-            //if the change left is still not 0, then we are missing the coins needed for the change
-            if (!foundChange)
-            {
-                //take the coins back out from the system and give it back to the user
-                for (Coin& coin: coinList)
-                {
-                    Denomination denom = coin.getDenom();
-                    coin.removeCoinCount(coinsPutIn[denom]);
-                }
-
-                std::cout << "We do not have enough coins for the change" << std::endl;
-                std::cout << terminatedMsg << std::endl;
-            }
-            else
-            {
-                //now we know we can actually give the change
-
-                //decrement the stock onhand
-                stockRef.removeOnHand(1);
-                std::cout << "Here is your " << stockRef.getName() << " and change of " << Helper::valueToPrice(change).getString() << ": ";
-
-                //loop through the coins giving to the user dictionary and remove the correspeding amount from the coinList
-                for (int i = coinList.size() - 1; i >= 0; --i) 
-                {
-                    Denomination denom = coinList.at(i).getDenom();
-                    unsigned int denomAmountOut = coinsOut[denom];
-                    coinList.at(i).removeCoinCount(denomAmountOut);
-
-                    //we looped from the back so we can print out change from highest to lowest
-                    if (denomAmountOut > 1) {
-                        std::cout << denomAmountOut << "X";
-                    }
-                    
-                    if (denomAmountOut > 0) {
-                        std::cout << Helper::denomToShortString(denom) << " ";
-                    }
-                }
-                std::cout << std::endl;
-            }
+void VendingMachine::searchDescriptions()
+{
+    //drive the description search session from the console
+    ConsoleInput console;
+    SearchDescriptionsSession session(*this, *output);
+    session.run(console);
+}
+
+void VendingMachine::displayByPrice()
+{
+    //drive the price range session from the console
+    ConsoleInput console;
+    DisplayByPriceSession session(*this, *output);
+    session.run(console);
+}
+
+void VendingMachine::displayLowStock()
+{
+    if (onHandIndex == nullptr)
+    {
+        *output << "The sorted views are turned off, run with --views to turn them on" << std::endl;
+        *output << std::endl;
+    }
+    else
+    {
+        //both come straight out of the tree, nothing gets sorted here
+        *output << onHandIndex->countBelow(LOW_STOCK_LEVEL) << " of " << onHandIndex->size() << " items have fewer than "
+            << LOW_STOCK_LEVEL << " left" << std::endl;
+        *output << std::endl;
+        std::vector<const Stock*> lowest = onHandIndex->lowest(LOW_STOCK_COUNT);
+        displayItemList("Lowest Stock", lowest);
+    }
+}
+
+void VendingMachine::displayInventory()
+{
+    if (stockTable == nullptr)
+    {
+        *output << "The stock columns are turned off, run with --columns to turn them on" << std::endl;
+        *output << std::endl;
+    }
+    else
+    {
+        //every number here is one pass over a column, no item gets looked at one by one
+        unsigned long long value = stockTable->inventoryValue();
+        unsigned int centsPerDollar = 100;
+        *output << "Inventory Summary" << std::endl;
+        *output << "-----------------" << std::endl;
+        *output << "Items:         " << stockTable->size() << std::endl;
+        *output << "Sold out:      " << stockTable->countOnHandEqual(0) << std::endl;
+        *output << "Running low:   " << stockTable->countOnHandBelow(LOW_STOCK_LEVEL) << " (fewer than " << LOW_STOCK_LEVEL << " left)" << std::endl;
+        *output << "Units on hand: " << stockTable->totalOnHand() << std::endl;
+        *output << "Stock value:   $" << value / centsPerDollar << "." << std::setw(2) << std::setfill('0') << value % centsPerDollar
+            << std::setfill(' ') << std::endl;
+        *output << "Scanned with:  " << StockTable::simdName(StockTable::getSimdLevel()) << std::endl;
+        *output << std::endl;
+
+        //rebuild the running low items from their rows and put them in name order like the rest of the menus
+        std::vector<unsigned int> rows = stockTable->filterOnHandBelow(LOW_STOCK_LEVEL);
+        std::vector<Stock> lowItems;
+        for (unsigned int row : rows)
+        {
+            unsigned int price = stockTable->getPrice(row);
+            lowItems.push_back(Stock(stockTable->getId(row), stockTable->getName(row), stockTable->getDescription(row),
+                Price::fromValue(price), stockTable->getOnHand(row)));
+        }
+        std::vector<const Stock*> lowList;
+        for (const Stock& stock : lowItems)
+        {
+            lowList.push_back(&stock);
         }
+        NameIndex::sortByName(lowList);
+        displayItemList("Running Low", lowList);
     }
-    
-    std::cout << std::endl;
+}
+
+void VendingMachine::displayMemory()
+{
+    // an item the way it used to be stored, a std::string each for the id, name and description, to compare against
+    struct StringStock
+    {
+        std::string id;
+        std::string name;
+        std::string description;
+        unsigned int dollars;
+        unsigned int cents;
+        unsigned int onHand;
+    };
+
+    int labelWidth = 22;
+    unsigned int items = stockList.size();
+    ArenaStats stats = StringArena::catalog().getStats();
+
+    unsigned long recordBytes = sizeof(Stock) + sizeof(Node);
+    unsigned long stringRecordBytes = sizeof(StringStock) + sizeof(Node);
+    unsigned long stringBytes = 0;
+    stockList.forEach([&stringBytes](const Stock& stock){
+        stringBytes += StringArena::heapBytesFor(stock.name.length()) + StringArena::heapBytesFor(stock.description.length());
+    });
+
+    std::string title = "Memory Usage";
+    *output << title << std::endl;
+    *output << std::string(title.length(), '-') << std::endl;
+    *output << std::left << std::setw(labelWidth) << "Items:" << items << std::endl;
+    *output << std::left << std::setw(labelWidth) << "Record size:" << recordBytes << " bytes (item and list node)" << std::endl;
+    *output << std::left << std::setw(labelWidth) << "Arena text:" << stats.bytesUsed << " bytes in " << stats.strings << " strings" << std::endl;
+    *output << std::left << std::setw(labelWidth) << "Arena blocks:" << stats.bytesReserved << " bytes in " << stats.chunks << " blocks" << std::endl;
+    *output << std::left << std::setw(labelWidth) << "Duplicates shared:" << stats.duplicates << " (" << stats.bytesSaved << " bytes saved)" << std::endl;
+    if (stats.bytesMapped > 0)
+    {
+        *output << std::left << std::setw(labelWidth) << "Left in the file:" << stats.externals << " descriptions (" << stats.bytesExternal
+            << " bytes of a " << stats.bytesMapped << " byte mapping)" << std::endl;
+    }
+    if (items > 0)
+    {
+        *output << std::left << std::setw(labelWidth) << "Per item:" << (items * recordBytes + stats.bytesUsed) / items << " bytes" << std::endl;
+        *output << std::left << std::setw(labelWidth) << "Per item as strings:" << (items * stringRecordBytes + stringBytes) / items << " bytes" << std::endl;
+    }
+    *output << std::endl;
+}
+
+void VendingMachine::purchaseWithCredit()
+{
+    //drive the credit purchase session from the console
+    ConsoleInput console;
+    CreditPurchaseSession session(*this, *output);
+    session.run(console);
+}
+
+void VendingMachine::purchaseBasket()
+{
+    //drive the basket purchase session from the console
+    ConsoleInput console;
+    BasketPurchaseSession session(*this, *output);
+    session.run(console);
 }
@@ -7,6 +7,56 @@
 #include <unordered_map>
 #include "LinkedList.h"
 #include "Helper.h"
+#include "VendingSessions.h"
+#include "Metrics.h"
+#include "LiveState.h"
+#include "CreditTable.h"
+#include "SalesAnalytics.h"
+#include "RestockPlanner.h"
+#include "NameIndex.h"
+#include "DescriptionIndex.h"
+#include "SortedIndex.h"
+#include "StockTable.h"
+#include "DenominationSet.h"
+#include "SnapshotStore.h"
+#include "CatalogRcu.h"
+#include "CounterFile.h"
+
+// all the menu options, also used to write replayable input files
+// the options after MENU_ABORT_PROGRAM only show up when their feature is turned on,
+// they are numbered from 10 in the order they show up
+enum MenuOption
+{
+    MENU_DISPLAY_ITEMS = 1,
+    MENU_PURCHASE_ITEM = 2,
+    MENU_SAVE_AND_EXIT = 3,
+    MENU_ADD_ITEM = 4,
+    MENU_REMOVE_ITEM = 5,
+    MENU_DISPLAY_COINS = 6,
+    MENU_RESET_STOCK = 7,
+    MENU_RESET_COINS = 8,
+    MENU_ABORT_PROGRAM = 9,
+    MENU_DISPLAY_METRICS = 10,
+    MENU_PURCHASE_BASKET = 11,
+    MENU_PURCHASE_WITH_CREDIT = 12,
+    MENU_DISPLAY_SALES = 13,
+    MENU_DISPLAY_RESTOCK_PLAN = 14,
+    MENU_SMART_RESET_STOCK = 15,
+    MENU_SEARCH_ITEMS = 16,
+    MENU_SEARCH_DESCRIPTIONS = 17,
+    MENU_DISPLAY_BY_PRICE = 18,
+    MENU_DISPLAY_LOW_STOCK = 19,
+    MENU_DISPLAY_INVENTORY = 20,
+    MENU_DISPLAY_MEMORY = 21,
+    MENU_SAVE_IN_BACKGROUND = 22,
+    MENU_WRITE_TEXT_FILES = 23
+};
+
+// how many items Display Low Stock shows
+#define LOW_STOCK_COUNT 10
+
+// an item with fewer than this many left is running low
+#define LOW_STOCK_LEVEL 5
 
 class VendingMachine
 {
@@ -15,47 +65,114 @@ class VendingMachine
         LinkedList stockList;
 
         // coin list to store the denominations and their quantity
-        std::vector<Coin> coinList;
+        CoinInventory coinList;
+
+        // where all the messages of the machine get written to (std::cout by default)
+        std::ostream* output;
+
+        // where the numbers other threads look at get published to (nullptr when nobody is looking)
+        LiveState* liveState;
+
+        // the customers' stored value balances (nullptr when credit is turned off)
+        CreditTable* creditTable;
+
+        // the sales counters (nullptr when analytics are turned off)
+        SalesAnalytics* analytics;
+
+        // the sales rates for restocking (nullptr when the planner is turned off)
+        RestockPlanner* planner;
+
+        // the trie over the item names for searching (nullptr when searching is turned off)
+        NameIndex* nameIndex;
+
+        // the inverted index over the item descriptions (nullptr when searching is turned off)
+        DescriptionIndex* descriptionIndex;
+
+        // the items ordered by price and by on hand (nullptr when the sorted views are turned off)
+        SortedIndex* priceIndex;
+        SortedIndex* onHandIndex;
+
+        // the columnar copy of the items for scanning (nullptr when the columns are turned off)
+        StockTable* stockTable;
+
+        // the copy-on-write copy of the items saved in the background (nullptr when snapshots are turned off)
+        SnapshotStore* snapshots;
+
+        // the catalog published for other threads to read (nullptr when nobody reads it)
+        CatalogRcu* catalogRcu;
+
+        // the counters kept in a mapped file (nullptr when they're only in the text files)
+        CounterFile* counters;
+
+        // whether load leaves the descriptions in the stock file until they are looked at
+        bool lazyDescriptions;
+
+        // how many of each item (by number) are in baskets that aren't paid for yet, they're still on hand until then
+        std::unordered_map<unsigned int, unsigned int> reserved;
 
         /**
-         * @brief Keep prompting user until they enter a valid item ID or terminate with ^D or Enter
-         * @param prompt Prompt to keep asking until success or terminatation
-         * @return item ID index in stockList
-         * @throws std::runtime_error
+         * @brief Add every item in stockList to the indexes, after stockList was rebuilt
         */
-        unsigned int getUserItemIndexPersistent(const std::string& prompt);
+        void indexAll();
 
         /**
-         * @brief Keep prompting user until they enter a valid item name or terminate with ^D or Enter
-         * @param prompt Prompt to keep asking until success or termination
-         * @return item name
-         * @throws std::runtime_error
+         * @brief Publish every item and coin count to liveState and move every item in onHandIndex
+         * (stockTable gets its on hand amounts from whoever changed them)
         */
-        std::string getUserNamePersistent(const std::string& prompt);
+        void publishAll();
 
         /**
-         * @brief Keep prompting user until they enter a valid item description or terminate with ^D or Enter
-         * @param prompt Prompt to keep asking until success or termination
-         * @return item description
-         * @throws std::runtime_error
+         * @brief Publish an item that was added or changed to liveState, move it in onHandIndex and update its row in stockTable and snapshots
+         * @param stock The item in stockList
         */
-        std::string getUserDescriptionPersistent(const std::string& prompt);
+        void publishItem(const Stock& stock);
 
         /**
-         * @brief Keep prompting user until they enter a valid price or terminate with ^D or Enter
-         * @param prompt Prompt to keep asking until success or termination
-         * @return price of an item
-         * @throws std::runtime_error
+         * @brief Tell liveState, analytics, planner and the indexes that an item was removed
+         * @param itemId The id of the item
+        */
+        void itemRemoved(const std::string& itemId);
+
+        /**
+         * @brief Record a sale: publish the item's new on hand, the coin counts and the sale to liveState
+         * and count it in analytics and planner, move it in onHandIndex and update its row in stockTable and snapshots
+         * @param stock The item in stockList that was sold (one of it)
+        */
+        void itemSold(const Stock& stock);
+
+        /**
+         * @brief Get how many of an item can still be bought, the stock on hand less what's reserved in baskets
+         * @param stock The item in stockList
+         * @return Number that can be bought
+        */
+        unsigned int getAvailable(const Stock& stock) const;
+
+        /**
+         * @brief Reserve one of an item for a basket, it stays on hand until the basket is paid for
+         * @param stock The item in stockList, it has to have one available
+        */
+        void reserveItem(const Stock& stock);
+
+        /**
+         * @brief Give back one reserved item, when its basket is paid for or cancelled
+         * @param itemId The id of the item, it doesn't have to still be in stockList
         */
-        Price getUserPricePersistent(const std::string& prompt);
+        void releaseItem(const std::string& itemId);
 
         /**
-         * @brief Keep prompting user until they enter a valid Denomination value or terminate with ^D or Enter
-         * @param prompt Prompt to keep asking until success or termination
-         * @return denomination of a coin
+         * @brief Find the index of an item in stockList by its id
+         * @param itemId The item id to look for
+         * @return item index in stockList or LinkedList::invalidPos
+        */
+        unsigned int findItemIndex(const std::string& itemId) const;
+
+        /**
+         * @brief Validate the user's item id and find its index in stockList
+         * @param s The user's input
+         * @return item index in stockList
          * @throws std::runtime_error
         */
-        Denomination getUserDenomPersistent(const std::string& prompt);
+        unsigned int tryFindItemIndex(const std::string& s) const;
 
         /**
          * @brief Generate the next available ID for stock list if one exists
@@ -65,14 +182,150 @@ class VendingMachine
         std::string generateNextId();
 
         /**
-         * @brief Prompt user for item name, description and price then create an item if not terminated midway
-         * @return user created item
-         * @throws std::runtime_error
+         * @brief Add an item to stockList while maintaining its ascending order in terms of item name
+         * @param newItem The item to add
+        */
+        void insertItemSorted(const Stock& newItem);
+
+        /**
+         * @brief Put the coins paid into coinList and take the change back out of it
+         * @param coinsPutIn The number of each denomination paid (indexed by Denomination)
+         * @param change The change to give in cents
+         * @param coinsOut Set to the number of each denomination to give back (indexed by Denomination)
+         * @return Whether we had the coins for the change, if not coinList is left like it was
+        */
+        bool takePayment(const unsigned int coinsPutIn[NUM_DENOMS], unsigned int change, unsigned int coinsOut[NUM_DENOMS]);
+
+        /**
+         * @brief Print change from the highest denomination to the lowest, e.g. "2X$1 50c "
+         * @param os Where to print it
+         * @param coinsOut The number of each denomination (indexed by Denomination)
+        */
+        void printChange(std::ostream& os, const unsigned int coinsOut[NUM_DENOMS]) const;
+
+        /**
+         * @brief Print the title and the header of an items table like displayStock's
+         * @param title The title above the table
+         * @return The width of a row
+        */
+        int printItemsHeader(const std::string& title);
+
+        /**
+         * @brief Print one item as a row of an items table like displayStock's
+         * @param stock The item
         */
-        Stock getUserItem(const std::string& newItemId);
+        void printItemRow(const Stock& stock);
+
+        /**
+         * @brief Display some of the items in a table like displayStock's
+         * @param title The title above the table
+         * @param items The items to show, in the order to show them
+        */
+        void displayItemList(const std::string& title, const std::vector<const Stock*>& items);
+
+        // the prompt driven flows work on the lists directly
+        friend class PurchaseSession;
+        friend class BasketPurchaseSession;
+        friend class CreditPurchaseSession;
+        friend class AddItemSession;
+        friend class RemoveItemSession;
+        friend class SearchItemsSession;
+        friend class SearchDescriptionsSession;
+        friend class DisplayByPriceSession;
+
+        // the benchmarks time the private operations too
+        friend class Benchmark;
 
     public:
         VendingMachine();
+        ~VendingMachine();
+
+        // the machine counts as a user of StringArena::catalog() so it can't be copied
+        VendingMachine(const VendingMachine&) = delete;
+        VendingMachine& operator=(const VendingMachine&) = delete;
+
+        /**
+         * @brief Change where the machine writes its messages, e.g. a null stream for simulations
+         * @param out The stream to write to, must outlive the machine
+        */
+        void setOutput(std::ostream& out);
+
+        /**
+         * @brief Publish the stock levels, coin counts and sales to a live state from now on
+         * @param state The live state, must outlive the machine
+        */
+        void setLiveState(LiveState& state);
+
+        /**
+         * @brief Turn on stored value credit, kept in a credit table
+         * @param table The credit table, must outlive the machine
+        */
+        void setCreditTable(CreditTable& table);
+
+        /**
+         * @brief Count every sale in sales analytics from now on
+         * @param salesAnalytics The analytics, must outlive the machine
+        */
+        void setAnalytics(SalesAnalytics& salesAnalytics);
+
+        /**
+         * @brief Estimate the sales rates in a restock planner from now on
+         * @param restockPlanner The planner, must outlive the machine
+        */
+        void setPlanner(RestockPlanner& restockPlanner);
+
+        /**
+         * @brief Keep a name index of the items from now on, it gets filled with the current items
+         * @param index The name index, must outlive the machine
+        */
+        void setNameIndex(NameIndex& index);
+
+        /**
+         * @brief Keep a description index of the items from now on, it gets filled with the current items
+         * @param index The description index, must outlive the machine
+        */
+        void setDescriptionIndex(DescriptionIndex& index);
+
+        /**
+         * @brief Keep the items ordered by price and by on hand from now on, they get filled with the current items
+         * @param byPrice An index sorted by SORT_BY_PRICE, must outlive the machine
+         * @param byOnHand An index sorted by SORT_BY_ON_HAND, must outlive the machine
+        */
+        void setSortedIndexes(SortedIndex& byPrice, SortedIndex& byOnHand);
+
+        /**
+         * @brief Keep a columnar copy of the items from now on, it gets filled with the current items
+         * @param table The stock table, must outlive the machine
+        */
+        void setStockTable(StockTable& table);
+
+        /**
+         * @brief Keep a copy-on-write copy of the items from now on so they can be saved in the background,
+         * it gets filled with the current items
+         * @param store The snapshot store, must outlive the machine
+        */
+        void setSnapshotStore(SnapshotStore& store);
+
+        /**
+         * @brief Publish a new version of the catalog for other threads to read after every change from now on
+         * @param catalog The published catalog, must outlive the machine
+        */
+        void setCatalogRcu(CatalogRcu& catalog);
+
+        /**
+         * @brief Keep the stock on hand and the coin counts in a counter file from now on. If the stock file and
+         * coin file weren't changed since the counters were last in step with them, the counters replace what
+         * was loaded, otherwise they're filled in from what was loaded
+         * @param file The counter file, already opened, must outlive the machine
+        */
+        void setCounterFile(CounterFile& file);
+
+        /**
+         * @brief Leave the descriptions in the stock file (mapped into memory) when loading from now on,
+         * each one is only read from the file the first time it's looked at
+         * @param lazy Whether to
+        */
+        void setLazyDescriptions(bool lazy);
 
         /**
          * @brief Load the stockFile and coinFile into stockList and coinList respectively (if they exist)
@@ -90,11 +343,24 @@ class VendingMachine
         */
         void save(const std::string& stockFile, const std::string& coinFile);
 
+        /**
+         * @brief Save the items and coins as they are now on the snapshot store's background thread,
+         * the machine carries on straight away. Needs setSnapshotStore
+         * @param stockFile the directory of the stock file to be saved
+         * @param coinFile the diretory of the coin file to be saved
+        */
+        void saveInBackground(const std::string& stockFile, const std::string& coinFile);
+
         /**
          * @brief Reset all stocks' on hand amount to the default
         */
         void resetStock();
 
+        /**
+         * @brief Reset every stock's on hand amount to the level the restock planner recommends
+        */
+        void smartResetStock();
+
         /**
          * @brief Reset all coins' quantity to the default
         */
@@ -121,6 +387,48 @@ class VendingMachine
         */
         void displayStock();
 
+        /**
+         * @brief Display the sales totals, best sellers and the sales of the last ANALYTICS_HOURS hours
+        */
+        void displaySales();
+
+        /**
+         * @brief Display each item's sales rate, when it runs out and how much to restock, the ones running out first at the top
+        */
+        void displayRestockPlan();
+
+        /**
+         * @brief Prompt user for the start of an item name then display the items it finds
+        */
+        void searchItems();
+
+        /**
+         * @brief Prompt user for words then display the items with those words in their description
+        */
+        void searchDescriptions();
+
+        /**
+         * @brief Prompt user for a price range then display the items in it from the cheapest up
+        */
+        void displayByPrice();
+
+        /**
+         * @brief Display the LOW_STOCK_COUNT items with the least on hand and how many are running low
+        */
+        void displayLowStock();
+
+        /**
+         * @brief Display how many items are sold out and running low and what everything in the machine is worth,
+         * worked out by scanning the columns of stockTable
+        */
+        void displayInventory();
+
+        /**
+         * @brief Display how much memory the items take up, with their text in StringArena::catalog(),
+         * next to what they would take with a std::string for each name and description
+        */
+        void displayMemory();
+
         /**
          * @brief 
          * Prompt user for item id and denom value until they are able to purchase the item.
@@ -128,5 +436,20 @@ class VendingMachine
          * If not enough coins in coinList, the user gets back their input coins
         */
         void purchaseItem();
+
+        /**
+         * @brief 
+         * Prompt user for item ids until they are done, then denom values until they can pay for all of them.
+         * Then give them the correct change for the total
+         * If not enough coins in coinList, the user gets back their input coins and nothing is bought
+        */
+        void purchaseBasket();
+
+        /**
+         * @brief 
+         * Prompt user for their credit token, an item id then denom values until their credit and
+         * the money put in cover the price. What they pay over the price is kept as credit
+        */
+        void purchaseWithCredit();
 };
 #endif
\ No newline at end of file
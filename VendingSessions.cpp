@@ -0,0 +1,791 @@
+#include "VendingSessions.h"
+#include "VendingMachine.h"
+
+//====PURCHASE SESSION=====
+PurchaseSession::PurchaseSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine), state(SELECT_ITEM), outcome(PURCHASE_PENDING), itemId(""), coinsPutIn{0}, moneyTarget(0), moneyIn(0) {}
+
+PurchaseOutcome PurchaseSession::getOutcome() const
+{
+    return outcome;
+}
+
+void PurchaseSession::onStart() {}
+
+std::string PurchaseSession::getPrompt() const
+{
+    std::string prompt = "Please enter the id of the item you wish to purchase: ";
+    if (state == PAYING)
+    {
+        char owed[PRICE_STRING_LEN];
+        std::size_t length = Helper::valueToPrice(moneyTarget - moneyIn).format(owed);
+        prompt = "You still need to give us ";
+        prompt.append(owed, length).append(": ");
+    }
+    return prompt;
+}
+
+Denomination PurchaseSession::tryParseUserDenom(const std::string& s)
+{
+    Denomination denom = FIVE_CENTS;
+    unsigned int denomVal = 0;
+
+    //check if the input denom is an integer
+    try{
+        denomVal = Helper::tryParseInt(s);
+    }
+    catch(const std::runtime_error& e){
+        throw std::runtime_error("Denomination needs to be a valid integer");
+    }
+
+    //check if the input denom integer is an actual denom value
+    try{
+        denom = Helper::tryParseDenom(denomVal);
+    }
+    catch(const std::runtime_error& e){
+        std::string priceString = Helper::valueToPrice(denomVal).getString();
+        throw std::runtime_error(priceString + " is not a valid denomination of money");
+    }
+
+    return denom;
+}
+
+void PurchaseSession::onInput(const std::string& s)
+{
+    if (state == SELECT_ITEM)
+    {
+        //get the item in the stock list from the user's entered item id string
+        unsigned int purchaseItemIndex = machine.tryFindItemIndex(s);
+        const Stock& stockRef = machine.stockList.at(purchaseItemIndex);
+
+        //check if we have the item in stock, not counting the ones reserved in baskets
+        if (machine.getAvailable(stockRef) == 0)
+        {
+            out << ERROR_PREFIX << "Cannot purchase that item as there is none left" << std::endl;
+            out << "Terminated Purchase Item" << std::endl;
+            finishPurchase(PURCHASE_OUT_OF_STOCK);
+        }
+        else
+        {
+            //now we checked that the item is in stock, the user is then prompted to put in denomination until they can afford the item
+            itemId = stockRef.getId();
+            moneyTarget = stockRef.getPrice().getValue();
+            state = PAYING;
+
+            out << "You have selected \"" << stockRef.name << " - " << stockRef.getShortDescription() << "\". This will cost you " << stockRef.getPriceString() << "." << std::endl;
+            out << "Please hand over the money - type in the value of each note/coin in cents." << std::endl;
+            out << "Please enter or ctrl-d on a new line to cancel this purchase:" << std::endl;
+        }
+    }
+    else
+    {
+        //if we manage to get a valid denomination value from the user
+        //increment the number of that denomination put in
+        //and add to the money put in
+        Denomination denom = tryParseUserDenom(s);
+        coinsPutIn[denom] += 1;
+        moneyIn += Helper::denomToValue(denom);
+
+        if (moneyIn >= moneyTarget)
+        {
+            complete();
+        }
+    }
+}
+
+void PurchaseSession::onTerminate()
+{
+    out << "Terminated Purchase Item" << std::endl;
+    outcome = PURCHASE_CANCELLED;
+    Metrics::add(COUNTER_CANCELLATIONS);
+    out << std::endl;
+}
+
+void PurchaseSession::complete()
+{
+    //look the item up again, another session could have bought the last one or removed it
+    unsigned int purchaseItemIndex = machine.findItemIndex(itemId);
+    if (purchaseItemIndex == LinkedList::invalidPos || machine.getAvailable(machine.stockList.at(purchaseItemIndex)) == 0)
+    {
+        out << ERROR_PREFIX << "Cannot purchase that item as there is none left" << std::endl;
+        out << "Terminated Purchase Item" << std::endl;
+        finishPurchase(PURCHASE_OUT_OF_STOCK);
+    }
+    else
+    {
+        Stock& stockRef = machine.stockList.at(purchaseItemIndex);
+
+        //this round was in case if we didn't get a price in multiples of 5
+        //but I guess it doesn't matter anymore since we force the stock file to have prices divisible by 5
+        unsigned int change = Helper::round(moneyIn - moneyTarget, DenominationSet::active().getSmallest());
+        unsigned int coinsOut[NUM_DENOMS];
+
+        //if we are missing the coins needed for the change, the user gets their coins back
+        if (!machine.takePayment(coinsPutIn, change, coinsOut))
+        {
+            out << "We do not have enough coins for the change" << std::endl;
+            out << "Terminated Purchase Item" << std::endl;
+            finishPurchase(PURCHASE_NO_CHANGE);
+        }
+        else if (change == 0)
+        {
+            //if the there is no change, then we don't need to give any coins to the user and the transaction ends
+            stockRef.removeOnHand(1);
+            machine.itemSold(stockRef);
+            out << "Here is your " << stockRef.name << " with no change" << std::endl;
+            finishPurchase(PURCHASE_COMPLETED);
+        }
+        else
+        {
+            //now we know we can actually give the change, decrement the stock onhand
+            stockRef.removeOnHand(1);
+            char changeText[PRICE_STRING_LEN];
+            Helper::valueToPrice(change).format(changeText);
+            out << "Here is your " << stockRef.name << " and change of " << changeText << ": ";
+            machine.printChange(out, coinsOut);
+            out << std::endl;
+            machine.itemSold(stockRef);
+            finishPurchase(PURCHASE_COMPLETED);
+        }
+    }
+}
+
+void PurchaseSession::finishPurchase(PurchaseOutcome result)
+{
+    outcome = result;
+
+    if (result == PURCHASE_COMPLETED) {
+        Metrics::add(COUNTER_PURCHASES);
+    }
+    else if (result == PURCHASE_NO_CHANGE) {
+        Metrics::add(COUNTER_CHANGE_FAILURES);
+    }
+    else if (result == PURCHASE_OUT_OF_STOCK) {
+        Metrics::add(COUNTER_STOCKOUTS);
+    }
+
+    out << std::endl;
+    finish();
+}
+
+//====BASKET PURCHASE SESSION=====
+BasketPurchaseSession::BasketPurchaseSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine), state(SELECT_ITEMS), outcome(PURCHASE_PENDING), coinsPutIn{0}, moneyTarget(0), moneyIn(0) {}
+
+PurchaseOutcome BasketPurchaseSession::getOutcome() const
+{
+    return outcome;
+}
+
+const std::vector<std::string>& BasketPurchaseSession::getItemIds() const
+{
+    return basket;
+}
+
+void BasketPurchaseSession::onStart()
+{
+    out << "Enter the id of each item you want, then " << BASKET_DONE << " to pay for them all at once." << std::endl;
+}
+
+std::string BasketPurchaseSession::getPrompt() const
+{
+    std::string prompt = "Please enter the id of the item you wish to purchase: ";
+    if (state == PAYING)
+    {
+        char owed[PRICE_STRING_LEN];
+        std::size_t length = Helper::valueToPrice(moneyTarget - moneyIn).format(owed);
+        prompt = "You still need to give us ";
+        prompt.append(owed, length).append(": ");
+    }
+    else if (!basket.empty())
+    {
+        prompt = "Please enter the id of the next item, or " + std::string(BASKET_DONE) + " to pay: ";
+    }
+    return prompt;
+}
+
+void BasketPurchaseSession::onInput(const std::string& s)
+{
+    if (state == SELECT_ITEMS && Helper::stringLower(s) == BASKET_DONE)
+    {
+        if (basket.empty())
+        {
+            throw std::runtime_error("Your basket is empty");
+        }
+
+        state = PAYING;
+        char totalText[PRICE_STRING_LEN];
+        Helper::valueToPrice(moneyTarget).format(totalText);
+        out << "Your basket has " << basket.size() << " item" << (basket.size() > 1 ? "s" : "") << ". This will cost you " << totalText << "." << std::endl;
+        out << "Please hand over the money - type in the value of each note/coin in cents." << std::endl;
+        out << "Please enter or ctrl-d on a new line to cancel this purchase:" << std::endl;
+    }
+    else if (state == SELECT_ITEMS)
+    {
+        if (basket.size() >= BASKET_MAX_ITEMS)
+        {
+            throw std::runtime_error("A basket can only have " + std::to_string(BASKET_MAX_ITEMS) + " items");
+        }
+
+        //reserve the item so nobody else can buy it while we pay, it only comes off the shelf once we've paid
+        const Stock& stockRef = machine.stockList.at(machine.tryFindItemIndex(s));
+        if (machine.getAvailable(stockRef) == 0)
+        {
+            throw std::runtime_error("Cannot add that item as there is none left");
+        }
+        machine.reserveItem(stockRef);
+        basket.push_back(stockRef.getId());
+        moneyTarget += stockRef.getPrice().getValue();
+
+        char totalText[PRICE_STRING_LEN];
+        Helper::valueToPrice(moneyTarget).format(totalText);
+        out << "Added \"" << stockRef.getName() << " - " << stockRef.getShortDescription() << "\" to your basket. The total is now " << totalText << "." << std::endl;
+    }
+    else
+    {
+        Denomination denom = PurchaseSession::tryParseUserDenom(s);
+        coinsPutIn[denom] += 1;
+        moneyIn += Helper::denomToValue(denom);
+
+        if (moneyIn >= moneyTarget)
+        {
+            complete();
+        }
+    }
+}
+
+void BasketPurchaseSession::onTerminate()
+{
+    releaseItems();
+    out << "Terminated Purchase Basket" << std::endl;
+    outcome = PURCHASE_CANCELLED;
+    Metrics::add(COUNTER_CANCELLATIONS);
+    out << std::endl;
+}
+
+void BasketPurchaseSession::releaseItems()
+{
+    //the reserved items never left the shelf, they only stop being reserved
+    for (const std::string& itemId : basket)
+    {
+        machine.releaseItem(itemId);
+    }
+}
+
+void BasketPurchaseSession::complete()
+{
+    //an administrator could have removed a reserved item while we were paying, or reset it to less than is reserved
+    bool allThere = true;
+    for (const std::string& itemId : basket)
+    {
+        unsigned int index = machine.findItemIndex(itemId);
+        unsigned int inBasket = std::count(basket.begin(), basket.end(), itemId);
+        allThere = allThere && index != LinkedList::invalidPos && machine.stockList.at(index).getOnHand() >= inBasket;
+    }
+
+    unsigned int change = Helper::round(moneyIn - moneyTarget, DenominationSet::active().getSmallest());
+    unsigned int coinsOut[NUM_DENOMS];
+
+    if (!allThere)
+    {
+        releaseItems();
+        out << ERROR_PREFIX << "Cannot purchase the basket as an item in it is no longer available" << std::endl;
+        out << "Terminated Purchase Basket" << std::endl;
+        finishPurchase(PURCHASE_OUT_OF_STOCK);
+    }
+    else if (!machine.takePayment(coinsPutIn, change, coinsOut))
+    {
+        //one change calculation for the whole basket, if it fails nothing is bought
+        releaseItems();
+        out << "We do not have enough coins for the change" << std::endl;
+        out << "Terminated Purchase Basket" << std::endl;
+        finishPurchase(PURCHASE_NO_CHANGE);
+    }
+    else
+    {
+        //the items only come off the shelf now, so nothing reserved was ever in the counters or snapshots
+        out << "Here is your ";
+        for (unsigned int i = 0; i < basket.size(); ++i)
+        {
+            Stock& stockRef = machine.stockList.at(machine.findItemIndex(basket[i]));
+            stockRef.removeOnHand(1);
+            machine.releaseItem(basket[i]);
+            machine.itemSold(stockRef);
+            if (i > 0) {
+                out << (i + 1 == basket.size() ? " and " : ", ");
+            }
+            out << stockRef.getName();
+        }
+
+        if (change == 0)
+        {
+            out << " with no change" << std::endl;
+        }
+        else
+        {
+            char changeText[PRICE_STRING_LEN];
+            Helper::valueToPrice(change).format(changeText);
+            out << " with change of " << changeText << ": ";
+            machine.printChange(out, coinsOut);
+            out << std::endl;
+        }
+        finishPurchase(PURCHASE_COMPLETED);
+    }
+}
+
+void BasketPurchaseSession::finishPurchase(PurchaseOutcome result)
+{
+    outcome = result;
+
+    if (result == PURCHASE_COMPLETED) {
+        Metrics::add(COUNTER_PURCHASES, basket.size());
+    }
+    else if (result == PURCHASE_NO_CHANGE) {
+        Metrics::add(COUNTER_CHANGE_FAILURES);
+    }
+    else if (result == PURCHASE_OUT_OF_STOCK) {
+        Metrics::add(COUNTER_STOCKOUTS);
+    }
+
+    out << std::endl;
+    finish();
+}
+
+//====CREDIT PURCHASE SESSION=====
+CreditPurchaseSession::CreditPurchaseSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine), state(ENTER_TOKEN), outcome(PURCHASE_PENDING), token(0), newAccount(false), itemId(""), coinsPutIn{0}, moneyTarget(0), moneyIn(0) {}
+
+PurchaseOutcome CreditPurchaseSession::getOutcome() const
+{
+    return outcome;
+}
+
+void CreditPurchaseSession::onStart()
+{
+    //without a credit table there is nowhere to keep the credit
+    if (machine.creditTable == nullptr)
+    {
+        out << ERROR_PREFIX << "Credit is not turned on for this machine" << std::endl;
+        out << "Terminated Purchase Item" << std::endl;
+        finishPurchase(PURCHASE_CANCELLED);
+    }
+}
+
+unsigned int CreditPurchaseSession::getOwed() const
+{
+    unsigned int paid = machine.creditTable->getBalance(token) + moneyIn;
+    return paid >= moneyTarget ? 0 : moneyTarget - paid;
+}
+
+std::string CreditPurchaseSession::getPrompt() const
+{
+    std::string prompt = "Please enter your credit token, or " + std::string(CREDIT_NEW_TOKEN) + " for a new one: ";
+    if (state == SELECT_ITEM)
+    {
+        prompt = "Please enter the id of the item you wish to purchase: ";
+    }
+    else if (state == PAYING)
+    {
+        char owed[PRICE_STRING_LEN];
+        std::size_t length = Helper::valueToPrice(getOwed()).format(owed);
+        prompt = "You still need to give us ";
+        prompt.append(owed, length).append(": ");
+    }
+    return prompt;
+}
+
+void CreditPurchaseSession::onInput(const std::string& s)
+{
+    CreditTable& credit = *machine.creditTable;
+
+    if (state == ENTER_TOKEN)
+    {
+        if (Helper::stringLower(s) == CREDIT_NEW_TOKEN)
+        {
+            //a new account starts at 0, it's only opened if something is bought so a cancelled purchase leaves nothing behind
+            newAccount = true;
+            out << "You will get your new credit token once you have bought something." << std::endl;
+        }
+        else
+        {
+            token = CreditTable::tryParseToken(s);
+            if (!credit.hasAccount(token))
+            {
+                throw std::runtime_error("Credit token does not exist");
+            }
+        }
+        char balanceText[PRICE_STRING_LEN];
+        Helper::valueToPrice(credit.getBalance(token)).format(balanceText);
+        out << "Your credit balance is " << balanceText << "." << std::endl;
+        state = SELECT_ITEM;
+    }
+    else if (state == SELECT_ITEM)
+    {
+        unsigned int purchaseItemIndex = machine.tryFindItemIndex(s);
+        const Stock& stockRef = machine.stockList.at(purchaseItemIndex);
+
+        if (machine.getAvailable(stockRef) == 0)
+        {
+            out << ERROR_PREFIX << "Cannot purchase that item as there is none left" << std::endl;
+            out << "Terminated Purchase Item" << std::endl;
+            finishPurchase(PURCHASE_OUT_OF_STOCK);
+        }
+        else
+        {
+            itemId = stockRef.getId();
+            moneyTarget = stockRef.getPrice().getValue();
+            out << "You have selected \"" << stockRef.name << " - " << stockRef.getShortDescription() << "\". This will cost you " << stockRef.getPriceString() << "." << std::endl;
+
+            //enough credit means no money has to change hands at all
+            if (getOwed() == 0)
+            {
+                complete();
+            }
+            else
+            {
+                state = PAYING;
+                out << "Please hand over the money - type in the value of each note/coin in cents." << std::endl;
+                out << "Anything you pay over the price is kept as credit." << std::endl;
+                out << "Please enter or ctrl-d on a new line to cancel this purchase:" << std::endl;
+            }
+        }
+    }
+    else
+    {
+        Denomination denom = PurchaseSession::tryParseUserDenom(s);
+        coinsPutIn[denom] += 1;
+        moneyIn += Helper::denomToValue(denom);
+
+        if (getOwed() == 0)
+        {
+            complete();
+        }
+    }
+}
+
+void CreditPurchaseSession::onTerminate()
+{
+    out << "Terminated Purchase Item" << std::endl;
+    outcome = PURCHASE_CANCELLED;
+    Metrics::add(COUNTER_CANCELLATIONS);
+    out << std::endl;
+}
+
+void CreditPurchaseSession::complete()
+{
+    //look the item up again, another session could have bought the last one or removed it
+    unsigned int purchaseItemIndex = machine.findItemIndex(itemId);
+    if (purchaseItemIndex == LinkedList::invalidPos || machine.getAvailable(machine.stockList.at(purchaseItemIndex)) == 0)
+    {
+        out << ERROR_PREFIX << "Cannot purchase that item as there is none left" << std::endl;
+        out << "Terminated Purchase Item" << std::endl;
+        finishPurchase(PURCHASE_OUT_OF_STOCK);
+    }
+    else
+    {
+        Stock& stockRef = machine.stockList.at(purchaseItemIndex);
+        CreditTable& credit = *machine.creditTable;
+
+        //keep whatever is left over as credit instead of working out change, it's saved first
+        //so nothing else changes if it can't be
+        unsigned int balance = credit.getBalance(token) + moneyIn - moneyTarget;
+        bool saved = true;
+        try {
+            if (newAccount) {
+                token = credit.openAccount(balance);
+            }
+            else {
+                credit.setBalance(token, balance);
+            }
+        }
+        catch(const std::runtime_error& e) {
+            //nothing was taken, the customer keeps their money and their credit
+            out << ERROR_PREFIX << e.what() << std::endl;
+            out << "Terminated Purchase Item" << std::endl;
+            saved = false;
+            finishPurchase(PURCHASE_FAILED);
+        }
+
+        if (saved)
+        {
+            for (Coin& coin: machine.coinList)
+            {
+                coin.addCoinCount(coinsPutIn[coin.getDenom()]);
+            }
+
+            stockRef.removeOnHand(1);
+            machine.itemSold(stockRef);
+            char balanceText[PRICE_STRING_LEN];
+            Helper::valueToPrice(balance).format(balanceText);
+            out << "Here is your " << stockRef.getName() << ". Your credit balance is now " << balanceText << "." << std::endl;
+            if (newAccount)
+            {
+                out << "Your new credit token is " << CreditTable::tokenToString(token) << ", keep it to spend your credit later." << std::endl;
+            }
+            finishPurchase(PURCHASE_COMPLETED);
+        }
+    }
+}
+
+void CreditPurchaseSession::finishPurchase(PurchaseOutcome result)
+{
+    outcome = result;
+
+    if (result == PURCHASE_COMPLETED) {
+        Metrics::add(COUNTER_PURCHASES);
+    }
+    else if (result == PURCHASE_OUT_OF_STOCK) {
+        Metrics::add(COUNTER_STOCKOUTS);
+    }
+
+    out << std::endl;
+    finish();
+}
+
+//====ADD ITEM SESSION=====
+AddItemSession::AddItemSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine), state(ENTER_NAME), newItemId(""), name(""), desc("") {}
+
+std::string AddItemSession::getItemId() const
+{
+    return newItemId;
+}
+
+void AddItemSession::onStart()
+{
+    //try to generate the new item id
+    try {
+        newItemId = machine.generateNextId();
+        out << "The id of the new stock will be: " << newItemId << std::endl;
+    } catch(const std::runtime_error& e) {
+        out << ERROR_PREFIX << e.what() << std::endl;
+        out << "Terminated add item" << std::endl;
+        finishAdd();
+    }
+}
+
+std::string AddItemSession::getPrompt() const
+{
+    std::string prompt = "Enter the item name: ";
+    if (state == ENTER_DESCRIPTION)
+    {
+        prompt = "Enter the item description: ";
+    }
+    else if (state == ENTER_PRICE)
+    {
+        prompt = "Enter the price for the item: ";
+    }
+    return prompt;
+}
+
+void AddItemSession::onInput(const std::string& s)
+{
+    if (state == ENTER_NAME)
+    {
+        name = Helper::tryParseName(s);
+        state = ENTER_DESCRIPTION;
+    }
+    else if (state == ENTER_DESCRIPTION)
+    {
+        desc = Helper::tryParseDescription(s);
+        state = ENTER_PRICE;
+    }
+    else
+    {
+        Price price = Helper::tryParsePrice(s);
+
+        //another session could have taken the id while we were waiting
+        if (machine.findItemIndex(newItemId) != LinkedList::invalidPos)
+        {
+            newItemId = machine.generateNextId();
+        }
+
+        //we got the item info from the user, now add the item to the stockList
+        Stock newItem(newItemId, name, desc, price, DEFAULT_STOCK_LEVEL);
+        machine.insertItemSorted(newItem);
+
+        out << "\"" << newItem.getId() << " - " << newItem.getName() << " - " << newItem.getDescription() <<  "\" has been added to the menu." << std::endl;
+        finishAdd();
+    }
+}
+
+void AddItemSession::onTerminate()
+{
+    out << "Terminated add item" << std::endl;
+    out << std::endl;
+}
+
+void AddItemSession::finishAdd()
+{
+    out << std::endl;
+    finish();
+}
+
+//====REMOVE ITEM SESSION=====
+RemoveItemSession::RemoveItemSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine) {}
+
+void RemoveItemSession::onStart()
+{
+    //make sure the stockList is not empty so we can actually remove an item
+    if (machine.stockList.empty())
+    {
+        out << ERROR_PREFIX << "Cannot remove more items from an empty stock list" << std::endl;
+        out << "Terminated Remove Item" << std::endl;
+        finishRemove();
+    }
+}
+
+std::string RemoveItemSession::getPrompt() const
+{
+    return "Enter the item id of the item to remove from the menu: ";
+}
+
+void RemoveItemSession::onInput(const std::string& s)
+{
+    //find the index of the item in stockList then remove it
+    unsigned int foundItemIndex = machine.tryFindItemIndex(s);
+    Stock removedStock = machine.stockList.removeAt(foundItemIndex);
+    machine.itemRemoved(removedStock.getId());
+    out << "\"" << removedStock.getId() <<  " - " << removedStock.getName() << " - " << removedStock.getDescription() <<
+        "\" has been removed from the system." << std::endl;
+    finishRemove();
+}
+
+void RemoveItemSession::onTerminate()
+{
+    out << "Terminated Remove Item" << std::endl;
+    out << std::endl;
+}
+
+void RemoveItemSession::finishRemove()
+{
+    out << std::endl;
+    finish();
+}
+
+//====SEARCH ITEMS SESSION=====
+SearchItemsSession::SearchItemsSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine) {}
+
+void SearchItemsSession::onStart()
+{
+    if (machine.nameIndex == nullptr)
+    {
+        out << "Searching is turned off, run with --search to turn it on" << std::endl;
+        out << std::endl;
+        finish();
+    }
+}
+
+std::string SearchItemsSession::getPrompt() const
+{
+    return "Enter the start of the item name to search for: ";
+}
+
+void SearchItemsSession::onInput(const std::string& s)
+{
+    unsigned int typosUsed = 0;
+    std::vector<const Stock*> results = machine.nameIndex->search(s, typosUsed);
+
+    out << std::endl;
+    if (typosUsed > 0 && !results.empty())
+    {
+        out << "Nothing starts with \"" << s << "\", showing names up to " << typosUsed << " typo(s) away" << std::endl;
+    }
+    machine.displayItemList("Search Results", results);
+    finish();
+}
+
+void SearchItemsSession::onTerminate()
+{
+    out << "Terminated Search Items" << std::endl;
+    out << std::endl;
+}
+
+//====SEARCH DESCRIPTIONS SESSION=====
+SearchDescriptionsSession::SearchDescriptionsSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine) {}
+
+void SearchDescriptionsSession::onStart()
+{
+    if (machine.descriptionIndex == nullptr)
+    {
+        out << "Searching is turned off, run with --search to turn it on" << std::endl;
+        out << std::endl;
+        finish();
+    }
+}
+
+std::string SearchDescriptionsSession::getPrompt() const
+{
+    return "Enter the words to search the descriptions for (\"" DESC_QUERY_OR "\" between alternatives): ";
+}
+
+void SearchDescriptionsSession::onInput(const std::string& s)
+{
+    std::vector<const Stock*> results = machine.descriptionIndex->find(s);
+
+    out << std::endl;
+    machine.displayItemList("Search Results", results);
+    finish();
+}
+
+void SearchDescriptionsSession::onTerminate()
+{
+    out << "Terminated Search Descriptions" << std::endl;
+    out << std::endl;
+}
+
+//====DISPLAY BY PRICE SESSION=====
+DisplayByPriceSession::DisplayByPriceSession(VendingMachine& machine, std::ostream& out):
+    Session(out), machine(machine) {}
+
+void DisplayByPriceSession::onStart()
+{
+    if (machine.priceIndex == nullptr)
+    {
+        out << "The sorted views are turned off, run with --views to turn them on" << std::endl;
+        out << std::endl;
+        finish();
+    }
+}
+
+std::string DisplayByPriceSession::getPrompt() const
+{
+    return "Enter the highest price (e.g. 3.50) or a price range (e.g. 2.00-3.50): ";
+}
+
+void DisplayByPriceSession::onInput(const std::string& s)
+{
+    //either "high" or "low-high", both checked like a new item's price
+    char rangeSep = '-';
+    std::size_t sepIndex = s.find(rangeSep);
+    unsigned int low = 0;
+    unsigned int high = 0;
+    if (sepIndex == std::string::npos)
+    {
+        high = Helper::tryParsePrice(s).getValue();
+    }
+    else
+    {
+        low = Helper::tryParsePrice(Helper::stringTrim(s.substr(0, sepIndex))).getValue();
+        high = Helper::tryParsePrice(Helper::stringTrim(s.substr(sepIndex + 1))).getValue();
+    }
+
+    if (low > high)
+    {
+        throw std::runtime_error("The lowest price of the range must not be above the highest");
+    }
+
+    std::vector<const Stock*> results = machine.priceIndex->range(low, high);
+    out << std::endl;
+    machine.displayItemList("Items From " + Helper::valueToPrice(low).getString() + " To " + Helper::valueToPrice(high).getString(), results);
+    finish();
+}
+
+void DisplayByPriceSession::onTerminate()
+{
+    out << "Terminated Display By Price" << std::endl;
+    out << std::endl;
+}
@@ -0,0 +1,330 @@
+#ifndef VENDING_SESSIONS_H
+#define VENDING_SESSIONS_H
+
+#include <vector>
+#include "Session.h"
+#include "Node.h"
+
+// what the customer types to stop adding items to a basket and pay
+#define BASKET_DONE "done"
+
+// the most items one basket can have
+#define BASKET_MAX_ITEMS 20
+
+class VendingMachine;
+
+// how a purchase session ended up
+enum PurchaseOutcome
+{
+    PURCHASE_PENDING, PURCHASE_COMPLETED, PURCHASE_CANCELLED, PURCHASE_OUT_OF_STOCK, PURCHASE_NO_CHANGE,
+
+    // the purchase couldn't be recorded (e.g. the credit file couldn't be written), so nothing was bought
+    PURCHASE_FAILED
+};
+
+/**
+ * prompt for an item id then denominations until the item is paid for, then give change.
+ * if there are not enough coins for the change, the user gets back their input coins
+ **/
+class PurchaseSession : public Session
+{
+public:
+    PurchaseSession(VendingMachine& machine, std::ostream& out);
+
+    /**
+     * @brief Get how the purchase ended, PURCHASE_PENDING if it has not finished
+     * @return The purchase outcome
+    */
+    PurchaseOutcome getOutcome() const;
+
+    /**
+     * @brief Try parse the user's input to a Denomination enum value
+     * @param s The string to convert
+     * @return The parsed Denomination enum value
+     * @throws std::runtime_error
+    */
+    static Denomination tryParseUserDenom(const std::string& s);
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    enum State
+    {
+        SELECT_ITEM, PAYING
+    };
+
+    VendingMachine& machine;
+    State state;
+    PurchaseOutcome outcome;
+
+    // the item being bought, kept as an id since other sessions can change the list in between
+    std::string itemId;
+
+    // a dictionary to store the number of each denomination put into the vending machine
+    unsigned int coinsPutIn[NUM_DENOMS];
+    unsigned int moneyTarget;
+    unsigned int moneyIn;
+
+    /**
+     * @brief The item has been paid for, take the coins and give the item and change
+    */
+    void complete();
+
+    /**
+     * @brief Finish the session with an outcome
+     * @param result How the purchase ended
+    */
+    void finishPurchase(PurchaseOutcome result);
+};
+
+/**
+ * prompt for item ids until the customer types done, reserving each item as it goes in
+ * the basket, then take one payment for the total and work out the change once.
+ * either every item in the basket is bought or none of them are
+ **/
+class BasketPurchaseSession : public Session
+{
+public:
+    BasketPurchaseSession(VendingMachine& machine, std::ostream& out);
+
+    /**
+     * @brief Get how the purchase ended, PURCHASE_PENDING if it has not finished
+     * @return The purchase outcome
+    */
+    PurchaseOutcome getOutcome() const;
+
+    /**
+     * @brief Get the ids of the items in the basket, an item is in there once for each one bought
+     * @return The item ids
+    */
+    const std::vector<std::string>& getItemIds() const;
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    enum State
+    {
+        SELECT_ITEMS, PAYING
+    };
+
+    VendingMachine& machine;
+    State state;
+    PurchaseOutcome outcome;
+
+    // the reserved items (their on hand has already been taken down)
+    std::vector<std::string> basket;
+
+    unsigned int coinsPutIn[NUM_DENOMS];
+    unsigned int moneyTarget;
+    unsigned int moneyIn;
+
+    /**
+     * @brief Put the reserved items back on the shelf
+    */
+    void releaseItems();
+
+    /**
+     * @brief The basket has been paid for, take the coins and give the items and change
+    */
+    void complete();
+
+    /**
+     * @brief Finish the session with an outcome
+     * @param result How the purchase ended
+    */
+    void finishPurchase(PurchaseOutcome result);
+};
+
+/**
+ * prompt for a credit token (or ask for a new account), then an item id, then denominations
+ * until the credit and the money put in cover the price. overpaying is kept as credit
+ * instead of being given back as change, so the change is never worked out.
+ * a new account is only opened once the purchase goes through
+ **/
+class CreditPurchaseSession : public Session
+{
+public:
+    CreditPurchaseSession(VendingMachine& machine, std::ostream& out);
+
+    /**
+     * @brief Get how the purchase ended, PURCHASE_PENDING if it has not finished
+     * @return The purchase outcome
+    */
+    PurchaseOutcome getOutcome() const;
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    enum State
+    {
+        ENTER_TOKEN, SELECT_ITEM, PAYING
+    };
+
+    VendingMachine& machine;
+    State state;
+    PurchaseOutcome outcome;
+
+    // the customer's token number, 0 until a new account is opened
+    unsigned long long token;
+
+    // whether the customer asked for a new account, it's opened in complete
+    bool newAccount;
+
+    // the item being bought, kept as an id since other sessions can change the list in between
+    std::string itemId;
+
+    unsigned int coinsPutIn[NUM_DENOMS];
+    unsigned int moneyTarget;
+    unsigned int moneyIn;
+
+    /**
+     * @brief Get how much is still owed after the credit and the money put in
+     * @return The amount owed in cents
+    */
+    unsigned int getOwed() const;
+
+    /**
+     * @brief The credit and the money put in cover the price, take the coins and give the item
+    */
+    void complete();
+
+    /**
+     * @brief Finish the session with an outcome
+     * @param result How the purchase ended
+    */
+    void finishPurchase(PurchaseOutcome result);
+};
+
+/**
+ * prompt for item name, description and price then add it to the stock list
+ * while maintaining its ascending order in terms of item name
+ **/
+class AddItemSession : public Session
+{
+public:
+    AddItemSession(VendingMachine& machine, std::ostream& out);
+
+    /**
+     * @brief Get the id given to the new item, empty if we ran out of ids
+     * @return The new item id
+    */
+    std::string getItemId() const;
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    enum State
+    {
+        ENTER_NAME, ENTER_DESCRIPTION, ENTER_PRICE
+    };
+
+    VendingMachine& machine;
+    State state;
+
+    // the item info entered so far
+    std::string newItemId;
+    std::string name;
+    std::string desc;
+
+    /**
+     * @brief Finish the session and print the trailing new line
+    */
+    void finishAdd();
+};
+
+/**
+ * prompt for an item id if the stock list is not empty then remove that item from the stock list
+ **/
+class RemoveItemSession : public Session
+{
+public:
+    RemoveItemSession(VendingMachine& machine, std::ostream& out);
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    VendingMachine& machine;
+
+    /**
+     * @brief Finish the session and print the trailing new line
+    */
+    void finishRemove();
+};
+
+/**
+ * prompt for the start of an item name then show the items with a name (or a word of it) starting with it,
+ * allowing a few typos if nothing matches exactly
+ **/
+class SearchItemsSession : public Session
+{
+public:
+    SearchItemsSession(VendingMachine& machine, std::ostream& out);
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    VendingMachine& machine;
+};
+
+/**
+ * prompt for a highest price or a price range then show the items in it, cheapest first
+ **/
+class DisplayByPriceSession : public Session
+{
+public:
+    DisplayByPriceSession(VendingMachine& machine, std::ostream& out);
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    VendingMachine& machine;
+};
+
+/**
+ * prompt for words then show the items with all of them in their description,
+ * "or" between words shows the items matching either side
+ **/
+class SearchDescriptionsSession : public Session
+{
+public:
+    SearchDescriptionsSession(VendingMachine& machine, std::ostream& out);
+
+protected:
+    void onStart() override;
+    std::string getPrompt() const override;
+    void onInput(const std::string& s) override;
+    void onTerminate() override;
+
+private:
+    VendingMachine& machine;
+};
+
+#endif // VENDING_SESSIONS_H
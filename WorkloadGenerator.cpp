@@ -0,0 +1,308 @@
+#include "WorkloadGenerator.h"
+#include <chrono>
+#include <cmath>
+
+// the names of the operation types for the report, indexed by OperationType
+static const char* const OP_NAMES[NUM_OP_TYPES] = {
+    "display items", "purchase", "cancel purchase", "add item", "remove item",
+    "display coins", "reset stock", "reset coins"
+};
+
+//====CONFIG AND OPERATION=====
+WorkloadConfig::WorkloadConfig():
+    operations(10000), zipfExponent(1.0), coinWeights{5, 10, 10, 10, 20, 20, 15, 10}, adminRatio(0.01),
+    cancelRate(0.05), browseRatio(0.2), seed(1) {}
+
+MenuOption Operation::getMenuOption() const
+{
+    MenuOption option = MENU_DISPLAY_ITEMS;
+
+    if (type == OP_PURCHASE || type == OP_CANCEL_PURCHASE) {
+        option = MENU_PURCHASE_ITEM;
+    }
+    else if (type == OP_ADD_ITEM) {
+        option = MENU_ADD_ITEM;
+    }
+    else if (type == OP_REMOVE_ITEM) {
+        option = MENU_REMOVE_ITEM;
+    }
+    else if (type == OP_DISPLAY_COINS) {
+        option = MENU_DISPLAY_COINS;
+    }
+    else if (type == OP_RESET_STOCK) {
+        option = MENU_RESET_STOCK;
+    }
+    else if (type == OP_RESET_COINS) {
+        option = MENU_RESET_COINS;
+    }
+
+    return option;
+}
+
+//====WORKLOAD GENERATOR=====
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config):
+    config(config), rng(config.seed), nullOut(nullptr), itemsAdded(0)
+{
+    shadow.setOutput(nullOut);
+    pickDenom = std::discrete_distribution<unsigned int>(config.coinWeights, config.coinWeights + NUM_DENOMS);
+}
+
+void WorkloadGenerator::load(const std::string& stockFile, const std::string& coinFile)
+{
+    shadow.load(stockFile, coinFile);
+
+    //the first item in the file is the most popular, then the second...
+    std::vector<Stock> stockVector = Helper::tryLoadStockFile(stockFile);
+    std::vector<double> weights;
+    products.clear();
+    for (unsigned int i = 0; i < stockVector.size(); ++i)
+    {
+        products.push_back(Product{stockVector[i].getId(), stockVector[i].getPrice().getValue()});
+        weights.push_back(1.0 / std::pow(i + 1, config.zipfExponent));
+    }
+
+    if (products.empty())
+    {
+        throw std::runtime_error("Stock file has no items for the customers to buy");
+    }
+
+    pickProduct = std::discrete_distribution<unsigned int>(weights.begin(), weights.end());
+}
+
+Operation WorkloadGenerator::makePurchase(bool cancel)
+{
+    Operation operation;
+    operation.type = cancel ? OP_CANCEL_PURCHASE : OP_PURCHASE;
+
+    const Product& product = products[pickProduct(rng)];
+    operation.lines.push_back(product.id);
+
+    //hand over notes/coins until it's paid for
+    //a cancelling customer stops before the last one and presses Return instead
+    std::bernoulli_distribution giveUp(0.5);
+    unsigned int paid = 0;
+    bool quit = false;
+    while (!quit)
+    {
+        unsigned int value = Helper::denomToValue(static_cast<Denomination>(pickDenom(rng)));
+        if (cancel && (paid + value >= product.price || giveUp(rng)))
+        {
+            operation.lines.push_back("");
+            quit = true;
+        }
+        else
+        {
+            operation.lines.push_back(std::to_string(value));
+            paid += value;
+            quit = paid >= product.price;
+        }
+    }
+
+    return operation;
+}
+
+Operation WorkloadGenerator::makeAdmin()
+{
+    Operation operation;
+    std::uniform_int_distribution<unsigned int> pickAdmin(0, 4);
+    unsigned int choice = pickAdmin(rng);
+
+    //can't remove anything if we haven't added anything
+    if (choice == 1 && addedIds.empty())
+    {
+        choice = 0;
+    }
+
+    if (choice == 0)
+    {
+        //a new item with a price between $1.00 and $5.00 in multiples of 5 cents
+        std::uniform_int_distribution<unsigned int> pickPrice(20, 100);
+        ++itemsAdded;
+        operation.type = OP_ADD_ITEM;
+        operation.lines.push_back("Load Test Item " + std::to_string(itemsAdded));
+        operation.lines.push_back("Added by the workload generator");
+        operation.lines.push_back(Helper::valueToPrice(pickPrice(rng) * FIVE_CENTS_VAL).getString(false));
+    }
+    else if (choice == 1)
+    {
+        std::uniform_int_distribution<unsigned int> pickAdded(0, addedIds.size() - 1);
+        unsigned int index = pickAdded(rng);
+        operation.type = OP_REMOVE_ITEM;
+        operation.lines.push_back(addedIds[index]);
+        addedIds.erase(addedIds.begin() + index);
+    }
+    else if (choice == 2)
+    {
+        operation.type = OP_DISPLAY_COINS;
+    }
+    else if (choice == 3)
+    {
+        operation.type = OP_RESET_STOCK;
+    }
+    else
+    {
+        operation.type = OP_RESET_COINS;
+    }
+
+    return operation;
+}
+
+Operation WorkloadGenerator::next()
+{
+    std::uniform_real_distribution<double> chance(0, 1);
+    Operation operation;
+
+    if (chance(rng) < config.adminRatio) {
+        operation = makeAdmin();
+    }
+    else if (chance(rng) < config.browseRatio) {
+        operation.type = OP_DISPLAY_ITEMS;
+    }
+    else {
+        operation = makePurchase(chance(rng) < config.cancelRate);
+    }
+
+    //run it on the shadow machine and only keep the lines it actually used
+    if (operation.type == OP_ADD_ITEM)
+    {
+        ScriptInput script(operation.lines);
+        AddItemSession session(shadow, nullOut);
+        session.run(script);
+        if (!session.getItemId().empty())
+        {
+            addedIds.push_back(session.getItemId());
+        }
+        operation.lines.resize(script.getConsumed());
+    }
+    else
+    {
+        operation.lines.resize(execute(shadow, operation, nullOut));
+    }
+
+    return operation;
+}
+
+std::vector<Operation> WorkloadGenerator::generate()
+{
+    std::vector<Operation> operations;
+    operations.reserve(config.operations);
+    for (unsigned int i = 0; i < config.operations; ++i)
+    {
+        operations.push_back(next());
+    }
+    return operations;
+}
+
+void WorkloadGenerator::writeInputFile(const std::string& fileName, const std::vector<Operation>& operations)
+{
+    std::ofstream file;
+    file.open(fileName, std::fstream::out | std::fstream::trunc);
+
+    //each operation is its menu option followed by its lines
+    for (const Operation& operation : operations)
+    {
+        file << operation.getMenuOption() << std::endl;
+        for (const std::string& line : operation.lines)
+        {
+            file << line << std::endl;
+        }
+    }
+    file << MENU_SAVE_AND_EXIT << std::endl;
+
+    file.close();
+}
+
+unsigned int WorkloadGenerator::execute(VendingMachine& machine, const Operation& operation, std::ostream& out)
+{
+    unsigned int consumed = 0;
+    ScriptInput script(operation.lines);
+    machine.setOutput(out);
+
+    if (operation.type == OP_DISPLAY_ITEMS) {
+        machine.displayStock();
+    }
+    else if (operation.type == OP_PURCHASE || operation.type == OP_CANCEL_PURCHASE) {
+        PurchaseSession session(machine, out);
+        session.run(script);
+    }
+    else if (operation.type == OP_ADD_ITEM) {
+        AddItemSession session(machine, out);
+        session.run(script);
+    }
+    else if (operation.type == OP_REMOVE_ITEM) {
+        RemoveItemSession session(machine, out);
+        session.run(script);
+    }
+    else if (operation.type == OP_DISPLAY_COINS) {
+        machine.displayCoins();
+    }
+    else if (operation.type == OP_RESET_STOCK) {
+        machine.resetStock();
+    }
+    else if (operation.type == OP_RESET_COINS) {
+        machine.resetCoin();
+    }
+
+    consumed = script.getConsumed();
+    return consumed;
+}
+
+//====LOAD DRIVER=====
+LoadDriver::LoadDriver(VendingMachine& machine): machine(machine), nullOut(nullptr), operationCount(0), seconds(0) {}
+
+void LoadDriver::run(const std::vector<Operation>& operations)
+{
+    auto runStart = std::chrono::steady_clock::now();
+    for (const Operation& operation : operations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        WorkloadGenerator::execute(machine, operation, nullOut);
+        auto end = std::chrono::steady_clock::now();
+
+        latencies[operation.type].record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    auto runEnd = std::chrono::steady_clock::now();
+
+    operationCount += operations.size();
+    seconds += std::chrono::duration<double>(runEnd - runStart).count();
+}
+
+void LoadDriver::report(std::ostream& os)
+{
+    int nameWidth = 16;
+    int countWidth = 9;
+    int numWidth = 11;
+    char verticalSep = '|';
+
+    os << "Load Test Summary" << std::endl;
+    os << "-----------------" << std::endl;
+    os << "Operations: " << operationCount << std::endl;
+    os << "Elapsed (s): " << seconds << std::endl;
+    os << "Transactions per second: " << (seconds > 0 ? operationCount / seconds : 0) << std::endl;
+    os << std::endl;
+
+    //latencies are printed in microseconds
+    os << std::left << std::setw(nameWidth) << "Operation" << verticalSep << std::right << std::setw(countWidth) << "Count"
+       << verticalSep << std::setw(numWidth) << "Mean us" << verticalSep << std::setw(numWidth) << "p50 us"
+       << verticalSep << std::setw(numWidth) << "p99 us" << verticalSep << std::setw(numWidth) << "p999 us"
+       << verticalSep << std::setw(numWidth) << "Max us" << std::endl;
+    os << std::string(nameWidth + countWidth + 5 * numWidth + 6, '-') << std::endl;
+
+    double micro = 1000;
+    for (unsigned int i = 0; i < NUM_OP_TYPES; ++i)
+    {
+        const LatencyHistogram& samples = latencies[i];
+        if (samples.count() > 0)
+        {
+            os << std::left << std::setw(nameWidth) << OP_NAMES[i] << verticalSep << std::right << std::setw(countWidth) << samples.count()
+               << std::fixed << std::setprecision(2)
+               << verticalSep << std::setw(numWidth) << samples.mean() / micro
+               << verticalSep << std::setw(numWidth) << samples.percentile(50) / micro
+               << verticalSep << std::setw(numWidth) << samples.percentile(99) / micro
+               << verticalSep << std::setw(numWidth) << samples.percentile(99.9) / micro
+               << verticalSep << std::setw(numWidth) << samples.max() / micro << std::endl;
+            os.unsetf(std::ios::fixed);
+        }
+    }
+    os << std::endl;
+}
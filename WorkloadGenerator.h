@@ -0,0 +1,173 @@
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <random>
+#include <string>
+#include <vector>
+#include "VendingMachine.h"
+
+// the kinds of operations a workload is made of
+enum OperationType
+{
+    OP_DISPLAY_ITEMS, OP_PURCHASE, OP_CANCEL_PURCHASE, OP_ADD_ITEM, OP_REMOVE_ITEM,
+    OP_DISPLAY_COINS, OP_RESET_STOCK, OP_RESET_COINS
+};
+
+// the number of operation types
+#define NUM_OP_TYPES 8
+
+/**
+ * settings for generating a workload
+ **/
+struct WorkloadConfig
+{
+    // number of operations to generate
+    unsigned int operations;
+
+    // exponent of the Zipf distribution for item popularity, 0 means every item is as popular
+    double zipfExponent;
+
+    // relative chance of a customer handing over each denomination (indexed by Denomination)
+    double coinWeights[NUM_DENOMS];
+
+    // fraction of operations that are administrator operations
+    double adminRatio;
+
+    // fraction of purchases the customer cancels before paying in full
+    double cancelRate;
+
+    // fraction of customer operations that only display the items
+    double browseRatio;
+
+    unsigned int seed;
+
+    WorkloadConfig();
+};
+
+/**
+ * one operation of a workload: the menu option and the lines typed in after it
+ **/
+struct Operation
+{
+    OperationType type;
+    std::vector<std::string> lines;
+
+    /**
+     * @brief Get the menu option that starts this operation
+     * @return The menu option
+    */
+    MenuOption getMenuOption() const;
+};
+
+/**
+ * generates realistic operations from a stock file and coin file.
+ * every generated operation is run against a shadow machine loaded from the same files,
+ * so the lines always match what ppd will prompt for when the workload is replayed
+ * (e.g. no coins get typed in for an item that has sold out)
+ **/
+class WorkloadGenerator
+{
+public:
+    WorkloadGenerator(const WorkloadConfig& config);
+
+    /**
+     * @brief Load the files the workload starts from
+     * @param stockFile The stock file
+     * @param coinFile The coin file
+     * @throws std::runtime_error
+    */
+    void load(const std::string& stockFile, const std::string& coinFile);
+
+    /**
+     * @brief Generate the next operation and apply it to the shadow machine
+     * @return The operation
+    */
+    Operation next();
+
+    /**
+     * @brief Generate a whole workload
+     * @return The operations in order
+    */
+    std::vector<Operation> generate();
+
+    /**
+     * @brief Write operations as an input file that can be piped into ppd, ending with save and exit
+     * @param fileName The file to write
+     * @param operations The operations to write
+    */
+    static void writeInputFile(const std::string& fileName, const std::vector<Operation>& operations);
+
+    /**
+     * @brief Run an operation against a machine the same way the ppd menu would
+     * @param machine The machine to run against
+     * @param operation The operation to run
+     * @param out Where the machine's messages go
+     * @return The number of lines of the operation that were used
+    */
+    static unsigned int execute(VendingMachine& machine, const Operation& operation, std::ostream& out);
+
+private:
+    // an item customers can pick, in Zipf popularity order
+    struct Product
+    {
+        std::string id;
+        unsigned int price;
+    };
+
+    WorkloadConfig config;
+    std::mt19937 rng;
+    VendingMachine shadow;
+    std::ostream nullOut;
+
+    std::vector<Product> products;
+    std::discrete_distribution<unsigned int> pickProduct;
+    std::discrete_distribution<unsigned int> pickDenom;
+
+    // the items the workload added, so remove item has something to remove
+    std::vector<std::string> addedIds;
+    unsigned int itemsAdded;
+
+    /**
+     * @brief Create the lines for a purchase (or a cancelled purchase)
+     * @param cancel Whether the customer cancels before paying in full
+     * @return The operation
+    */
+    Operation makePurchase(bool cancel);
+
+    /**
+     * @brief Create a random administrator operation
+     * @return The operation
+    */
+    Operation makeAdmin();
+};
+
+/**
+ * replays a workload against a machine and measures the throughput
+ * and the latency of each operation type
+ **/
+class LoadDriver
+{
+public:
+    LoadDriver(VendingMachine& machine);
+
+    /**
+     * @brief Run every operation and time each one
+     * @param operations The workload
+    */
+    void run(const std::vector<Operation>& operations);
+
+    /**
+     * @brief Print the transactions per second and the latency percentiles per operation
+     * @param os Where to print the report
+    */
+    void report(std::ostream& os);
+
+private:
+    VendingMachine& machine;
+    std::ostream nullOut;
+    LatencyHistogram latencies[NUM_OP_TYPES];
+    unsigned long operationCount;
+    double seconds;
+};
+
+#endif // WORKLOAD_GENERATOR_H
@@ -0,0 +1,99 @@
+#include <iostream>
+#include "Helper.h"
+#include "Benchmark.h"
+
+/**
+ * times the stock file, coin file, menu, change and LinkedList operations at catalog sizes
+ * of 10, 1000 and 9999 items (by default) against synthetic data files.
+ * --out writes the results as CSV so runs can be compared between commits.
+ **/
+
+#define BENCH_USAGE "Usage: ./bench [--sizes n,n,...] [--warmup n] [--reps n] [--filter text] [--dir dir] [--out file]"
+
+// parse a whole number for an option
+unsigned int parseCount(const std::string& s, const std::string& option)
+{
+    unsigned int result = 0;
+    try{
+        result = Helper::tryParseInt(s);
+    }
+    catch(const std::runtime_error& e){
+        throw std::runtime_error("Program Exited: " + option + " needs to be a valid integer");
+    }
+    return result;
+}
+
+void start(int argc, char **argv)
+{
+    BenchmarkConfig config;
+    std::string outFileName = "";
+
+    // every option takes a value
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            throw std::runtime_error(BENCH_USAGE);
+        }
+
+        std::string value = argv[++i];
+        if (option == "--sizes") {
+            config.sizes.clear();
+            for (const std::string& size : Helper::splitStringAndTrim(value, DELIM))
+            {
+                unsigned int items = parseCount(size, option);
+                if (items > STOCK_MAX_ID)
+                {
+                    throw std::runtime_error("Program Exited: --sizes can't be more than " + std::to_string(STOCK_MAX_ID));
+                }
+                config.sizes.push_back(items);
+            }
+        }
+        else if (option == "--warmup") {
+            config.warmup = parseCount(value, option);
+        }
+        else if (option == "--reps") {
+            config.reps = parseCount(value, option);
+        }
+        else if (option == "--filter") {
+            config.filter = value;
+        }
+        else if (option == "--dir") {
+            config.dataDir = value;
+        }
+        else if (option == "--out") {
+            outFileName = value;
+        }
+        else {
+            throw std::runtime_error(BENCH_USAGE);
+        }
+    }
+
+    Benchmark benchmark(config);
+    try{
+        benchmark.runAll();
+    }
+    catch(const std::exception& e) {
+        throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
+    }
+    benchmark.report(std::cout);
+
+    if (!outFileName.empty())
+    {
+        benchmark.writeCsv(outFileName);
+        std::cout << "Wrote " << benchmark.getResults().size() << " results to " << outFileName << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try{
+        start(argc, argv);
+    }
+    catch(const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
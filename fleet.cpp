@@ -0,0 +1,75 @@
+#include <iostream>
+#include "Helper.h"
+#include "FleetSimulator.h"
+
+/**
+ * runs a fleet of simulated vending machines under synthetic customer traffic
+ * and reports the throughput, change failure rate and stockout rate.
+ * usage: ./fleet <stock file> <coin file> <machines> <customers per machine> [threads] [restock interval] [data dir]
+ **/
+
+// parse a command line number and say which argument was wrong if it isn't one
+unsigned int parseArg(const std::string& s, const std::string& argName)
+{
+    unsigned int result = 0;
+    try{
+        result = Helper::tryParseInt(s);
+    }
+    catch(const std::runtime_error& e){
+        throw std::runtime_error("Program Exited: " + argName + " needs to be a valid integer");
+    }
+    return result;
+}
+
+void start(int argc, char **argv)
+{
+    int minArgs = 5;
+    int maxArgs = 8;
+
+    // check if we have the correct number of command line arguments
+    if (argc < minArgs || argc > maxArgs)
+    {
+        throw std::runtime_error("Usage: ./fleet <stock file> <coin file> <machines> <customers per machine> [threads] [restock interval] [data dir]");
+    }
+
+    FleetConfig config;
+    config.stockFile = argv[1];
+    config.coinFile = argv[2];
+    config.machines = parseArg(argv[3], "machines");
+    config.customersPerMachine = parseArg(argv[4], "customers per machine");
+    if (argc > 5)
+    {
+        config.threads = parseArg(argv[5], "threads");
+    }
+    if (argc > 6)
+    {
+        config.restockInterval = parseArg(argv[6], "restock interval");
+    }
+    if (argc > 7)
+    {
+        config.dataDir = argv[7];
+    }
+
+    FleetSimulator simulator(config);
+    try{
+        simulator.setup();
+    }
+    catch(const std::exception& e) {
+        throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
+    }
+
+    FleetReport report = simulator.run();
+    std::cout << report;
+}
+
+int main(int argc, char **argv)
+{
+    try{
+        start(argc, argv);
+    }
+    catch(const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include "Helper.h"
+#include "CoinOptimizer.h"
+
+/**
+ * searches for the smallest coin float that keeps the change failure rate under a target
+ * by simulating customers paying for the items in a stock file, and compares it with
+ * the coin file and the float resetCoin gives. --out writes the recommendation as a coin file.
+ **/
+
+#define FLOATOPT_USAGE "Usage: ./floatopt <stock file> <coin file> [--trials n] [--customers n] [--target rate] [--zipf s] " \
+    "[--coins w5,w10,w20,w50,w100,w200,w500,w1000] [--threads n] [--seed n] [--out file]"
+
+// parse a non negative number for an option
+double parseNumber(const std::string& s, const std::string& option)
+{
+    if (!Helper::isNumber(s))
+    {
+        throw std::runtime_error("Program Exited: " + option + " needs to be a non negative number");
+    }
+    return std::stod(s);
+}
+
+void start(int argc, char **argv)
+{
+    int minArgs = 3;
+
+    if (argc < minArgs)
+    {
+        throw std::runtime_error(FLOATOPT_USAGE);
+    }
+
+    std::string stockFileName = argv[1];
+    std::string coinFileName = argv[2];
+    std::string outFileName = "";
+    OptimizerConfig config;
+
+    // every option takes a value
+    for (int i = minArgs; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            throw std::runtime_error(FLOATOPT_USAGE);
+        }
+
+        std::string value = argv[++i];
+        if (option == "--trials") {
+            config.trials = parseNumber(value, option);
+        }
+        else if (option == "--customers") {
+            config.customers = parseNumber(value, option);
+        }
+        else if (option == "--target") {
+            config.target = parseNumber(value, option);
+        }
+        else if (option == "--zipf") {
+            config.zipfExponent = parseNumber(value, option);
+        }
+        else if (option == "--threads") {
+            config.threads = parseNumber(value, option);
+        }
+        else if (option == "--seed") {
+            config.seed = parseNumber(value, option);
+        }
+        else if (option == "--out") {
+            outFileName = value;
+        }
+        else if (option == "--coins") {
+            std::vector<std::string> weights = Helper::splitStringAndTrim(value, DELIM);
+            if (weights.size() != NUM_DENOMS)
+            {
+                throw std::runtime_error("Program Exited: --coins needs a weight for each of the " + std::to_string(NUM_DENOMS) + " denominations");
+            }
+            for (unsigned int j = 0; j < NUM_DENOMS; ++j)
+            {
+                config.coinWeights[j] = parseNumber(weights[j], option);
+            }
+        }
+        else {
+            throw std::runtime_error(FLOATOPT_USAGE);
+        }
+    }
+
+    if (config.trials == 0 || config.customers == 0)
+    {
+        throw std::runtime_error("Program Exited: --trials and --customers need to be at least 1");
+    }
+
+    CoinOptimizer optimizer(config);
+    FloatResult current;
+    try{
+        optimizer.load(stockFileName);
+        for (const Coin& coin : Helper::tryLoadCoinsFile(coinFileName))
+        {
+            current.counts[coin.getDenom()] = coin.getCount();
+        }
+    }
+    catch(const std::exception& e) {
+        throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
+    }
+
+    FloatResult reset;
+    std::fill(reset.counts, reset.counts + NUM_DENOMS, DEFAULT_COIN_COUNT);
+    current = optimizer.evaluate(current.counts);
+    reset = optimizer.evaluate(reset.counts);
+    CoinOptimizer::print(std::cout, "Current Float (" + coinFileName + ")", current);
+    CoinOptimizer::print(std::cout, "Reset Coins Float", reset);
+
+    FloatResult best;
+    try{
+        best = optimizer.optimize();
+    }
+    catch(const std::runtime_error& e) {
+        throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
+    }
+    CoinOptimizer::print(std::cout, "Recommended Float", best);
+    std::cout << "Simulated " << optimizer.getEvaluations() << " floats, " << config.trials << " sequences of "
+              << config.customers << " customers each" << std::endl;
+
+    if (!outFileName.empty())
+    {
+        Helper::saveCoinList(outFileName, CoinOptimizer::toCoinList(best.counts));
+        std::cout << "Wrote the recommended float to " << outFileName << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try{
+        start(argc, argv);
+    }
+    catch(const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
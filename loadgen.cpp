@@ -0,0 +1,135 @@
+#include <iostream>
+#include "Helper.h"
+#include "WorkloadGenerator.h"
+
+/**
+ * generates a synthetic workload from a stock file and coin file, then writes it
+ * as a replayable input file for ppd and/or drives a machine with it directly
+ * and reports the transactions per second and latency percentiles.
+ **/
+
+#define LOADGEN_USAGE "Usage: ./loadgen <stock file> <coin file> [--ops n] [--zipf s] [--admin ratio] [--cancel ratio] " \
+    "[--browse ratio] [--coins w5,w10,w20,w50,w100,w200,w500,w1000] [--seed n] [--out file] [--drive]"
+
+// parse a non negative number for an option
+double parseNumber(const std::string& s, const std::string& option)
+{
+    if (!Helper::isNumber(s))
+    {
+        throw std::runtime_error("Program Exited: " + option + " needs to be a non negative number");
+    }
+    return std::stod(s);
+}
+
+void start(int argc, char **argv)
+{
+    int minArgs = 3;
+
+    if (argc < minArgs)
+    {
+        throw std::runtime_error(LOADGEN_USAGE);
+    }
+
+    std::string stockFileName = argv[1];
+    std::string coinFileName = argv[2];
+    std::string outFileName = "";
+    bool drive = false;
+    WorkloadConfig config;
+
+    // every option except --drive takes a value
+    for (int i = minArgs; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--drive")
+        {
+            drive = true;
+        }
+        else if (i + 1 >= argc)
+        {
+            throw std::runtime_error(LOADGEN_USAGE);
+        }
+        else
+        {
+            std::string value = argv[++i];
+            if (option == "--ops") {
+                config.operations = parseNumber(value, option);
+            }
+            else if (option == "--zipf") {
+                config.zipfExponent = parseNumber(value, option);
+            }
+            else if (option == "--admin") {
+                config.adminRatio = parseNumber(value, option);
+            }
+            else if (option == "--cancel") {
+                config.cancelRate = parseNumber(value, option);
+            }
+            else if (option == "--browse") {
+                config.browseRatio = parseNumber(value, option);
+            }
+            else if (option == "--seed") {
+                config.seed = parseNumber(value, option);
+            }
+            else if (option == "--out") {
+                outFileName = value;
+            }
+            else if (option == "--coins") {
+                std::vector<std::string> weights = Helper::splitStringAndTrim(value, DELIM);
+                if (weights.size() != NUM_DENOMS)
+                {
+                    throw std::runtime_error("Program Exited: --coins needs a weight for each of the " + std::to_string(NUM_DENOMS) + " denominations");
+                }
+                for (unsigned int j = 0; j < NUM_DENOMS; ++j)
+                {
+                    config.coinWeights[j] = parseNumber(weights[j], option);
+                }
+            }
+            else {
+                throw std::runtime_error(LOADGEN_USAGE);
+            }
+        }
+    }
+
+    // with nothing to write we just measure
+    if (outFileName.empty())
+    {
+        drive = true;
+    }
+
+    WorkloadGenerator generator(config);
+    std::vector<Operation> operations;
+    try{
+        generator.load(stockFileName, coinFileName);
+        operations = generator.generate();
+    }
+    catch(const std::exception& e) {
+        throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
+    }
+
+    if (!outFileName.empty())
+    {
+        WorkloadGenerator::writeInputFile(outFileName, operations);
+        std::cout << "Wrote " << operations.size() << " operations to " << outFileName << std::endl;
+    }
+
+    // drive a fresh machine loaded from the same files, the files are not saved
+    if (drive)
+    {
+        VendingMachine machine;
+        machine.load(stockFileName, coinFileName);
+        LoadDriver driver(machine);
+        driver.run(operations);
+        driver.report(std::cout);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try{
+        start(argc, argv);
+    }
+    catch(const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,7 +1,11 @@
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include "LinkedList.h"
 #include "Helper.h"
 #include "VendingMachine.h"
+#include "MetricsExporter.h"
+#include "Console.h"
 
 // -=-=-=-=-=-=- PLEASE READ README FILE FOR TESTING PROCESS -=-=-=-=-=-=-=-
 
@@ -11,22 +15,114 @@
  * Make sure free memory and close all files before exiting the program.
  **/
 
-// all the menu options
-enum MenuOption
+// the options that can come after the stock file and coin file
+struct ProgramOptions
 {
-    MENU_DISPLAY_ITEMS = 1,
-    MENU_PURCHASE_ITEM = 2,
-    MENU_SAVE_AND_EXIT = 3,
-    MENU_ADD_ITEM = 4,
-    MENU_REMOVE_ITEM = 5,
-    MENU_DISPLAY_COINS = 6,
-    MENU_RESET_STOCK = 7,
-    MENU_RESET_COINS = 8,
-    MENU_ABORT_PROGRAM = 9
+    // --metrics turns on the instrumentation, --metrics=<file> also dumps it to the file on exit
+    bool metrics;
+    std::string metricsFile;
+
+    // --prometheus=<file> keeps the file up to date in the Prometheus text format,
+    // every --prometheus-interval=<ms> milliseconds
+    std::string prometheusFile;
+    unsigned int prometheusInterval;
+
+    // --basket adds the Purchase Basket option
+    bool basket;
+
+    // --credit=<file> adds the Purchase With Credit option, the balances are kept in the file
+    std::string creditFile;
+
+    // --analytics counts the sales, kept next to the stock file, and adds the Display Sales option
+    bool analytics;
+
+    // --planner estimates the sales rates, kept next to the stock file,
+    // and adds the Display Restock Plan and Smart Reset Stock options
+    bool planner;
+
+    // --search keeps a name index and a description index and adds the Search Items and Search Descriptions options
+    bool search;
+
+    // --views keeps the items sorted by price and by on hand and adds the Display Items By Price and Display Low Stock options
+    bool views;
+
+    // --columns keeps a columnar copy of the items and adds the Display Inventory Summary option
+    bool columns;
+
+    // --memory adds the Display Memory Usage option
+    bool memory;
+
+    // --lazy leaves the descriptions in the stock file until they are needed
+    bool lazy;
+
+    // --snapshots keeps a copy-on-write copy of the items and adds the Save In Background option
+    bool snapshots;
+
+    // --currency=<set> takes the denominations of a built in set (AUD, USD, EUR or GBP) or a set file instead of AUD
+    std::string currency;
+
+    // --rcu publishes the catalog for other threads, item lookups read it
+    bool rcu;
+
+    // --counters keeps the stock on hand and the coin counts in a file next to the stock file, synced after every change,
+    // --counters-interval=<ms> syncs it at most every <ms> milliseconds instead. Both add the Write Text Files option
+    bool counters;
+    unsigned int countersInterval;
+
+    ProgramOptions(): metrics(false), metricsFile(""), prometheusFile(""), prometheusInterval(EXPORTER_DEFAULT_INTERVAL_MS), basket(false), creditFile(""), analytics(false), planner(false), search(false), views(false), columns(false), memory(false), lazy(false), snapshots(false), currency(""), rcu(false), counters(false), countersInterval(COUNTERS_SYNC_ON_COMMIT) {}
 };
 
+// get the text shown in the menu for the options after MENU_ABORT_PROGRAM
+std::string getExtraOptionLabel(MenuOption option)
+{
+    std::string label = "";
+    if (option == MENU_DISPLAY_METRICS) {
+        label = "Display Metrics";
+    }
+    else if (option == MENU_PURCHASE_BASKET) {
+        label = "Purchase Basket";
+    }
+    else if (option == MENU_PURCHASE_WITH_CREDIT) {
+        label = "Purchase With Credit";
+    }
+    else if (option == MENU_DISPLAY_SALES) {
+        label = "Display Sales";
+    }
+    else if (option == MENU_DISPLAY_RESTOCK_PLAN) {
+        label = "Display Restock Plan";
+    }
+    else if (option == MENU_SMART_RESET_STOCK) {
+        label = "Smart Reset Stock";
+    }
+    else if (option == MENU_SEARCH_ITEMS) {
+        label = "Search Items";
+    }
+    else if (option == MENU_SEARCH_DESCRIPTIONS) {
+        label = "Search Descriptions";
+    }
+    else if (option == MENU_DISPLAY_BY_PRICE) {
+        label = "Display Items By Price";
+    }
+    else if (option == MENU_DISPLAY_LOW_STOCK) {
+        label = "Display Low Stock";
+    }
+    else if (option == MENU_DISPLAY_INVENTORY) {
+        label = "Display Inventory Summary";
+    }
+    else if (option == MENU_DISPLAY_MEMORY) {
+        label = "Display Memory Usage";
+    }
+    else if (option == MENU_SAVE_IN_BACKGROUND) {
+        label = "Save In Background";
+    }
+    else if (option == MENU_WRITE_TEXT_FILES) {
+        label = "Write Text Files";
+    }
+    return label;
+}
+
 // just display all the options
-void displayMainMenu()
+void displayMainMenu(const std::vector<MenuOption>& extraOptions)
 {
     std::cout << "Main Menu:" << std::endl;
     std::cout << "  1.Display Items" << std::endl;
@@ -39,11 +135,17 @@ void displayMainMenu()
     std::cout << "  7.Reset Stock" << std::endl;
     std::cout << "  8.Reset Coins" << std::endl;
     std::cout << "  9.Abort Program" << std::endl;
+    for (unsigned int i = 0; i < extraOptions.size(); ++i)
+    {
+        std::cout << "  " << MENU_ABORT_PROGRAM + 1 + i << "." << getExtraOptionLabel(extraOptions[i]) << std::endl;
+    }
 }
 
-unsigned int getUserChoicePersistent(const std::string& prompt)
+MenuOption getUserChoicePersistent(const std::string& prompt, const std::vector<MenuOption>& extraOptions)
 {
-    return Helper::getUserInputPersistent<unsigned int>(prompt, [](const std::string& s){
+    unsigned int lastOption = MENU_ABORT_PROGRAM + extraOptions.size();
+
+    unsigned int choice = Helper::getUserInputPersistent<unsigned int>(prompt, [lastOption](const std::string& s){
         unsigned int result = MENU_DISPLAY_ITEMS;
 
         // check if the user choice is an integer
@@ -55,13 +157,149 @@ unsigned int getUserChoicePersistent(const std::string& prompt)
         }
 
         //then check if the user choice is in the range of the menu options
-        if (result < MENU_DISPLAY_ITEMS || result > MENU_ABORT_PROGRAM)
+        if (result < MENU_DISPLAY_ITEMS || result > lastOption)
         {
             throw std::runtime_error("menu item selected is not valid");
         }
 
         return result;
     });
+
+    // the numbers after MENU_ABORT_PROGRAM depend on which extra options are shown
+    MenuOption option = static_cast<MenuOption>(choice);
+    if (choice > MENU_ABORT_PROGRAM)
+    {
+        option = extraOptions[choice - MENU_ABORT_PROGRAM - 1];
+    }
+    return option;
+}
+
+// check if an argument is --flag=value and get the value
+bool matchValueOption(const std::string& arg, const std::string& flag, std::string& value)
+{
+    bool matched = arg.compare(0, flag.length() + 1, flag + "=") == 0 && arg.length() > flag.length() + 1;
+    if (matched)
+    {
+        value = arg.substr(flag.length() + 1);
+    }
+    return matched;
+}
+
+// read the milliseconds given to an interval option
+unsigned int parseInterval(const std::string& flag, const std::string& value)
+{
+    unsigned long milliseconds = 0;
+    try
+    {
+        //only digits, std::stoul would also take a sign or spaces and stop at the first letter
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw std::invalid_argument("not digits");
+        }
+        milliseconds = std::stoul(value);
+        if (milliseconds > std::numeric_limits<unsigned int>::max())
+        {
+            throw std::out_of_range("too big");
+        }
+    }
+    catch(const std::logic_error& e)
+    {
+        //std::stoul throws these
+        throw std::runtime_error("Program Exited: " + flag + " needs a whole number of milliseconds");
+    }
+    return static_cast<unsigned int>(milliseconds);
+}
+
+// read the options after the stock file and coin file
+ProgramOptions parseOptions(int argc, char **argv, int firstOption)
+{
+    ProgramOptions options;
+    std::string value = "";
+
+    for (int i = firstOption; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--metrics")
+        {
+            options.metrics = true;
+        }
+        else if (arg == "--basket")
+        {
+            options.basket = true;
+        }
+        else if (arg == "--analytics")
+        {
+            options.analytics = true;
+        }
+        else if (arg == "--planner")
+        {
+            options.planner = true;
+        }
+        else if (arg == "--search")
+        {
+            options.search = true;
+        }
+        else if (arg == "--views")
+        {
+            options.views = true;
+        }
+        else if (arg == "--columns")
+        {
+            options.columns = true;
+        }
+        else if (arg == "--memory")
+        {
+            options.memory = true;
+        }
+        else if (arg == "--lazy")
+        {
+            options.lazy = true;
+        }
+        else if (arg == "--snapshots")
+        {
+            options.snapshots = true;
+        }
+        else if (arg == "--rcu")
+        {
+            options.rcu = true;
+        }
+        else if (arg == "--counters")
+        {
+            options.counters = true;
+        }
+        else if (matchValueOption(arg, "--metrics", value))
+        {
+            options.metrics = true;
+            options.metricsFile = value;
+        }
+        else if (matchValueOption(arg, "--credit", value))
+        {
+            options.creditFile = value;
+        }
+        else if (matchValueOption(arg, "--prometheus", value))
+        {
+            options.prometheusFile = value;
+        }
+        else if (matchValueOption(arg, "--prometheus-interval", value))
+        {
+            options.prometheusInterval = parseInterval("--prometheus-interval", value);
+        }
+        else if (matchValueOption(arg, "--currency", value))
+        {
+            options.currency = value;
+        }
+        else if (matchValueOption(arg, "--counters-interval", value))
+        {
+            options.counters = true;
+            options.countersInterval = parseInterval("--counters-interval", value);
+        }
+        else
+        {
+            throw std::runtime_error("Program Exited: Unknown option " + arg);
+        }
+    }
+
+    return options;
 }
 
 // just have everything in a seperate function
@@ -71,37 +309,160 @@ void start(int argc, char **argv)
 {
     int numArgs = 3;
 
-    // check if we have the correct number of command line arguments
-    if (argc != numArgs)
+    // check if we have the stock file and coin file, the options after them are optional
+    if (argc < numArgs)
+    {
+        throw std::runtime_error("Program Exited: Invalid number of command line arguments, usage: ppd <stock file> <coin file> [--option ...], the options are listed in readme.txt.");
+    }
+
+    // anything after the stock file and coin file turns on an optional feature
+    ProgramOptions options = parseOptions(argc, argv, numArgs);
+    std::vector<MenuOption> extraOptions;
+    if (options.metrics)
+    {
+        Metrics::enable();
+        extraOptions.push_back(MENU_DISPLAY_METRICS);
+    }
+    if (options.basket)
     {
-        throw std::runtime_error("Program Exited: Invalid number of command line arguments, only 3 arguments allowed.");
+        extraOptions.push_back(MENU_PURCHASE_BASKET);
     }
+    if (!options.creditFile.empty())
+    {
+        extraOptions.push_back(MENU_PURCHASE_WITH_CREDIT);
+    }
+    if (options.analytics)
+    {
+        extraOptions.push_back(MENU_DISPLAY_SALES);
+    }
+    if (options.planner)
+    {
+        extraOptions.push_back(MENU_DISPLAY_RESTOCK_PLAN);
+        extraOptions.push_back(MENU_SMART_RESET_STOCK);
+    }
+    if (options.search)
+    {
+        extraOptions.push_back(MENU_SEARCH_ITEMS);
+        extraOptions.push_back(MENU_SEARCH_DESCRIPTIONS);
+    }
+    if (options.views)
+    {
+        extraOptions.push_back(MENU_DISPLAY_BY_PRICE);
+        extraOptions.push_back(MENU_DISPLAY_LOW_STOCK);
+    }
+    if (options.columns)
+    {
+        extraOptions.push_back(MENU_DISPLAY_INVENTORY);
+    }
+    if (options.memory)
+    {
+        extraOptions.push_back(MENU_DISPLAY_MEMORY);
+    }
+    if (options.snapshots)
+    {
+        extraOptions.push_back(MENU_SAVE_IN_BACKGROUND);
+    }
+    if (options.counters)
+    {
+        extraOptions.push_back(MENU_WRITE_TEXT_FILES);
+    }
+    std::string choicePrompt = "Select your option (1-" + std::to_string(MENU_ABORT_PROGRAM + extraOptions.size()) + "): ";
 
     std::string stockFileName = argv[1];
     std::string coinFileName = argv[2];
 
     VendingMachine vendingMachine;
+    CreditTable creditTable;
+    SalesAnalytics analytics;
+    RestockPlanner planner;
+    NameIndex nameIndex;
+    DescriptionIndex descriptionIndex;
+    SortedIndex priceIndex(SORT_BY_PRICE);
+    SortedIndex onHandIndex(SORT_BY_ON_HAND);
+    StockTable stockTable;
+    CounterFile counterFile;
+    CatalogRcu catalogRcu;
+
+    // declared after the machine so it's gone first, it writes any save still waiting before then
+    SnapshotStore snapshotStore;
 
-    // try to load the stock file and coin
+    // try to load the stock file and coin (and the credit file if credit is on)
     try{
+        // the coin file and the prices are checked against the denominations, so they're picked first
+        if (!options.currency.empty())
+        {
+            DenominationSet::setActive(DenominationSet::find(options.currency));
+        }
+        vendingMachine.setLazyDescriptions(options.lazy);
         vendingMachine.load(stockFileName, coinFileName);
+        if (options.counters)
+        {
+            counterFile.open(CounterFile::fileFor(stockFileName), stockFileName, coinFileName, options.countersInterval);
+            vendingMachine.setCounterFile(counterFile);
+        }
+        if (!options.creditFile.empty())
+        {
+            creditTable.load(options.creditFile);
+            vendingMachine.setCreditTable(creditTable);
+        }
+        if (options.analytics)
+        {
+            analytics.load(SalesAnalytics::fileFor(stockFileName));
+            vendingMachine.setAnalytics(analytics);
+        }
+        if (options.planner)
+        {
+            planner.load(RestockPlanner::fileFor(stockFileName));
+            vendingMachine.setPlanner(planner);
+        }
+        if (options.search)
+        {
+            vendingMachine.setNameIndex(nameIndex);
+            vendingMachine.setDescriptionIndex(descriptionIndex);
+        }
+        if (options.views)
+        {
+            vendingMachine.setSortedIndexes(priceIndex, onHandIndex);
+        }
+        if (options.columns)
+        {
+            vendingMachine.setStockTable(stockTable);
+        }
+        if (options.snapshots)
+        {
+            vendingMachine.setSnapshotStore(snapshotStore);
+        }
+        if (options.rcu)
+        {
+            vendingMachine.setCatalogRcu(catalogRcu);
+        }
     }
     catch(const std::exception& e) {
         throw std::runtime_error(ERROR_PREFIX + std::string(e.what()));
     }
 
+    // the exporter needs the timers and counters too, it reads the live state on its own thread
+    LiveState liveState;
+    MetricsExporter exporter(liveState, options.prometheusFile, options.prometheusInterval);
+    if (!options.prometheusFile.empty())
+    {
+        Metrics::enable();
+        vendingMachine.setLiveState(liveState);
+        exporter.start();
+    }
+
     bool exit = false;
 
     // the main loop keeping going if we haven't exited or reach EOF
-    while (!exit && !std::cin.eof())
+    while (!exit && !Console::eof())
     {  
         // display the main menu
-        displayMainMenu();
+        displayMainMenu(extraOptions);
 
         // prompt the user for a menu option
-        unsigned int userChoice = MENU_DISPLAY_ITEMS;
+        MenuOption userChoice = MENU_DISPLAY_ITEMS;
         try {
-            userChoice = getUserChoicePersistent("Select your option (1-9): ");
+            userChoice = getUserChoicePersistent(choicePrompt, extraOptions);
         } catch(const std::runtime_error& e) {
             // the user terminated so we exit
             exit = true;
@@ -119,6 +480,14 @@ void start(int argc, char **argv)
             }
             else if (userChoice == MENU_SAVE_AND_EXIT) {
                 vendingMachine.save(stockFileName, coinFileName);
+                if (options.analytics)
+                {
+                    analytics.save(SalesAnalytics::fileFor(stockFileName));
+                }
+                if (options.planner)
+                {
+                    planner.save(RestockPlanner::fileFor(stockFileName));
+                }
                 exit = true;
             }
             else if (userChoice == MENU_ADD_ITEM) {
@@ -140,19 +509,72 @@ void start(int argc, char **argv)
                 std::cout <<"Program Terminated" << std::endl;
                 exit = true;
             }
+            else if (userChoice == MENU_DISPLAY_METRICS) {
+                Metrics::print(std::cout);
+            }
+            else if (userChoice == MENU_PURCHASE_BASKET) {
+                vendingMachine.purchaseBasket();
+            }
+            else if (userChoice == MENU_PURCHASE_WITH_CREDIT) {
+                vendingMachine.purchaseWithCredit();
+            }
+            else if (userChoice == MENU_DISPLAY_SALES) {
+                vendingMachine.displaySales();
+            }
+            else if (userChoice == MENU_DISPLAY_RESTOCK_PLAN) {
+                vendingMachine.displayRestockPlan();
+            }
+            else if (userChoice == MENU_SMART_RESET_STOCK) {
+                vendingMachine.smartResetStock();
+            }
+            else if (userChoice == MENU_SEARCH_ITEMS) {
+                vendingMachine.searchItems();
+            }
+            else if (userChoice == MENU_SEARCH_DESCRIPTIONS) {
+                vendingMachine.searchDescriptions();
+            }
+            else if (userChoice == MENU_DISPLAY_BY_PRICE) {
+                vendingMachine.displayByPrice();
+            }
+            else if (userChoice == MENU_DISPLAY_LOW_STOCK) {
+                vendingMachine.displayLowStock();
+            }
+            else if (userChoice == MENU_DISPLAY_INVENTORY) {
+                vendingMachine.displayInventory();
+            }
+            else if (userChoice == MENU_DISPLAY_MEMORY) {
+                vendingMachine.displayMemory();
+            }
+            else if (userChoice == MENU_SAVE_IN_BACKGROUND) {
+                vendingMachine.saveInBackground(stockFileName, coinFileName);
+            }
+            else if (userChoice == MENU_WRITE_TEXT_FILES) {
+                vendingMachine.save(stockFileName, coinFileName);
+            }
         }
     }
+
+    // write the final state and dump the metrics however we exited
+    exporter.stop();
+    if (!options.metricsFile.empty())
+    {
+        Metrics::dump(options.metricsFile);
+    }
 }
 
 // main
 int main(int argc, char **argv)
 {
+    // the output only gets written when we wait for input or exit
+    Console::install();
+
     try{
         start(argc, argv);
     }
     catch(const std::runtime_error& e) {
         std::cout << e.what() << std::endl;
     }
-    
+    Console::flush();
+
     return EXIT_SUCCESS;
 }